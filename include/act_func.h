@@ -3,6 +3,8 @@
  ******************************************************************************/
 #pragma once
 
+#include <cstddef>
+
 namespace ml {
 
 /*******************************************************************************
@@ -10,14 +12,54 @@ namespace ml {
  *        layers in neural networks.
  ******************************************************************************/
 enum class ActFunc : unsigned {
-    Relu,  // Rectified Linear Unit (ReLU).
-    Tanh,  // Hyperbolic tangent (tanh).
-    Count, // The number of activation functions available.
+    Relu,      // Rectified Linear Unit (ReLU).
+    Tanh,      // Hyperbolic tangent (tanh).
+    Linear,    // Identity, typically used in output layers for regression.
+    Sigmoid,   // Logistic sigmoid.
+    LeakyRelu, // Leaky Rectified Linear Unit (leaky ReLU).
+    Softmax,   // Softmax over all nodes, for output layers with cross-entropy loss only.
+    Count,     // The number of activation functions available.
+};
+
+/*******************************************************************************
+ * @brief Structure holding the array kernels of an activation function.
+ *
+ *        The kernels are resolved once, e.g. when a layer is created, so hot
+ *        loops calling them neither branch on the activation function nor
+ *        throw. The softmax gradient kernel leaves the errors unchanged, since
+ *        softmax is only trained with the fused cross-entropy gradient.
+ *
+ *        The dense kernel fuses the weighted sums of a dense layer with the
+ *        activation function, each output is written once, already activated.
+ *        The sums are accumulated in input order, so the outputs are identical
+ *        to summing first and passing the sums through the output kernel.
+ ******************************************************************************/
+struct ActFuncKernels {
+    using Output = void (*)(double *numbers, std::size_t count) noexcept;
+    using Gradient = void (*)(const double *outputs, double *errors, std::size_t count) noexcept;
+    using Dense = void (*)(const double *input, const double *weights, const double *bias,
+                           double *output, std::size_t nodeCount,
+                           std::size_t weightCount) noexcept;
+
+    Output output;     // Passes an array of numbers through the function in place.
+    Gradient gradient; // Multiplies an array of errors with the gradient in place.
+    Dense dense;       // Dense layer output, weights row-major, four nodes at a time.
 };
 
+/*******************************************************************************
+ * @brief Provides the array kernels of a given activation function.
+ *
+ * @param actFunc The activation function in question.
+ *
+ * @return The kernels of the activation function.
+ ******************************************************************************/
+ActFuncKernels actFuncKernels(const ActFunc actFunc);
+
 /*******************************************************************************
  * @brief Provides the activation function output for a given input.
  *
+ *        Softmax depends on all nodes of a layer, use the array overload.
+ *
  * @param actFunc The activation function to use for the calculation.
  * @param number  The number for which to calculate the activation function
  *                output.
@@ -27,15 +69,46 @@ enum class ActFunc : unsigned {
 double actFuncOutput(const ActFunc actFunc, const double number);
 
 /*******************************************************************************
- * @brief Provides the activation function gradient for a given input.
+ * @brief Passes an array of numbers through an activation function in place.
+ *
+ *        The activation function is selected once for the whole array, so the
+ *        loop over the numbers can be vectorized.
+ *
+ * @param actFunc The activation function to use for the calculation.
+ * @param numbers Pointer to array holding the numbers to update.
+ * @param count   The number of numbers in the array.
+ ******************************************************************************/
+void actFuncOutput(const ActFunc actFunc, double *numbers, const std::size_t count);
+
+/*******************************************************************************
+ * @brief Provides the activation function gradient for a given activation
+ *        function output.
+ *
+ *        Softmax has no element-wise gradient, it is only used together with
+ *        cross-entropy loss, whose gradient is fused with the activation.
  *
  * @param actFunc The activation function to use for the calculation.
- * @param number The number for which to calculate the activation
- *               function gradient.
+ * @param output  The activation function output for which to calculate the
+ *                gradient.
  *
  * @return The activation function gradient as a double.
  ******************************************************************************/
-double actFuncGradient(const ActFunc actFunc, const double number);
+double actFuncGradient(const ActFunc actFunc, const double output);
+
+/*******************************************************************************
+ * @brief Multiplies an array of errors with the activation function gradient
+ *        of the corresponding outputs in place.
+ *
+ *        The activation function is selected once for the whole array, so the
+ *        loop over the errors can be vectorized.
+ *
+ * @param actFunc The activation function to use for the calculation.
+ * @param outputs Pointer to array holding the activation function outputs.
+ * @param errors  Pointer to array holding the errors to update.
+ * @param count   The number of errors in the array.
+ ******************************************************************************/
+void actFuncGradient(const ActFunc actFunc, const double *outputs, double *errors,
+                     const std::size_t count);
 
 /*******************************************************************************
  * @brief Provides the name of a given activation function.
@@ -0,0 +1,127 @@
+/*******************************************************************************
+ * @brief Aligned memory block holding the values of a whole network.
+ ******************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace ml {
+
+/*******************************************************************************
+ * @brief Class implementation of an arena.
+ *
+ *        An arena is one zero-initialized, cache line aligned block of doubles,
+ *        allocated once with a size planned up front. Users carve it into
+ *        segments by offset; rounding each segment with alignedCount keeps
+ *        every segment on its own cache lines. Copying an arena copies the
+ *        whole block at once, which makes snapshots trivial.
+ ******************************************************************************/
+class Arena {
+  public:
+    /*******************************************************************************
+     * @brief The alignment of the block in bytes, one cache line on common cores.
+     ******************************************************************************/
+    static constexpr std::size_t Alignment{64U};
+
+    /*******************************************************************************
+     * @brief Creates new arena.
+     *
+     * @param size The number of doubles to allocate (default = none).
+     ******************************************************************************/
+    explicit Arena(const std::size_t size = 0U);
+
+    /*******************************************************************************
+     * @brief Creates new arena holding a copy of another arena.
+     *
+     * @param other Reference to the arena to copy.
+     ******************************************************************************/
+    Arena(const Arena &other);
+
+    /*******************************************************************************
+     * @brief Creates new arena taking over the block of another arena.
+     *
+     * @param other Reference to the arena to move, left empty.
+     ******************************************************************************/
+    Arena(Arena &&other) noexcept;
+
+    /*******************************************************************************
+     * @brief Deletes the arena.
+     ******************************************************************************/
+    ~Arena() = default;
+
+    /*******************************************************************************
+     * @brief Copies the values of another arena of the same size.
+     *
+     * @param other Reference to the arena to copy.
+     *
+     * @return Reference to this arena.
+     ******************************************************************************/
+    Arena &operator=(const Arena &other);
+
+    /*******************************************************************************
+     * @brief Takes over the block of another arena.
+     *
+     * @param other Reference to the arena to move, left empty.
+     *
+     * @return Reference to this arena.
+     ******************************************************************************/
+    Arena &operator=(Arena &&other) noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the block of the arena.
+     *
+     * @return Pointer to the first value, nullptr if the arena is empty.
+     ******************************************************************************/
+    double *data() noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the block of the arena.
+     *
+     * @return Pointer to the first value, nullptr if the arena is empty.
+     ******************************************************************************/
+    const double *data() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the number of values in the arena.
+     *
+     * @return The number of doubles.
+     ******************************************************************************/
+    std::size_t size() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the memory used by the arena.
+     *
+     * @return The number of bytes allocated.
+     ******************************************************************************/
+    std::size_t byteCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Rounds a number of doubles up to whole cache lines, so that a segment
+     *        following it starts aligned.
+     *
+     * @param count The number of doubles.
+     *
+     * @return The rounded number of doubles.
+     ******************************************************************************/
+    static constexpr std::size_t alignedCount(const std::size_t count) noexcept {
+        constexpr auto lineCount{Alignment / sizeof(double)};
+        return (count + lineCount - 1U) / lineCount * lineCount;
+    }
+
+  private:
+    /*******************************************************************************
+     * @brief Structure releasing blocks with the alignment they were allocated with.
+     ******************************************************************************/
+    struct Deleter {
+        void operator()(double *data) const noexcept {
+            ::operator delete[](data, std::align_val_t{Alignment});
+        }
+    };
+
+    std::unique_ptr<double[], Deleter> myData; // The aligned block.
+    std::size_t mySize;                        // The number of doubles in the block.
+};
+
+} // namespace ml
\ No newline at end of file
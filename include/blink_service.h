@@ -0,0 +1,109 @@
+/********************************************************************************
+ * @brief Timer-driven blink and software PWM service for LEDs.
+ ********************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "led.h"
+
+namespace rpi {
+
+/********************************************************************************
+ * @brief Implementation of a blink and software PWM service.
+ *
+ *        Any number of LEDs are driven from one background thread, which
+ *        sleeps on a timerfd armed for the next toggle and an eventfd used
+ *        to wake it when patterns change (both monitored via epoll). Setting
+ *        a pattern never waits for the LED, so the caller is never blocked.
+ *
+ *        An LED must not be written by others while it has a pattern set.
+ *
+ *        This class is non-copyable and non-movable.
+ ********************************************************************************/
+class BlinkService {
+  public:
+    /********************************************************************************
+     * @brief Creates new blink service and starts its thread.
+     ********************************************************************************/
+    BlinkService();
+
+    /********************************************************************************
+     * @brief Deletes blink service, stops its thread and leaves all LEDs off.
+     ********************************************************************************/
+    ~BlinkService() noexcept;
+
+    /********************************************************************************
+     * @brief Sets the blink pattern of an LED, replacing any previous pattern.
+     *
+     * @param led       Reference to the LED, which must outlive its pattern.
+     * @param periodMs  The period of the pattern measured in milliseconds.
+     * @param dutyCycle The part of each period the LED is on, 0.0 - 1.0
+     *                  (default = 0.5).
+     ********************************************************************************/
+    void setPattern(Led &led, const std::uint32_t periodMs, const double dutyCycle = 0.5);
+
+    /********************************************************************************
+     * @brief Removes the blink pattern of an LED.
+     *
+     * @param led   Reference to the LED.
+     * @param value The value to leave the LED at (default = off).
+     ********************************************************************************/
+    void clearPattern(Led &led, const bool value = false);
+
+    /********************************************************************************
+     * @brief Provides the number of LEDs with a pattern set.
+     *
+     * @return The number of driven LEDs.
+     ********************************************************************************/
+    std::size_t ledCount() const;
+
+    BlinkService(const BlinkService &) = delete;            // No copy constructor.
+    BlinkService(BlinkService &&) = delete;                 // No move constructor.
+    BlinkService &operator=(const BlinkService &) = delete; // No copy assignment.
+    BlinkService &operator=(BlinkService &&) = delete;      // No move assignment.
+
+  private:
+    /********************************************************************************
+     * @brief Structure holding the pattern of a driven LED.
+     ********************************************************************************/
+    struct Channel {
+        Led *led;             // Pointer to the driven LED.
+        std::uint64_t onNs;   // Time the LED is on each period.
+        std::uint64_t offNs;  // Time the LED is off each period.
+        std::uint64_t nextNs; // Monotonic time of the next toggle.
+    };
+
+    /********************************************************************************
+     * @brief Toggles the LEDs that are due and provides the next toggle time.
+     *
+     * @param nowNs The current monotonic time in nanoseconds.
+     *
+     * @return Monotonic time of the next toggle, 0 if no LED needs toggling.
+     ********************************************************************************/
+    std::uint64_t update(const std::uint64_t nowNs);
+
+    /********************************************************************************
+     * @brief Wakes the service thread.
+     ********************************************************************************/
+    void wake() noexcept;
+
+    /********************************************************************************
+     * @brief Runs the service thread until the service is deleted.
+     ********************************************************************************/
+    void run();
+
+    mutable std::mutex myMutex;      // Mutex protecting the channels.
+    std::vector<Channel> myChannels; // Patterns of the driven LEDs.
+    int myEpollFd;                   // File descriptor of the epoll instance.
+    int myTimerFd;                   // File descriptor of the toggle timer.
+    int myEventFd;                   // File descriptor for waking the thread.
+    std::atomic<bool> myStop;        // Indicates if the thread shall stop.
+    std::thread myThread;            // The service thread.
+};
+
+} // namespace rpi
\ No newline at end of file
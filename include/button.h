@@ -5,7 +5,7 @@
 
 #include <cstdint>
 
-struct gpiod_line;
+#include "gpio_backend.h"
 
 namespace rpi {
 
@@ -30,8 +30,11 @@ class Button {
      *
      * @param pin        Raspberry Pi GPIO pin the button is connected to.
      * @param activeHigh Indicates the active high value (default = high).
+     * @param backend    Reference to the GPIO backend to use (default = the
+     *                   default backend).
      ********************************************************************************/
-    Button(const std::uint8_t pin, const bool activeHigh = true) noexcept;
+    Button(const std::uint8_t pin, const bool activeHigh = true,
+           gpio::Backend &backend = gpio::defaultBackend()) noexcept;
 
     /********************************************************************************
      * @brief Deletes button and releases allocated hardware.
@@ -68,9 +71,10 @@ class Button {
     Button &operator=(Button &&) = delete;      // No move assignment.
 
   private:
-    struct gpiod_line *myLine; // Pointer to GPIO line.
-    const bool myActiveHigh;   // Active high value.
-    bool myLastInput;          // Previous input value.
+    gpio::Backend &myBackend; // Reference to the GPIO backend.
+    const std::uint8_t myPin; // GPIO pin the button is connected to.
+    const bool myActiveHigh;  // Active high value.
+    bool myLastInput;         // Previous input value.
 };
 
 } // namespace rpi
\ No newline at end of file
@@ -0,0 +1,148 @@
+/*******************************************************************************
+ * @brief Background writer of training checkpoints.
+ ******************************************************************************/
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ml {
+
+/*******************************************************************************
+ * @brief Class implementation of a checkpoint writer.
+ *
+ *        The training thread serializes a checkpoint into the staging buffer
+ *        and submits it, which only swaps buffers under a mutex. A background
+ *        thread writes the submitted checkpoint to a temporary file, syncs it
+ *        and renames it over the checkpoint file, so the file always holds a
+ *        complete checkpoint, even after a power loss. If a checkpoint is submitted before the previous one was
+ *        written, the previous one is dropped, so training never waits for
+ *        the disk. The buffers keep their capacity, so checkpoints of the same
+ *        network don't allocate after the first one.
+ *
+ *        This class is non-copyable and non-movable.
+ ******************************************************************************/
+class CheckpointWriter {
+  public:
+    /*******************************************************************************
+     * @brief Creates new checkpoint writer and starts its I/O thread.
+     *
+     * @param path          Path to the checkpoint file.
+     * @param epochInterval The number of epochs between checkpoints, 0 = none.
+     * @param timeInterval  The time between checkpoints, 0 = none (default).
+     ******************************************************************************/
+    CheckpointWriter(const std::string &path, const std::size_t epochInterval,
+                     const std::chrono::milliseconds timeInterval = std::chrono::milliseconds{0});
+
+    /*******************************************************************************
+     * @brief Deletes the writer after writing the last submitted checkpoint.
+     ******************************************************************************/
+    ~CheckpointWriter() noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the path to the checkpoint file.
+     *
+     * @return Reference to the path.
+     ******************************************************************************/
+    const std::string &path() const noexcept;
+
+    /*******************************************************************************
+     * @brief Indicates if a checkpoint is due, i.e. if the epoch or time interval
+     *        has passed since the last submitted checkpoint.
+     *
+     * @param epoch The number of epochs trained so far.
+     *
+     * @return True if a checkpoint is due, else false.
+     ******************************************************************************/
+    bool isDue(const std::size_t epoch) const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the epoch of the last submitted checkpoint.
+     *
+     * @return The number of epochs trained when the last checkpoint was taken,
+     *         0 if none was submitted.
+     ******************************************************************************/
+    std::size_t lastEpoch() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the staging buffer to serialize the next checkpoint into.
+     *
+     * @return Reference to the staging buffer, only to be used by the thread
+     *         submitting checkpoints.
+     ******************************************************************************/
+    std::vector<std::uint8_t> &stagingBuffer() noexcept;
+
+    /*******************************************************************************
+     * @brief Submits the checkpoint in the staging buffer for writing.
+     *
+     * @param epoch The number of epochs trained when the checkpoint was taken.
+     ******************************************************************************/
+    void submit(const std::size_t epoch);
+
+    /*******************************************************************************
+     * @brief Waits until the submitted checkpoint has been written.
+     ******************************************************************************/
+    void flush();
+
+    /*******************************************************************************
+     * @brief Provides the number of checkpoints written.
+     *
+     * @return The number of checkpoints written.
+     ******************************************************************************/
+    std::size_t writtenCount() const;
+
+    /*******************************************************************************
+     * @brief Provides the number of checkpoints dropped or failed to write.
+     *
+     * @return The number of checkpoints lost.
+     ******************************************************************************/
+    std::size_t lostCount() const;
+
+    CheckpointWriter() = delete;                                    // No default constructor.
+    CheckpointWriter(const CheckpointWriter &) = delete;            // No copy constructor.
+    CheckpointWriter(CheckpointWriter &&) = delete;                 // No move constructor.
+    CheckpointWriter &operator=(const CheckpointWriter &) = delete; // No copy assignment.
+    CheckpointWriter &operator=(CheckpointWriter &&) = delete;      // No move assignment.
+
+  private:
+    /*******************************************************************************
+     * @brief Runs the I/O thread until the writer is deleted.
+     ******************************************************************************/
+    void run();
+
+    /*******************************************************************************
+     * @brief Writes a checkpoint to a temporary file, syncs it to disk and
+     *        renames it over the checkpoint file.
+     *
+     * @param buffer Reference to the serialized checkpoint.
+     *
+     * @return True if the checkpoint was written, else false.
+     ******************************************************************************/
+    bool write(const std::vector<std::uint8_t> &buffer) const;
+
+    using Clock = std::chrono::steady_clock;
+
+    const std::string myPath;                   // Path to the checkpoint file.
+    const std::size_t myEpochInterval;          // Epochs between checkpoints.
+    const std::chrono::milliseconds myInterval; // Time between checkpoints.
+    std::size_t myLastEpoch;                    // Epoch of the last submitted checkpoint.
+    Clock::time_point myLastTime;               // Time of the last submitted checkpoint.
+    std::vector<std::uint8_t> myStaging;        // Buffer filled by the training thread.
+    std::vector<std::uint8_t> myPending;        // Submitted buffer waiting to be written.
+    std::vector<std::uint8_t> myWriting;        // Buffer written by the I/O thread.
+    bool myHasPending;                          // Indicates if a checkpoint is pending.
+    bool myIsWriting;                           // Indicates if a checkpoint is being written.
+    bool myStop;                                // Indicates if the I/O thread shall stop.
+    std::size_t myWrittenCount;                 // The number of checkpoints written.
+    std::size_t myLostCount;                    // The number of checkpoints lost.
+    mutable std::mutex myMutex;                 // Mutex protecting the shared state.
+    std::condition_variable myCondition;        // Signals submitted and written checkpoints.
+    std::thread myThread;                       // Background I/O thread.
+};
+
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,161 @@
+/*******************************************************************************
+ * @brief Compressed sparse row (CSR) matrix for sparse layer kernels.
+ ******************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace ml {
+
+/*******************************************************************************
+ * @brief Class implementation of a compressed sparse row matrix.
+ *
+ *        Only non-zero entries are stored, so the cost of the kernels
+ *        scales with the number of non-zeros rather than the dense shape.
+ ******************************************************************************/
+class CsrMatrix {
+  public:
+    /*******************************************************************************
+     * @brief Creates new empty matrix.
+     ******************************************************************************/
+    CsrMatrix() = default;
+
+    /*******************************************************************************
+     * @brief Creates new matrix holding the non-zero entries of a dense matrix.
+     *
+     * @param dense       Pointer to array holding the dense matrix, row-major.
+     * @param rowCount    The number of rows.
+     * @param columnCount The number of columns.
+     ******************************************************************************/
+    CsrMatrix(const double *dense, const std::size_t rowCount, const std::size_t columnCount);
+
+    /*******************************************************************************
+     * @brief Creates new matrix from its CSR arrays, e.g. read from a checkpoint.
+     *
+     * @param columnCount The number of columns.
+     * @param rowStart    Index of the first entry of each row, followed by the
+     *                    number of entries.
+     * @param columns     Column of each entry.
+     * @param values      Value of each entry.
+     ******************************************************************************/
+    CsrMatrix(const std::size_t columnCount, std::vector<std::uint32_t> rowStart,
+              std::vector<std::uint32_t> columns, std::vector<double> values);
+
+    /*******************************************************************************
+     * @brief Deletes the matrix.
+     ******************************************************************************/
+    ~CsrMatrix() = default;
+
+    /*******************************************************************************
+     * @brief Provides the number of rows of the matrix.
+     *
+     * @return The number of rows.
+     ******************************************************************************/
+    std::size_t rowCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the number of columns of the matrix.
+     *
+     * @return The number of columns.
+     ******************************************************************************/
+    std::size_t columnCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the number of stored (non-zero) entries.
+     *
+     * @return The number of non-zeros.
+     ******************************************************************************/
+    std::size_t nonZeroCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the memory used by the stored entries and indexes.
+     *
+     * @return The number of bytes used.
+     ******************************************************************************/
+    std::size_t byteCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the index of the first entry of each row, followed by
+     *        the total number of entries.
+     *
+     * @return Reference to vector holding the row start indexes.
+     ******************************************************************************/
+    const std::vector<std::uint32_t> &rowStart() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the column of each stored entry.
+     *
+     * @return Reference to vector holding the column indexes.
+     ******************************************************************************/
+    const std::vector<std::uint32_t> &columns() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the value of each stored entry.
+     *
+     * @return Reference to vector holding the values.
+     ******************************************************************************/
+    const std::vector<double> &values() const noexcept;
+
+    /*******************************************************************************
+     * @brief Performs sparse matrix-vector multiplication, output += A * input.
+     *
+     * @param input  Pointer to array holding columnCount input values.
+     * @param output Pointer to array holding rowCount output values.
+     ******************************************************************************/
+    void multiplyAdd(const double *input, double *output) const noexcept;
+
+    /*******************************************************************************
+     * @brief Performs transposed sparse matrix-vector multiplication,
+     *        output += A^T * input.
+     *
+     *        The entries are visited row by row in storage order, so no
+     *        transposed copy of the matrix is needed.
+     *
+     * @param input  Pointer to array holding rowCount input values.
+     * @param output Pointer to array holding columnCount output values.
+     ******************************************************************************/
+    void multiplyTransposeAdd(const double *input, double *output) const noexcept;
+
+    /*******************************************************************************
+     * @brief Adds scaled outer product to the stored entries only,
+     *        A[i][j] += rowScale[i] * factor * input[j] for each non-zero (i, j).
+     *
+     * @param rowScale Pointer to array holding rowCount scale factors.
+     * @param factor   Factor applied to every row.
+     * @param input    Pointer to array holding columnCount input values.
+     ******************************************************************************/
+    void addOuterProduct(const double *rowScale, const double factor,
+                         const double *input) noexcept;
+
+    /*******************************************************************************
+     * @brief Writes the stored entries into a dense matrix of the same shape.
+     *
+     * @param dense Pointer to array holding the dense matrix to update, row-major.
+     ******************************************************************************/
+    void scatter(double *dense) const noexcept;
+
+    /*******************************************************************************
+     * @brief Reads the stored entries from a dense matrix of the same shape,
+     *        keeping the non-zero pattern.
+     *
+     * @param dense Pointer to array holding the dense matrix, row-major.
+     ******************************************************************************/
+    void gather(const double *dense) noexcept;
+
+    /*******************************************************************************
+     * @brief Adds the entries of a dense matrix of the same shape to the stored
+     *        entries only, pruned entries stay zero.
+     *
+     * @param dense Pointer to array holding the dense matrix, row-major.
+     ******************************************************************************/
+    void addMasked(const double *dense) noexcept;
+
+  private:
+    std::vector<std::uint32_t> myRowStart; // Index of the first entry of each row.
+    std::vector<std::uint32_t> myColumns;  // Column of each entry.
+    std::vector<double> myValues;          // Value of each entry.
+    std::size_t myColumnCount{};           // The number of columns.
+};
+
+} // namespace ml
\ No newline at end of file
@@ -3,29 +3,79 @@
  ******************************************************************************/
 #pragma once
 
+#include <array>
 #include <iostream>
 #include <vector>
 
 #include "act_func.h"
+#include "csr_matrix.h"
+#include "kernel_profiler.h"
+#include "loss.h"
 
 namespace ml {
 
+/*******************************************************************************
+ * @brief Enum representing the implementations of the layer kernels.
+ ******************************************************************************/
+enum class KernelVariant : unsigned {
+    Scalar,  // One node (row of weights) at a time.
+    Blocked, // Four nodes at a time, sharing each load of the input or error.
+    Sparse,  // Non-zero weights only (CSR), pruned layers only.
+    Count,   // The number of variants available.
+};
+
 /*******************************************************************************
  * @brief Class implementation of a dense layer.
  *
- *        This class is non-copyable and non-movable.
+ *        The layer doesn't own its values: bias and weights live in a block of
+ *        parameters and output and error in a block of activations, both
+ *        provided by the owner of the layer (see ml::NeuralNetwork and
+ *        ml::Arena), which must keep them alive as long as the layer. The
+ *        weights are stored row-major, one row of weightCount values per node.
+ *
+ *        The kernels don't check their arguments, so they can be inlined into
+ *        the training loop; the owner validates shapes, loss function and
+ *        learning rate once up front (see ml::NeuralNetwork).
+ *
+ *        Each kernel has several implementations giving identical results,
+ *        selected per layer with setKernel (see ml::KernelTuner). Pruned
+ *        layers start out with the sparse kernels.
  ******************************************************************************/
 class DenseLayer {
   public:
     /*******************************************************************************
-     * @brief Creates new dense layer.
+     * @brief Provides the number of parameter values used by a layer.
+     *
+     * @param nodeCount   The number of nodes of the layer.
+     * @param weightCount The number of weights per node of the layer.
+     *
+     * @return The number of doubles, rounded up to whole cache lines.
+     ******************************************************************************/
+    static std::size_t parameterCount(const std::size_t nodeCount,
+                                      const std::size_t weightCount) noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the number of activation values used by a layer.
+     *
+     * @param nodeCount The number of nodes of the layer.
+     *
+     * @return The number of doubles, rounded up to whole cache lines.
+     ******************************************************************************/
+    static std::size_t activationCount(const std::size_t nodeCount) noexcept;
+
+    /*******************************************************************************
+     * @brief Creates new dense layer with random parameters.
      *
      * @param nodeCount   The number of nodes of the new layer.
      * @param weightCount The number of weights per node of the new layer.
-     * @param actFunc     The activation function of the layer (default = ReLU).
+     * @param actFunc     The activation function of the layer.
+     * @param parameters  Pointer to parameterCount cache line aligned doubles
+     *                    holding the bias and weights.
+     * @param activations Pointer to activationCount cache line aligned doubles
+     *                    holding the output and error.
      ******************************************************************************/
     DenseLayer(const std::size_t nodeCount, const std::size_t weightCount,
-               const ActFunc actFunc = ActFunc::Relu);
+               const ActFunc actFunc, double *parameters, double *activations);
 
     /*******************************************************************************
      * @brief Deletes the dense layer.
@@ -35,31 +85,38 @@ class DenseLayer {
     /*******************************************************************************
      * @brief Provides the output of the dense layer.
      *
-     * @return Reference to vector holding the output of the dense layer.
+     * @return Pointer to array holding the output of each node.
      ******************************************************************************/
-    const std::vector<double> &output() const;
+    const double *output() const;
 
     /*******************************************************************************
      * @brief Provides the error of the dense layer.
      *
-     * @return Reference to vector holding the error of the dense layer.
+     * @return Pointer to array holding the error of each node.
      ******************************************************************************/
-    const std::vector<double> &error() const;
+    const double *error() const;
 
     /*******************************************************************************
      * @brief Provides the bias of the dense layer.
      *
-     * @return Reference to vector holding the bias of the dense layer.
+     * @return Pointer to array holding the bias of each node.
      ******************************************************************************/
-    const std::vector<double> &bias() const;
+    const double *bias() const;
 
     /*******************************************************************************
      * @brief Provides the weights of the dense layer.
      *
-     * @return Reference to two-dimensional vector holding the weights of
-     *         the dense layer.
+     * @return Pointer to array holding the weights of each node, row-major. Pruned
+     *         weights are zero.
+     ******************************************************************************/
+    const double *weights() const;
+
+    /*******************************************************************************
+     * @brief Provides the non-zero weights of a pruned dense layer.
+     *
+     * @return Reference to the sparse weights, empty if the layer isn't pruned.
      ******************************************************************************/
-    const std::vector<std::vector<double>> &weights() const;
+    const CsrMatrix &sparseWeights() const;
 
     /*******************************************************************************
      * @brief Provides the activation function of the dense layer.
@@ -82,38 +139,204 @@ class DenseLayer {
      ******************************************************************************/
     std::size_t weightCount() const;
 
+    /*******************************************************************************
+     * @brief Indicates if the layer uses sparse (CSR) weights.
+     *
+     * @return True if the layer has been pruned, else false.
+     ******************************************************************************/
+    bool isSparse() const;
+
+    /*******************************************************************************
+     * @brief Indicates if a kernel can use an implementation. The sparse kernels
+     *        need a pruned layer, and pruned layers always optimize sparse so that
+     *        pruned weights stay zero.
+     *
+     * @param phase   The kernel in question.
+     * @param variant The implementation in question.
+     *
+     * @return True if the implementation can be used, else false.
+     ******************************************************************************/
+    bool supportsKernel(const KernelPhase phase, const KernelVariant variant) const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the implementation used by a kernel.
+     *
+     * @param phase The kernel in question.
+     *
+     * @return The implementation as an enumerator of enum KernelVariant.
+     ******************************************************************************/
+    KernelVariant kernel(const KernelPhase phase) const noexcept;
+
+    /*******************************************************************************
+     * @brief Selects the implementation of a kernel. The backpropagate kernel is
+     *        propagateError, which reads the weights of this layer.
+     *
+     * @param phase   The kernel to select the implementation of.
+     * @param variant The implementation to use, see supportsKernel.
+     ******************************************************************************/
+    void setKernel(const KernelPhase phase, const KernelVariant variant);
+
+    /*******************************************************************************
+     * @brief Provides the number of non-zero weights of the dense layer.
+     *
+     * @return The number of non-zero weights.
+     ******************************************************************************/
+    std::size_t nonZeroCount() const;
+
+    /*******************************************************************************
+     * @brief Provides the memory used by the parameters of the layer in its
+     *        current representation (dense or CSR).
+     *
+     * @return The number of bytes used by biases and weights.
+     ******************************************************************************/
+    std::size_t parameterBytes() const;
+
+    /*******************************************************************************
+     * @brief Prunes weights below a magnitude threshold and switches the layer
+     *        to sparse (CSR) kernels.
+     *
+     *        Pruned weights stay zero during later training, only the
+     *        remaining weights are optimized.
+     *
+     * @param threshold Weights with a magnitude below this value are removed.
+     *
+     * @return The number of weights removed by this call.
+     ******************************************************************************/
+    std::size_t prune(const double threshold);
+
+    /*******************************************************************************
+     * @brief Replaces the parameters of the layer with dense weights, e.g. when
+     *        resuming from a checkpoint.
+     *
+     * @param bias    Reference to vector holding the bias of each node.
+     * @param weights Reference to vector holding the weights of each node, row-major.
+     ******************************************************************************/
+    void setParameters(const std::vector<double> &bias, const std::vector<double> &weights);
+
+    /*******************************************************************************
+     * @brief Replaces the parameters of the layer with pruned weights, keeping
+     *        exactly the given non-zero pattern.
+     *
+     * @param bias          Reference to vector holding the bias of each node.
+     * @param sparseWeights Reference to the remaining weights in CSR format.
+     ******************************************************************************/
+    void setParameters(const std::vector<double> &bias, const CsrMatrix &sparseWeights);
+
+    /*******************************************************************************
+     * @brief Points the layer at new blocks holding the same values, e.g. after
+     *        the owner of the layer copied them.
+     *
+     * @param parameters  Pointer to the new bias and weights of the layer.
+     * @param activations Pointer to the new output and error of the layer.
+     ******************************************************************************/
+    void place(double *parameters, double *activations) noexcept;
+
+    /*******************************************************************************
+     * @brief Points the layer at another block for its output and error, e.g. to
+     *        keep the activations of several samples in flight.
+     *
+     * @param activations Pointer to activationCount doubles for the output and error.
+     ******************************************************************************/
+    void placeActivations(double *activations) noexcept;
+
+    /*******************************************************************************
+     * @brief Reloads the non-zero weights of a pruned layer from its dense
+     *        weights, after the parameter block was overwritten as a whole.
+     ******************************************************************************/
+    void reloadSparseWeights() noexcept;
+
     /*******************************************************************************
      * @brief Performs feedforward for dense layer.
      *
-     * @param input Reference to vector holding the input of the dense layer.
+     * @param input Pointer to array holding the weightCount inputs of the layer.
      ******************************************************************************/
-    void feedforward(const std::vector<double> &input);
+    void feedforward(const double *input) noexcept;
+
+    /*******************************************************************************
+     * @brief Performs feedforward for a batch of inputs, reading the weights of
+     *        each node once per batch. The outputs and errors of the layer are
+     *        left untouched.
+     *
+     * @param input       Pointer to array holding the weightCount inputs of each
+     *                    set, one set after another.
+     * @param output      Pointer to array receiving the nodeCount outputs of each
+     *                    set, one set after another.
+     * @param sampleCount The number of sets in the batch.
+     ******************************************************************************/
+    void feedforward(const double *input, double *output,
+                     const std::size_t sampleCount) const noexcept;
 
     /*******************************************************************************
      * @brief Performs backpropagation for output layer.
      *
-     * @param reference Reference to vector holding reference values.
+     *        With cross-entropy loss the loss and activation gradients are fused
+     *        into the difference between reference and output, which neither
+     *        saturates nor needs the softmax Jacobian.
+     *
+     * @param reference Pointer to array holding the nodeCount reference values.
+     * @param loss      The loss function to minimize, must be supported by the
+     *                  activation function (default = squared error).
      *
      * @note This method is implemented for output layers only.
      ******************************************************************************/
-    void backpropagate(const std::vector<double> &reference);
+    void backpropagate(const double *reference, const Loss loss = Loss::SquaredError) noexcept;
 
     /*******************************************************************************
      * @brief Performs backpropagation for hidden layer.
      *
-     * @param nextLayer Reference to the next layer of the neural network.
+     * @param nextLayer Reference to the next layer of the neural network, with one
+     *                  weight per node of this layer.
      *
      * @note This method is implemented for hidden layers only.
      ******************************************************************************/
-    void backpropagate(const DenseLayer &nextLayer);
+    void backpropagate(const DenseLayer &nextLayer) noexcept;
+
+    /*******************************************************************************
+     * @brief Performs backpropagation for hidden layer from the error at its
+     *        output, as calculated by propagateError of the next layer.
+     *
+     * @param outputError Pointer to array holding the nodeCount errors.
+     *
+     * @note This method is implemented for hidden layers only.
+     ******************************************************************************/
+    void backpropagateError(const double *outputError) noexcept;
+
+    /*******************************************************************************
+     * @brief Calculates the error at the input of the layer, which is the error
+     *        at the output of the previous layer before its activation gradient.
+     *
+     * @param inputError Pointer to array to hold the weightCount errors.
+     ******************************************************************************/
+    void propagateError(double *inputError) const noexcept;
 
     /*******************************************************************************
      * @brief Performs optimization for dense layer.
      *
-     * @param input        Reference to vector holding the input of the layer.
+     * @param input        Pointer to array holding the weightCount inputs of the layer.
+     * @param learningRate The rate with which to optimize the parameters, must
+     *                     exceed 0.
+     ******************************************************************************/
+    void optimize(const double *input, const double learningRate = 0.01) noexcept;
+
+    /*******************************************************************************
+     * @brief Adds the update optimize would make to a gradient instead of the
+     *        parameters, so that several samples can be applied at once.
+     *
+     * @param input        Pointer to array holding the weightCount inputs of the layer.
      * @param learningRate The rate with which to optimize the parameters.
+     * @param gradient     Pointer to parameterCount doubles laid out as the
+     *                     parameters. Only the remaining weights of pruned
+     *                     layers are updated.
      ******************************************************************************/
-    void optimize(const std::vector<double> &input, const double learningRate = 0.01);
+    void accumulateGradient(const double *input, const double learningRate,
+                            double *gradient) const noexcept;
+
+    /*******************************************************************************
+     * @brief Adds a gradient made by accumulateGradient to the parameters.
+     *
+     * @param gradient Pointer to parameterCount doubles laid out as the parameters.
+     ******************************************************************************/
+    void applyGradient(const double *gradient) noexcept;
 
     /*******************************************************************************
      * @brief Prints stored parameters.
@@ -127,11 +350,34 @@ class DenseLayer {
     DenseLayer() = delete; // No default destructor.
 
   private:
-    std::vector<double> myOutput;               // Output of each node.
-    std::vector<double> myError;                // Calculated error of each node.
-    std::vector<double> myBias;                 // Bias of each node.
-    std::vector<std::vector<double>> myWeights; // Weights of each node.
-    ActFunc myActFunc;                          // Activation function used for this layer.
+    /*******************************************************************************
+     * @brief Blocked implementation of the dense propagateError kernel.
+     *
+     * @param inputError Pointer to array holding the weightCount zeroed errors.
+     ******************************************************************************/
+    void propagateErrorBlocked(double *inputError) const noexcept;
+
+    /*******************************************************************************
+     * @brief Blocked implementation of the dense optimize kernel.
+     *
+     * @param input        Pointer to array holding the weightCount inputs.
+     * @param learningRate Learning rate to use for optimization, above 0.
+     ******************************************************************************/
+    void optimizeBlocked(const double *input, const double learningRate) noexcept;
+
+    using KernelArray = std::array<KernelVariant, static_cast<std::size_t>(KernelPhase::Count)>;
+
+    std::size_t myNodeCount;     // The number of nodes.
+    std::size_t myWeightCount;   // The number of weights per node.
+    double *myOutput;            // Output of each node, in the activation block.
+    double *myError;             // Calculated error of each node, in the activation block.
+    double *myBias;              // Bias of each node, in the parameter block.
+    double *myWeights;           // Weights of each node, row-major in the parameter block.
+    CsrMatrix mySparseWeights;   // Non-zero weights if the layer is pruned.
+    bool mySparse;               // Indicates if the layer is pruned.
+    ActFunc myActFunc;           // Activation function used for this layer.
+    ActFuncKernels myActKernels; // Kernels of the activation function.
+    KernelArray myKernels;       // Implementation used by each kernel.
 };
 
 } // namespace ml
\ No newline at end of file
@@ -0,0 +1,133 @@
+/*******************************************************************************
+ * @brief Knowledge distillation of a trained network into a smaller network.
+ ******************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "inference_model.h"
+#include "neural_network.h"
+#include "output_errors.h"
+
+namespace ml {
+
+/*******************************************************************************
+ * @brief Class implementation of a distiller.
+ *
+ *        A trained teacher network labels inputs with its soft outputs, and a
+ *        smaller student network is trained to reproduce them. The inputs can
+ *        be densified with inputs drawn from the range of the given inputs,
+ *        so the student also learns how the teacher behaves between them.
+ *
+ *        The teacher is frozen when the distiller is created, so the teacher
+ *        network itself can be discarded or kept offline.
+ ******************************************************************************/
+class Distiller {
+  public:
+    /*******************************************************************************
+     * @brief Structure holding the fidelity and cost of a student compared to
+     *        its teacher.
+     ******************************************************************************/
+    struct Report {
+        OutputErrors errors;      // Errors relative to the teacher outputs.
+        std::size_t teacherBytes; // Parameter memory of the teacher.
+        std::size_t studentBytes; // Parameter memory of the student.
+        double teacherLatencyUs;  // Mean prediction time of the teacher in us.
+        double studentLatencyUs;  // Mean prediction time of the student in us.
+        double speedup;           // Prediction time of the teacher over the student.
+
+        /*******************************************************************************
+         * @brief Prints the report.
+         *
+         * @param ostream Reference to output stream (default = terminal print).
+         ******************************************************************************/
+        void print(std::ostream &ostream = std::cout) const;
+    };
+
+    /*******************************************************************************
+     * @brief Creates new distiller.
+     *
+     * @param teacher Reference to the trained teacher network, frozen here.
+     ******************************************************************************/
+    explicit Distiller(const NeuralNetwork &teacher);
+
+    /*******************************************************************************
+     * @brief Deletes the distiller.
+     ******************************************************************************/
+    ~Distiller() = default;
+
+    /*******************************************************************************
+     * @brief Provides the frozen teacher.
+     *
+     * @return Reference to the inference model of the teacher.
+     ******************************************************************************/
+    const InferenceModel &teacher() const noexcept;
+
+    /*******************************************************************************
+     * @brief Densifies inputs with inputs drawn uniformly from the range of each
+     *        input value.
+     *
+     * @param inputs Reference to vector holding the inputs, at least one.
+     * @param count  The number of inputs to draw.
+     * @param seed   Seed used to draw the inputs.
+     *
+     * @return Vector holding the given inputs followed by the drawn inputs.
+     ******************************************************************************/
+    std::vector<std::vector<double>> densify(const std::vector<std::vector<double>> &inputs,
+                                             const std::size_t count,
+                                             const std::uint32_t seed = 0U) const;
+
+    /*******************************************************************************
+     * @brief Labels inputs with the soft outputs of the teacher.
+     *
+     * @param inputs Reference to vector holding the inputs to label.
+     *
+     * @return Vector holding the output of the teacher for each input.
+     ******************************************************************************/
+    std::vector<std::vector<double>> label(const std::vector<std::vector<double>> &inputs) const;
+
+    /*******************************************************************************
+     * @brief Trains a student on the soft outputs of the teacher, replacing its
+     *        training data, and compares it with the teacher.
+     *
+     * @param student      Reference to the student network, matching the inputs
+     *                     and outputs of the teacher.
+     * @param inputs       Reference to vector holding the inputs to label.
+     * @param epochCount   The number of epochs to train the student.
+     * @param learningRate The learning rate used for training.
+     *
+     * @return The fidelity and cost of the trained student on the inputs.
+     ******************************************************************************/
+    Report distill(NeuralNetwork &student, const std::vector<std::vector<double>> &inputs,
+                   const std::size_t epochCount, const double learningRate) const;
+
+    /*******************************************************************************
+     * @brief Compares a student with the teacher.
+     *
+     *        Decisions are compared by the largest output for multi-output models,
+     *        else by a threshold of 0.5.
+     *
+     * @param student Reference to the frozen student.
+     * @param inputs  Reference to vector holding the inputs to compare on.
+     *
+     * @return The fidelity and cost of the student on the inputs.
+     ******************************************************************************/
+    Report compare(const InferenceModel &student,
+                   const std::vector<std::vector<double>> &inputs) const;
+
+    Distiller() = delete; // No default constructor.
+
+  private:
+    /*******************************************************************************
+     * @brief Throws an exception unless each input matches the teacher.
+     *
+     * @param inputs Reference to vector holding the inputs to check.
+     ******************************************************************************/
+    void checkInputs(const std::vector<std::vector<double>> &inputs) const;
+
+    InferenceModel myTeacher; // The frozen teacher.
+};
+
+} // namespace ml
\ No newline at end of file
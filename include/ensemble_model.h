@@ -0,0 +1,178 @@
+/*******************************************************************************
+ * @brief Ensemble of inference models evaluated in one fused pass.
+ ******************************************************************************/
+#pragma once
+
+#include <iostream>
+#include <vector>
+
+#include "act_func.h"
+#include "inference_model.h"
+
+namespace ml {
+
+/*******************************************************************************
+ * @brief Class implementation of an ensemble model.
+ *
+ *        The layers of the members are packed side by side: the first layers of
+ *        all members form one matrix multiplied with the shared input, and each
+ *        following layer holds the blocks of all members back to back, each
+ *        block reading only the outputs of its own member. One pass over the
+ *        packed layers therefore evaluates every member, after which the member
+ *        outputs are combined. Adjacent members sharing input and activation
+ *        function, as in the first layer, are merged into a single block.
+ *
+ *        Members must have the same number of inputs, outputs and layers, but
+ *        may differ in width and activation functions. Like ml::InferenceModel,
+ *        the ensemble is immutable and prediction is reentrant.
+ ******************************************************************************/
+class EnsembleModel {
+  public:
+    /*******************************************************************************
+     * @brief Enumeration class representing how member outputs are combined.
+     ******************************************************************************/
+    enum class Combine {
+        Average, // The mean of the member outputs.
+        Median,  // The median of the member outputs, robust against outliers.
+        Vote,    // Majority vote, by the largest output or by the side of 0.5.
+    };
+
+    /*******************************************************************************
+     * @brief Structure holding consecutive nodes of a packed layer that read the
+     *        same inputs with the same activation function.
+     ******************************************************************************/
+    struct Block {
+        std::size_t nodeOffset;   // Index of the first node of the block in the layer.
+        std::size_t nodeCount;    // The number of nodes of the block.
+        std::size_t inputOffset;  // Index of the first input read by the block.
+        std::size_t weightCount;  // The number of weights per node.
+        std::size_t weightOffset; // Index of the first weight of the block.
+        ActFunc actFunc;          // Activation function of the block.
+    };
+
+    /*******************************************************************************
+     * @brief Structure holding a packed layer.
+     ******************************************************************************/
+    struct Layer {
+        std::size_t nodeCount;       // The total number of nodes of all members.
+        std::vector<double> bias;    // Bias of each node.
+        std::vector<double> weights; // Weights of each node, block by block.
+        std::vector<Block> blocks;   // The blocks of the members, in member order.
+    };
+
+    /*******************************************************************************
+     * @brief Structure holding scratch memory for prediction.
+     ******************************************************************************/
+    struct Scratch {
+        std::vector<double> input;  // Input buffer of the current layer.
+        std::vector<double> output; // Output buffer of the current layer.
+        std::vector<double> result; // The combined output.
+    };
+
+    /*******************************************************************************
+     * @brief Creates new ensemble model.
+     *
+     * @param members Reference to vector holding the members to pack.
+     * @param combine How member outputs are combined (default = average).
+     ******************************************************************************/
+    explicit EnsembleModel(const std::vector<InferenceModel> &members,
+                           const Combine combine = Combine::Average);
+
+    /*******************************************************************************
+     * @brief Deletes the ensemble model.
+     ******************************************************************************/
+    ~EnsembleModel() = default;
+
+    /*******************************************************************************
+     * @brief Provides the number of members of the ensemble.
+     *
+     * @return The number of members.
+     ******************************************************************************/
+    std::size_t memberCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the number of inputs of the ensemble.
+     *
+     * @return The number of inputs.
+     ******************************************************************************/
+    std::size_t inputCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the number of outputs of the ensemble.
+     *
+     * @return The number of outputs.
+     ******************************************************************************/
+    std::size_t outputCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides how member outputs are combined.
+     *
+     * @return The combine method.
+     ******************************************************************************/
+    Combine combine() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the packed layers of the ensemble.
+     *
+     * @return Reference to vector holding the layers, output layer last.
+     ******************************************************************************/
+    const std::vector<Layer> &layers() const noexcept;
+
+    /*******************************************************************************
+     * @brief Performs prediction with caller-supplied scratch memory.
+     *
+     * @param input   Reference to vector holding the input for which to predict.
+     * @param scratch Reference to scratch memory used for the prediction.
+     *
+     * @return Reference to vector in the scratch holding the combined output,
+     *         valid until the scratch is used again.
+     ******************************************************************************/
+    const std::vector<double> &predict(const std::vector<double> &input,
+                                       Scratch &scratch) const;
+
+    /*******************************************************************************
+     * @brief Performs prediction with scratch memory of the calling thread.
+     *
+     * @param input Reference to vector holding the input for which to predict.
+     *
+     * @return Reference to vector holding the combined output, valid until the
+     *         calling thread predicts again.
+     ******************************************************************************/
+    const std::vector<double> &predict(const std::vector<double> &input) const;
+
+    /*******************************************************************************
+     * @brief Provides the output of a member from the last prediction.
+     *
+     * @param scratch Reference to the scratch memory used for the prediction.
+     * @param member  Index of the member.
+     *
+     * @return Pointer to array holding the outputCount outputs of the member.
+     ******************************************************************************/
+    const double *memberOutput(const Scratch &scratch, const std::size_t member) const noexcept;
+
+    /*******************************************************************************
+     * @brief Prints the shape of each packed layer.
+     *
+     * @param ostream Reference to output stream (default = terminal print).
+     ******************************************************************************/
+    void print(std::ostream &ostream = std::cout) const;
+
+    EnsembleModel() = delete; // No default constructor.
+
+  private:
+    /*******************************************************************************
+     * @brief Combines the member outputs held by the scratch.
+     *
+     * @param scratch Reference to the scratch memory holding the member outputs.
+     ******************************************************************************/
+    void combineOutputs(Scratch &scratch) const;
+
+    std::vector<Layer> myLayers; // The packed layers, output layer last.
+    std::size_t myMemberCount;   // The number of members.
+    std::size_t myInputCount;    // The number of inputs.
+    std::size_t myOutputCount;   // The number of outputs of each member.
+    std::size_t myMaxWidth;      // The width of the widest packed layer or input.
+    Combine myCombine;           // How member outputs are combined.
+};
+
+} // namespace ml
\ No newline at end of file
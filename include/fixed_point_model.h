@@ -0,0 +1,244 @@
+/*******************************************************************************
+ * @brief Fixed-point inference model for targets without a fast FPU.
+ ******************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "act_func.h"
+#include "inference_model.h"
+#include "output_errors.h"
+
+namespace ml {
+namespace fixed {
+
+/*******************************************************************************
+ * @brief The number of fractional bits of values passed to the lookup tables,
+ *        i.e. lookup table input is Q3.12 covering -8.0 - 8.0.
+ ******************************************************************************/
+constexpr int LutInputFraction{12};
+
+/*******************************************************************************
+ * @brief Saturates a value to the range of a 16-bit integer.
+ *
+ * @param value The value to saturate.
+ *
+ * @return The saturated value.
+ ******************************************************************************/
+std::int16_t saturate16(const std::int64_t value) noexcept;
+
+/*******************************************************************************
+ * @brief Adds two 32-bit integers, saturating instead of wrapping on overflow.
+ *
+ * @param a The first term.
+ * @param b The second term.
+ *
+ * @return The saturated sum.
+ ******************************************************************************/
+std::int32_t addSaturate32(const std::int32_t a, const std::int32_t b) noexcept;
+
+/*******************************************************************************
+ * @brief Shifts a value right with rounding half up, or left if the shift is
+ *        negative.
+ *
+ * @param value The value to shift.
+ * @param shift The number of bits to shift right.
+ *
+ * @return The shifted value.
+ ******************************************************************************/
+std::int64_t shiftRound(const std::int64_t value, const int shift) noexcept;
+
+/*******************************************************************************
+ * @brief Provides the hyperbolic tangent via a 256-entry lookup table with
+ *        linear interpolation, saturating outside -4.0 - 4.0.
+ *
+ * @param input The input in Q3.12.
+ *
+ * @return The hyperbolic tangent in Q15.
+ ******************************************************************************/
+std::int16_t tanh(const std::int16_t input) noexcept;
+
+/*******************************************************************************
+ * @brief Provides the logistic sigmoid via the tanh lookup table, using
+ *        sigmoid(x) = (1 + tanh(x / 2)) / 2.
+ *
+ * @param input The input in Q3.12.
+ *
+ * @return The sigmoid in Q15.
+ ******************************************************************************/
+std::int16_t sigmoid(const std::int16_t input) noexcept;
+
+} // namespace fixed
+
+/*******************************************************************************
+ * @brief Class implementation of a fixed-point inference model.
+ *
+ *        Weights and activations are 16-bit integers with a power-of-two scale
+ *        per layer, chosen from calibration inputs so that no value saturates.
+ *        Each node accumulates its bias and products in a saturating 32-bit
+ *        accumulator, which is then rounded to the format of the layer output.
+ *        Tanh and sigmoid use an integer lookup table, ReLU, leaky ReLU and
+ *        linear are computed directly; softmax layers are not supported.
+ *
+ *        The integer prediction only uses the arithmetic of the ml::fixed
+ *        functions above, so it serves as a bit-exact reference for ports to
+ *        integer-only cores. Like ml::InferenceModel, the model is immutable
+ *        and prediction is reentrant.
+ ******************************************************************************/
+class FixedPointModel {
+  public:
+    /*******************************************************************************
+     * @brief Structure holding the parameters of a layer.
+     *
+     *        A value v with f fractional bits represents v / 2^f.
+     ******************************************************************************/
+    struct Layer {
+        std::size_t nodeCount;             // The number of nodes of the layer.
+        std::size_t weightCount;           // The number of weights per node.
+        ActFunc actFunc;                   // Activation function of the layer.
+        int inputFraction;                 // Fractional bits of the layer input.
+        int weightFraction;                // Fractional bits of the weights.
+        int outputFraction;                // Fractional bits of the layer output.
+        std::vector<std::int32_t> bias;    // Bias of each node, in accumulator format.
+        std::vector<std::int16_t> weights; // Weights, row-major.
+    };
+
+    /*******************************************************************************
+     * @brief Structure holding scratch memory for prediction.
+     ******************************************************************************/
+    struct Scratch {
+        std::vector<std::int16_t> input;  // Input buffer of the current layer.
+        std::vector<std::int16_t> output; // Output buffer of the current layer.
+    };
+
+    /*******************************************************************************
+     * @brief Structure holding the error of the fixed-point model compared to
+     *        the floating-point model it was created from.
+     ******************************************************************************/
+    struct ErrorReport {
+        OutputErrors errors;     // Errors relative to the floating-point outputs.
+        std::size_t doubleBytes; // Parameter memory of the floating-point model.
+        std::size_t fixedBytes;  // Parameter memory of the fixed-point model.
+
+        /*******************************************************************************
+         * @brief Prints the report.
+         *
+         * @param ostream Reference to output stream (default = terminal print).
+         ******************************************************************************/
+        void print(std::ostream &ostream = std::cout) const;
+    };
+
+    /*******************************************************************************
+     * @brief Creates fixed-point model from a floating-point model.
+     *
+     * @param model             Reference to the model to quantize.
+     * @param calibrationInputs Reference to vector holding representative
+     *                          inputs, used to choose the scale of each layer.
+     ******************************************************************************/
+    FixedPointModel(const InferenceModel &model,
+                    const std::vector<std::vector<double>> &calibrationInputs);
+
+    /*******************************************************************************
+     * @brief Deletes the fixed-point model.
+     ******************************************************************************/
+    ~FixedPointModel() = default;
+
+    /*******************************************************************************
+     * @brief Provides the number of inputs of the model.
+     *
+     * @return The number of inputs.
+     ******************************************************************************/
+    std::size_t inputCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the number of outputs of the model.
+     *
+     * @return The number of outputs.
+     ******************************************************************************/
+    std::size_t outputCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the layers of the model.
+     *
+     * @return Reference to vector holding the layers, output layer last.
+     ******************************************************************************/
+    const std::vector<Layer> &layers() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the memory used by the parameters of the model.
+     *
+     * @return The number of bytes used by biases and weights.
+     ******************************************************************************/
+    std::size_t parameterBytes() const noexcept;
+
+    /*******************************************************************************
+     * @brief Converts an input to the input format of the model.
+     *
+     * @param input Reference to vector holding the input to convert.
+     *
+     * @return Vector holding the converted input.
+     ******************************************************************************/
+    std::vector<std::int16_t> quantizeInput(const std::vector<double> &input) const;
+
+    /*******************************************************************************
+     * @brief Converts an output of the model to floating-point values.
+     *
+     * @param output Reference to vector holding the output to convert.
+     *
+     * @return Vector holding the converted output.
+     ******************************************************************************/
+    std::vector<double> dequantizeOutput(const std::vector<std::int16_t> &output) const;
+
+    /*******************************************************************************
+     * @brief Performs integer-only prediction with caller-supplied scratch memory.
+     *
+     * @param input   Reference to vector holding the quantized input.
+     * @param scratch Reference to scratch memory used for the prediction.
+     *
+     * @return Reference to vector in the scratch holding the quantized output,
+     *         valid until the scratch is used again.
+     ******************************************************************************/
+    const std::vector<std::int16_t> &predict(const std::vector<std::int16_t> &input,
+                                             Scratch &scratch) const;
+
+    /*******************************************************************************
+     * @brief Performs prediction with floating-point input and output, using
+     *        scratch memory of the calling thread.
+     *
+     * @param input Reference to vector holding the input for which to predict.
+     *
+     * @return Vector holding the predicted output.
+     ******************************************************************************/
+    std::vector<double> predict(const std::vector<double> &input) const;
+
+    /*******************************************************************************
+     * @brief Compares the predictions of the model with a floating-point model.
+     *
+     *        Decisions are compared by the largest output for multi-output models,
+     *        else by which side of 0.5 the output is on.
+     *
+     * @param model  Reference to the floating-point model to compare with.
+     * @param inputs Reference to vector holding the inputs to predict.
+     *
+     * @return Report holding the error statistics.
+     ******************************************************************************/
+    ErrorReport compare(const InferenceModel &model,
+                        const std::vector<std::vector<double>> &inputs) const;
+
+    /*******************************************************************************
+     * @brief Prints the shape and format of each layer.
+     *
+     * @param ostream Reference to output stream (default = terminal print).
+     ******************************************************************************/
+    void print(std::ostream &ostream = std::cout) const;
+
+    FixedPointModel() = delete; // No default constructor.
+
+  private:
+    std::vector<Layer> myLayers; // The layers of the model, output layer last.
+    std::size_t myMaxWidth;      // The width of the widest layer or input.
+};
+
+} // namespace ml
\ No newline at end of file
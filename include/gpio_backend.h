@@ -0,0 +1,124 @@
+/********************************************************************************
+ * @brief Backend abstraction for GPIO access on Raspberry Pi.
+ ********************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rpi {
+namespace gpio {
+
+/********************************************************************************
+ * @brief The number of GPIO lines a backend can handle.
+ ********************************************************************************/
+constexpr std::uint8_t LineCount{64U};
+
+/********************************************************************************
+ * @brief Enumeration class representing data direction of GPIO lines.
+ ********************************************************************************/
+enum class Direction {
+    In,  // Input line.
+    Out, // Output line.
+};
+
+/********************************************************************************
+ * @brief Interface for GPIO backends.
+ *
+ *        Lines are identified by their GPIO pin number, which must be lower
+ *        than LineCount. Drivers such as rpi::Led and rpi::Button perform all
+ *        hardware access via a backend, so the same application code can run
+ *        on the Raspberry Pi (libgpiod) or on a simulated chip.
+ ********************************************************************************/
+class Backend {
+  public:
+    /********************************************************************************
+     * @brief Deletes the backend.
+     ********************************************************************************/
+    virtual ~Backend() noexcept = default;
+
+    /********************************************************************************
+     * @brief Requests GPIO line for use.
+     *
+     * @param pin       GPIO pin of the line to request.
+     * @param direction Data direction of the line.
+     *
+     * @return True if the line was requested, else false.
+     ********************************************************************************/
+    virtual bool requestLine(const std::uint8_t pin, const Direction direction) noexcept = 0;
+
+    /********************************************************************************
+     * @brief Releases previously requested GPIO line.
+     *
+     * @param pin GPIO pin of the line to release.
+     ********************************************************************************/
+    virtual void releaseLine(const std::uint8_t pin) noexcept = 0;
+
+    /********************************************************************************
+     * @brief Reads the value of GPIO line.
+     *
+     * @param pin GPIO pin of the line to read.
+     *
+     * @return True if the line is high, else false.
+     ********************************************************************************/
+    virtual bool read(const std::uint8_t pin) noexcept = 0;
+
+    /********************************************************************************
+     * @brief Writes output value to GPIO line.
+     *
+     * @param pin   GPIO pin of the line to write to.
+     * @param value The value to write.
+     ********************************************************************************/
+    virtual void write(const std::uint8_t pin, const bool value) noexcept = 0;
+
+    /********************************************************************************
+     * @brief Requests several GPIO output lines together.
+     *
+     *        Lines requested together are written with writeBulk, given all
+     *        pins in the requested order, and not one by one. The default
+     *        implementation requests the lines one by one; backends able to
+     *        set several lines in one call override this method.
+     *
+     * @param pins  Pointer to array holding the GPIO pins of the lines.
+     * @param count The number of lines to request.
+     *
+     * @return True if all lines were requested, else false.
+     ********************************************************************************/
+    virtual bool requestOutputs(const std::uint8_t *pins, const std::size_t count) noexcept;
+
+    /********************************************************************************
+     * @brief Writes output values to several GPIO lines at once.
+     *
+     *        The default implementation writes the lines one by one and cannot
+     *        detect failures, since write has no status.
+     *
+     * @param pins   Pointer to array holding the GPIO pins to write to.
+     * @param values Pointer to array holding the value of each pin.
+     * @param count  The number of lines to write.
+     *
+     * @return True if all lines were written, else false.
+     ********************************************************************************/
+    virtual bool writeBulk(const std::uint8_t *pins, const bool *values,
+                           const std::size_t count) noexcept;
+};
+
+/********************************************************************************
+ * @brief Provides the default backend used by drivers that aren't given one.
+ *
+ *        The default backend is the libgpiod backend for /dev/gpiochip0, or
+ *        a simulated chip when built with RPI_GPIO_SIM defined.
+ *
+ * @return Reference to the default backend.
+ ********************************************************************************/
+Backend &defaultBackend() noexcept;
+
+/********************************************************************************
+ * @brief Replaces the default backend.
+ *
+ * @param backend Reference to the new default backend, which must outlive all
+ *                drivers created with it.
+ ********************************************************************************/
+void setDefaultBackend(Backend &backend) noexcept;
+
+} // namespace gpio
+} // namespace rpi
\ No newline at end of file
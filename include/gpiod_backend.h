@@ -0,0 +1,94 @@
+/********************************************************************************
+ * @brief GPIO backend for the Linux GPIO driver (libgpiod).
+ ********************************************************************************/
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "gpio_backend.h"
+
+struct gpiod_chip;
+struct gpiod_line;
+
+namespace rpi {
+namespace gpio {
+
+/********************************************************************************
+ * @brief Implementation of GPIO backend using libgpiod.
+ *
+ *        This class is non-copyable and non-movable.
+ ********************************************************************************/
+class GpiodBackend : public Backend {
+  public:
+    /********************************************************************************
+     * @brief Creates new backend for specified GPIO chip.
+     *
+     * @param chipPath Path to the GPIO chip device (default = /dev/gpiochip0).
+     ********************************************************************************/
+    explicit GpiodBackend(const char *chipPath = "/dev/gpiochip0") noexcept;
+
+    /********************************************************************************
+     * @brief Deletes backend, releases all requested lines and closes the chip.
+     ********************************************************************************/
+    ~GpiodBackend() noexcept override;
+
+    /********************************************************************************
+     * @brief Indicates if the GPIO chip was opened successfully.
+     *
+     * @return True if the chip is open, else false.
+     ********************************************************************************/
+    bool isOpen() const noexcept;
+
+    bool requestLine(const std::uint8_t pin, const Direction direction) noexcept override;
+    void releaseLine(const std::uint8_t pin) noexcept override;
+    bool read(const std::uint8_t pin) noexcept override;
+    void write(const std::uint8_t pin, const bool value) noexcept override;
+    bool requestOutputs(const std::uint8_t *pins, const std::size_t count) noexcept override;
+    bool writeBulk(const std::uint8_t *pins, const bool *values,
+                   const std::size_t count) noexcept override;
+
+    GpiodBackend(const GpiodBackend &) = delete;            // No copy constructor.
+    GpiodBackend(GpiodBackend &&) = delete;                 // No move constructor.
+    GpiodBackend &operator=(const GpiodBackend &) = delete; // No copy assignment.
+    GpiodBackend &operator=(GpiodBackend &&) = delete;      // No move assignment.
+
+  private:
+    /********************************************************************************
+     * @brief Structure holding the position of a line in a group of lines
+     *        requested together.
+     ********************************************************************************/
+    struct GroupLine {
+        std::uint8_t first; // GPIO pin of the first line in the group.
+        std::uint8_t index; // Index of the line in the group.
+        std::uint8_t size;  // The number of lines in the group, 0 if requested alone.
+    };
+
+    /********************************************************************************
+     * @brief Indicates if the given pins are a group requested together, in
+     *        the requested order.
+     *
+     * @param pins  Pointer to array holding the GPIO pins.
+     * @param count The number of pins.
+     *
+     * @return True if the pins are a group, else false.
+     ********************************************************************************/
+    bool isGroup(const std::uint8_t *pins, const std::size_t count) const noexcept;
+
+    /********************************************************************************
+     * @brief Indicates if a line can be accessed on its own, i.e. if it is
+     *        requested and doesn't share its request with other lines.
+     *
+     * @param pin GPIO pin of the line.
+     *
+     * @return True if the line can be accessed on its own, else false.
+     ********************************************************************************/
+    bool isSingle(const std::uint8_t pin) const noexcept;
+
+    struct gpiod_chip *myChip;                          // Pointer to GPIO chip.
+    std::array<struct gpiod_line *, LineCount> myLines; // Requested lines, indexed by pin.
+    std::array<GroupLine, LineCount> myGroups;          // Group of each line, indexed by pin.
+};
+
+} // namespace gpio
+} // namespace rpi
\ No newline at end of file
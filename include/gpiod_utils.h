@@ -6,6 +6,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+struct gpiod_chip; /* GPIO chip structure. */
 struct gpiod_line; /* GPIO line structure. */
 
 #ifdef __cplusplus
@@ -44,6 +45,18 @@ enum gpiod_line_edge
  ********************************************************************************/
 struct gpiod_line* gpiod_line_new(const uint8_t pin, const enum gpiod_line_direction direction);
 
+/********************************************************************************
+ * @brief Creates new GPIO line for a device connected to specified chip.
+ * 
+ * @param chip      Pointer to the GPIO chip the device is connected to.
+ * @param pin       GPIO pin the device is connected to.
+ * @param direction Data direction of the device.
+ * 
+ * @return Pointer to the new GPIO line or a null pointer on failure.
+ ********************************************************************************/
+struct gpiod_line* gpiod_line_new_from_chip(struct gpiod_chip* chip, const uint8_t pin, 
+                                             const enum gpiod_line_direction direction);
+
 
 /********************************************************************************
  * @brief Toggles the output of specified GPIO line.
@@ -0,0 +1,182 @@
+/*******************************************************************************
+ * @brief Parallel search for neural network topologies and training parameters.
+ ******************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "act_func.h"
+#include "loss.h"
+#include "neural_network.h"
+
+namespace ml {
+
+/*******************************************************************************
+ * @brief Class implementation of a hyperparameter sweep.
+ *
+ *        Candidate networks are trained concurrently on a pool of threads, each
+ *        candidate with its own random seed so that results are reproducible.
+ *        The error of each candidate is measured at epoch milestones shared by
+ *        all candidates; a candidate whose error is far worse than the best
+ *        error seen at the same milestone is cancelled. As candidates reach a
+ *        milestone concurrently, which candidates are cancelled can depend on
+ *        the order in which they get there.
+ *
+ *        This class is non-copyable and non-movable.
+ ******************************************************************************/
+class HyperparameterSweep {
+  public:
+    /*******************************************************************************
+     * @brief Structure holding the values to search for each parameter.
+     ******************************************************************************/
+    struct SearchSpace {
+        std::vector<std::size_t> hiddenLayerCounts; // The number of hidden layers.
+        std::vector<std::size_t> hiddenNodeCounts;  // The number of nodes per hidden layer.
+        std::vector<ActFunc> hiddenActFuncs;        // Activation functions of hidden layers.
+        std::vector<ActFunc> outputActFuncs;        // Activation functions of the output layer.
+        std::vector<double> learningRates;          // Learning rates.
+        std::vector<std::size_t> epochCounts;       // The number of training epochs.
+    };
+
+    /*******************************************************************************
+     * @brief Structure holding the parameters of a candidate network.
+     ******************************************************************************/
+    struct Candidate {
+        std::vector<NeuralNetwork::LayerSpec> hiddenLayers; // Shape of each hidden layer.
+        NeuralNetwork::LayerSpec outputLayer;               // Shape of the output layer.
+        double learningRate;                                // Learning rate.
+        std::size_t epochCount;                             // The number of training epochs.
+        std::uint32_t seed;                                 // Seed of the random generator.
+
+        /*******************************************************************************
+         * @brief Describes the topology of the candidate, e.g. "8 tanh, 4 relu, 1 sig".
+         *
+         * @return The description as a string.
+         ******************************************************************************/
+        std::string topology() const;
+    };
+
+    /*******************************************************************************
+     * @brief Structure holding the result of training a candidate.
+     ******************************************************************************/
+    struct Result {
+        Candidate candidate;        // The trained candidate.
+        double error;               // Mean squared error on the training sets.
+        double accuracy;            // Fraction of outputs within 0.5 of the reference.
+        std::size_t epochsRun;      // The number of epochs trained before stopping.
+        bool cancelled;             // Indicates if training was stopped early.
+        std::size_t flopCount;      // Floating point operations per prediction.
+        std::size_t parameterBytes; // Parameter memory in bytes.
+        double trainingTimeS;       // Training time in seconds.
+    };
+
+    /*******************************************************************************
+     * @brief Creates new hyperparameter sweep.
+     *
+     * @param input  Reference to vector holding the training input sets.
+     * @param output Reference to vector holding the training output sets.
+     * @param loss   The loss function minimized by all candidates
+     *               (default = squared error).
+     ******************************************************************************/
+    HyperparameterSweep(const std::vector<std::vector<double>> &input,
+                        const std::vector<std::vector<double>> &output,
+                        const Loss loss = Loss::SquaredError);
+
+    /*******************************************************************************
+     * @brief Deletes the hyperparameter sweep.
+     ******************************************************************************/
+    ~HyperparameterSweep() noexcept = default;
+
+    /*******************************************************************************
+     * @brief Sets the number of threads training candidates concurrently.
+     *
+     * @param threadCount The number of threads, 0 = one per hardware thread.
+     ******************************************************************************/
+    void setThreadCount(const std::size_t threadCount) noexcept;
+
+    /*******************************************************************************
+     * @brief Sets when candidates are cancelled.
+     *
+     * @param checkpointCount The number of milestones, spread evenly over the
+     *                        epochs of the longest candidate, at least 1.
+     * @param cancelRatio     A candidate is cancelled if its error exceeds the
+     *                        best error at the same milestone by this factor,
+     *                        0.0 = never cancel.
+     * @param errorFloor      Candidates with an error at or below this floor are
+     *                        never cancelled (default = 0.001).
+     ******************************************************************************/
+    void setCancellation(const std::size_t checkpointCount, const double cancelRatio,
+                         const double errorFloor = 1.0e-3);
+
+    /*******************************************************************************
+     * @brief Creates a candidate for every combination in the search space,
+     *        all hidden layers of a candidate having the same shape.
+     *
+     * @param space Reference to the search space.
+     * @param seed  The seed of the first candidate, the following candidates
+     *              use consecutive seeds.
+     *
+     * @return Vector holding the candidates.
+     ******************************************************************************/
+    std::vector<Candidate> gridCandidates(const SearchSpace &space,
+                                          const std::uint32_t seed = 0U) const;
+
+    /*******************************************************************************
+     * @brief Creates randomly drawn candidates from the search space, the
+     *        width and activation function of each hidden layer drawn separately.
+     *
+     * @param space Reference to the search space.
+     * @param count The number of candidates to create.
+     * @param seed  Seed used to draw the candidates and their seeds.
+     *
+     * @return Vector holding the candidates.
+     ******************************************************************************/
+    std::vector<Candidate> randomCandidates(const SearchSpace &space, const std::size_t count,
+                                            const std::uint32_t seed = 0U) const;
+
+    /*******************************************************************************
+     * @brief Trains the given candidates concurrently.
+     *
+     * @param candidates Reference to vector holding the candidates to train.
+     *
+     * @return Vector holding the results, ranked with the best result first.
+     ******************************************************************************/
+    std::vector<Result> run(const std::vector<Candidate> &candidates) const;
+
+    /*******************************************************************************
+     * @brief Prints ranked results as a table.
+     *
+     * @param results Reference to vector holding the results to print.
+     * @param ostream Reference to output stream (default = terminal print).
+     ******************************************************************************/
+    static void print(const std::vector<Result> &results, std::ostream &ostream = std::cout);
+
+    HyperparameterSweep() = delete;                                       // No default constructor.
+    HyperparameterSweep(const HyperparameterSweep &) = delete;            // No copy constructor.
+    HyperparameterSweep(HyperparameterSweep &&) = delete;                 // No move constructor.
+    HyperparameterSweep &operator=(const HyperparameterSweep &) = delete; // No copy assignment.
+    HyperparameterSweep &operator=(HyperparameterSweep &&) = delete;      // No move assignment.
+
+  private:
+    /*******************************************************************************
+     * @brief Indicates if a candidate can be built with the training sets.
+     *
+     * @param candidate Reference to the candidate in question.
+     *
+     * @return True if the candidate is valid, else false.
+     ******************************************************************************/
+    bool isValid(const Candidate &candidate) const noexcept;
+
+    std::vector<std::vector<double>> myInput;  // Training input sets.
+    std::vector<std::vector<double>> myOutput; // Training output sets.
+    Loss myLoss;                               // Loss minimized by all candidates.
+    std::size_t myThreadCount;                 // The number of training threads.
+    std::size_t myCheckpointCount;             // The number of error milestones.
+    double myCancelRatio;                      // Error ratio for cancellation.
+    double myErrorFloor;                       // Error below which nothing is cancelled.
+};
+
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,132 @@
+/*******************************************************************************
+ * @brief Immutable, thread-safe inference model of a trained neural network.
+ ******************************************************************************/
+#pragma once
+
+#include <iostream>
+#include <vector>
+
+#include "act_func.h"
+#include "csr_matrix.h"
+
+namespace ml {
+
+/*******************************************************************************
+ * @brief Class implementation of an inference model.
+ *
+ *        The model holds only the biases, weights and activation functions of
+ *        each layer, and is never modified once created. Prediction is const
+ *        and writes only to scratch memory owned by the caller (or by the
+ *        calling thread), so one model can serve any number of threads.
+ *
+ *        Models are created by ml::NeuralNetwork::freeze.
+ ******************************************************************************/
+class InferenceModel {
+  public:
+    /*******************************************************************************
+     * @brief Structure holding the parameters of a layer.
+     ******************************************************************************/
+    struct Layer {
+        std::size_t nodeCount;       // The number of nodes of the layer.
+        std::size_t weightCount;     // The number of weights per node.
+        ActFunc actFunc;             // Activation function of the layer.
+        std::vector<double> bias;    // Bias of each node.
+        std::vector<double> weights; // Dense weights, row-major (empty if sparse).
+        CsrMatrix sparseWeights;     // Non-zero weights of pruned layers.
+    };
+
+    /*******************************************************************************
+     * @brief Structure holding scratch memory for prediction.
+     *
+     *        A scratch can be reused for any number of predictions, but must
+     *        not be shared between threads predicting at the same time.
+     ******************************************************************************/
+    struct Scratch {
+        std::vector<double> input;  // Input buffer of the current layer.
+        std::vector<double> output; // Output buffer of the current layer.
+    };
+
+    /*******************************************************************************
+     * @brief Creates new inference model.
+     *
+     * @param layers The layers of the model, output layer last.
+     ******************************************************************************/
+    explicit InferenceModel(std::vector<Layer> layers);
+
+    /*******************************************************************************
+     * @brief Deletes the inference model.
+     ******************************************************************************/
+    ~InferenceModel() = default;
+
+    /*******************************************************************************
+     * @brief Provides the number of inputs of the model.
+     *
+     * @return The number of inputs.
+     ******************************************************************************/
+    std::size_t inputCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the number of outputs of the model.
+     *
+     * @return The number of outputs.
+     ******************************************************************************/
+    std::size_t outputCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the layers of the model.
+     *
+     * @return Reference to vector holding the layers, output layer last.
+     ******************************************************************************/
+    const std::vector<Layer> &layers() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the memory used by the parameters of the model.
+     *
+     * @return The number of bytes used by biases and weights.
+     ******************************************************************************/
+    std::size_t parameterBytes() const noexcept;
+
+    /*******************************************************************************
+     * @brief Creates scratch memory large enough for any layer of the model.
+     *
+     * @return The new scratch memory.
+     ******************************************************************************/
+    Scratch makeScratch() const;
+
+    /*******************************************************************************
+     * @brief Performs prediction with caller-supplied scratch memory.
+     *
+     * @param input   Reference to vector holding the input for which to predict.
+     * @param scratch Reference to scratch memory used for the prediction.
+     *
+     * @return Reference to vector in the scratch holding the predicted output,
+     *         valid until the scratch is used again.
+     ******************************************************************************/
+    const std::vector<double> &predict(const std::vector<double> &input,
+                                       Scratch &scratch) const;
+
+    /*******************************************************************************
+     * @brief Performs prediction with scratch memory of the calling thread.
+     *
+     * @param input Reference to vector holding the input for which to predict.
+     *
+     * @return Reference to vector holding the predicted output, valid until the
+     *         calling thread predicts again.
+     ******************************************************************************/
+    const std::vector<double> &predict(const std::vector<double> &input) const;
+
+    /*******************************************************************************
+     * @brief Prints the shape of each layer.
+     *
+     * @param ostream Reference to output stream (default = terminal print).
+     ******************************************************************************/
+    void print(std::ostream &ostream = std::cout) const;
+
+    InferenceModel() = delete; // No default constructor.
+
+  private:
+    std::vector<Layer> myLayers; // The layers of the model, output layer last.
+    std::size_t myMaxWidth;      // The width of the widest layer or input.
+};
+
+} // namespace ml
\ No newline at end of file
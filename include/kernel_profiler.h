@@ -0,0 +1,222 @@
+/*******************************************************************************
+ * @brief Hardware performance counter profiling of the layer kernels.
+ ******************************************************************************/
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ml {
+
+/*******************************************************************************
+ * @brief Enum representing the profiled kernel phases of a layer.
+ ******************************************************************************/
+enum class KernelPhase : unsigned {
+    Feedforward,   // DenseLayer::feedforward.
+    Backpropagate, // DenseLayer::backpropagate.
+    Optimize,      // DenseLayer::optimize.
+    Count,         // The number of phases available.
+};
+
+/*******************************************************************************
+ * @brief Enum representing the hardware counters read by the profiler.
+ ******************************************************************************/
+enum class KernelCounter : unsigned {
+    Cycles,       // CPU cycles.
+    Instructions, // Retired instructions.
+    L1Misses,     // L1 data cache read misses.
+    LlcMisses,    // Last level cache misses.
+    BranchMisses, // Mispredicted branches.
+    Count,        // The number of counters available.
+};
+
+/*******************************************************************************
+ * @brief Provides the name of a given kernel phase.
+ *
+ * @param phase The phase in question.
+ *
+ * @return The name of the phase as a string.
+ ******************************************************************************/
+const char *kernelPhaseName(const KernelPhase phase);
+
+/*******************************************************************************
+ * @brief Class implementation of a kernel profiler.
+ *
+ *        The counters are opened as one Linux perf_event_open group for the
+ *        calling thread, counting user space only, and read with a single
+ *        system call at the start and end of each phase. The deltas are scaled
+ *        for multiplexing and aggregated per layer and phase. Counters the
+ *        kernel or hardware refuses are skipped; if none can be opened (no
+ *        PMU, perf_event_paranoid, containers, non-Linux), only wall-clock
+ *        time is recorded.
+ *
+ *        Phases must run on the thread that created the profiler. Each read
+ *        costs a system call, so profiled runs are slower than normal runs.
+ *
+ *        This class is non-copyable and non-movable.
+ ******************************************************************************/
+class KernelProfiler {
+  public:
+    /*******************************************************************************
+     * @brief Structure holding the counter values at the start of a phase.
+     ******************************************************************************/
+    struct Snapshot {
+        std::array<std::uint64_t, static_cast<unsigned>(KernelCounter::Count)>
+            values;                // Raw value of each counter.
+        std::uint64_t timeEnabled; // Time the group was enabled in nanoseconds.
+        std::uint64_t timeRunning; // Time the group was counting in nanoseconds.
+        std::uint64_t timeNs;      // Monotonic timestamp in nanoseconds.
+    };
+
+    /*******************************************************************************
+     * @brief Structure holding the aggregated counts of a layer phase.
+     ******************************************************************************/
+    struct Totals {
+        std::uint64_t callCount; // The number of profiled calls.
+        std::uint64_t timeNs;    // Wall-clock time in nanoseconds.
+        std::array<double, static_cast<unsigned>(KernelCounter::Count)>
+            counts; // Scaled count of each counter.
+    };
+
+    /*******************************************************************************
+     * @brief Class implementation of a scope profiling a layer phase, recording
+     *        the counters from its creation to its deletion.
+     ******************************************************************************/
+    class Scope {
+      public:
+        /*******************************************************************************
+         * @brief Starts profiling a layer phase.
+         *
+         * @param profiler Pointer to the profiler, nullptr to profile nothing.
+         * @param layer    Index of the profiled layer.
+         * @param phase    The profiled phase.
+         ******************************************************************************/
+        Scope(KernelProfiler *profiler, const std::size_t layer, const KernelPhase phase) noexcept;
+
+        /*******************************************************************************
+         * @brief Stops profiling and records the phase.
+         ******************************************************************************/
+        ~Scope() noexcept;
+
+        Scope() = delete;                         // No default constructor.
+        Scope(const Scope &) = delete;            // No copy constructor.
+        Scope(Scope &&) = delete;                 // No move constructor.
+        Scope &operator=(const Scope &) = delete; // No copy assignment.
+        Scope &operator=(Scope &&) = delete;      // No move assignment.
+
+      private:
+        KernelProfiler *myProfiler; // The profiler, nullptr if disabled.
+        std::size_t myLayer;        // Index of the profiled layer.
+        KernelPhase myPhase;        // The profiled phase.
+        Snapshot myStart;           // Counter values at the start.
+    };
+
+    /*******************************************************************************
+     * @brief Creates new kernel profiler and opens the counters.
+     *
+     * @param layerCount The number of profiled layers, output layer last.
+     ******************************************************************************/
+    explicit KernelProfiler(const std::size_t layerCount);
+
+    /*******************************************************************************
+     * @brief Deletes the profiler and closes the counters.
+     ******************************************************************************/
+    ~KernelProfiler() noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the number of profiled layers.
+     *
+     * @return The number of layers.
+     ******************************************************************************/
+    std::size_t layerCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Indicates if a hardware counter is available.
+     *
+     * @param counter The counter in question.
+     *
+     * @return True if the counter was opened, else false.
+     ******************************************************************************/
+    bool isAvailable(const KernelCounter counter) const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the reason why hardware counters are unavailable.
+     *
+     * @return The error of the first counter that failed to open, empty if all
+     *         counters were opened.
+     ******************************************************************************/
+    const std::string &unavailableReason() const noexcept;
+
+    /*******************************************************************************
+     * @brief Reads the counters.
+     *
+     * @param snapshot Reference to snapshot to store the values in.
+     ******************************************************************************/
+    void read(Snapshot &snapshot) const noexcept;
+
+    /*******************************************************************************
+     * @brief Records a layer phase from its start snapshot until now.
+     *
+     * @param layer Index of the layer.
+     * @param phase The phase.
+     * @param start Reference to the snapshot read at the start of the phase.
+     ******************************************************************************/
+    void record(const std::size_t layer, const KernelPhase phase, const Snapshot &start) noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the aggregated counts of a layer phase.
+     *
+     * @param layer Index of the layer.
+     * @param phase The phase.
+     *
+     * @return Reference to the totals of the layer phase.
+     ******************************************************************************/
+    const Totals &totals(const std::size_t layer, const KernelPhase phase) const;
+
+    /*******************************************************************************
+     * @brief Clears all aggregated counts.
+     ******************************************************************************/
+    void reset() noexcept;
+
+    /*******************************************************************************
+     * @brief Prints time, IPC and misses per thousand instructions for each layer
+     *        and phase, "-" marking unavailable counters.
+     *
+     * @param ostream Reference to output stream (default = terminal print).
+     ******************************************************************************/
+    void print(std::ostream &ostream = std::cout) const;
+
+    KernelProfiler() = delete;                                  // No default constructor.
+    KernelProfiler(const KernelProfiler &) = delete;            // No copy constructor.
+    KernelProfiler(KernelProfiler &&) = delete;                 // No move constructor.
+    KernelProfiler &operator=(const KernelProfiler &) = delete; // No copy assignment.
+    KernelProfiler &operator=(KernelProfiler &&) = delete;      // No move assignment.
+
+  private:
+    static constexpr auto CounterCount{static_cast<unsigned>(KernelCounter::Count)};
+
+    std::array<int, CounterCount> myFds;             // Descriptor of each counter, -1 if closed.
+    std::array<unsigned, CounterCount> myGroupIndex; // Index of each counter in group reads.
+    int myLeaderFd;                                  // Descriptor of the group leader, -1 if none.
+    unsigned myOpenCount;                            // The number of opened counters.
+    std::string myUnavailableReason;                 // Why counters failed to open.
+    std::vector<Totals> myTotals;                    // Totals of each layer phase.
+};
+
+// -----------------------------------------------------------------------------
+inline KernelProfiler::Scope::Scope(KernelProfiler *profiler, const std::size_t layer,
+                                    const KernelPhase phase) noexcept
+    : myProfiler{profiler}, myLayer{layer}, myPhase{phase}, myStart{} {
+    // Skip reading the counters when disabled.
+    if (myProfiler) { myProfiler->read(myStart); }
+}
+
+// -----------------------------------------------------------------------------
+inline KernelProfiler::Scope::~Scope() noexcept {
+    if (myProfiler) { myProfiler->record(myLayer, myPhase, myStart); }
+}
+
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,152 @@
+/*******************************************************************************
+ * @brief Startup selection of the fastest layer kernels for the host CPU.
+ ******************************************************************************/
+#pragma once
+
+#include <array>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "dense_layer.h"
+#include "kernel_profiler.h"
+
+namespace ml {
+
+/*******************************************************************************
+ * @brief Class implementation of a kernel tuner.
+ *
+ *        For each layer shape, every implementation of each kernel the layer
+ *        supports is timed on a scratch copy of the layer, and the fastest one
+ *        is selected. The winners are cached per CPU model in a small text
+ *        file, so later runs on the same board only look them up. All
+ *        implementations give identical results, so tuning never changes
+ *        what a network learns.
+ *
+ *        Layers are tuned as they are, pruning a layer afterwards selects the
+ *        sparse kernels again (see DenseLayer::prune).
+ *
+ *        This class is non-copyable and non-movable.
+ ******************************************************************************/
+class KernelTuner {
+  public:
+    /*******************************************************************************
+     * @brief Creates new kernel tuner, reading the cache file if it exists.
+     *
+     * @param cachePath Path to the cache file, created when new shapes are tuned.
+     ******************************************************************************/
+    explicit KernelTuner(const std::string &cachePath);
+
+    /*******************************************************************************
+     * @brief Deletes the kernel tuner.
+     ******************************************************************************/
+    ~KernelTuner() noexcept = default;
+
+    /*******************************************************************************
+     * @brief Provides the CPU model of the host, read from /proc/cpuinfo.
+     *
+     * @return The board model if known, else the processor model name.
+     ******************************************************************************/
+    static std::string cpuModel();
+
+    /*******************************************************************************
+     * @brief Provides the number of layer shapes cached for the host CPU.
+     *
+     * @return The number of cached shapes, including shapes tuned since creation.
+     ******************************************************************************/
+    std::size_t cachedShapeCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Selects the fastest kernels of each layer, benchmarking shapes missing
+     *        from the cache and adding them to the cache file.
+     *
+     * @param layers Reference to vector holding pointers to the layers to tune.
+     *
+     * @return The number of layer shapes benchmarked.
+     ******************************************************************************/
+    std::size_t tune(const std::vector<DenseLayer *> &layers);
+
+    /*******************************************************************************
+     * @brief Prints the kernels selected for each layer of the latest tuning.
+     *
+     * @param ostream Reference to output stream (default = terminal print).
+     ******************************************************************************/
+    void print(std::ostream &ostream = std::cout) const;
+
+    KernelTuner() = delete;                               // No default constructor.
+    KernelTuner(const KernelTuner &) = delete;            // No copy constructor.
+    KernelTuner(KernelTuner &&) = delete;                 // No move constructor.
+    KernelTuner &operator=(const KernelTuner &) = delete; // No copy assignment.
+    KernelTuner &operator=(KernelTuner &&) = delete;      // No move assignment.
+
+  private:
+    using Choice = std::array<KernelVariant, static_cast<std::size_t>(KernelPhase::Count)>;
+
+    /*******************************************************************************
+     * @brief Structure holding the shape of a layer, the key of the cache.
+     ******************************************************************************/
+    struct Shape {
+        std::size_t nodeCount;   // The number of nodes.
+        std::size_t weightCount; // The number of weights per node.
+        bool isSparse;           // Indicates if the layer is pruned.
+        std::size_t density;     // Kept weights in tenths, 10 if not pruned.
+
+        /*******************************************************************************
+         * @brief Orders shapes for lookup.
+         *
+         * @param other Reference to the shape to compare with.
+         *
+         * @return True if this shape is ordered before the other shape.
+         ******************************************************************************/
+        bool operator<(const Shape &other) const noexcept;
+    };
+
+    /*******************************************************************************
+     * @brief Structure holding the kernels selected for a layer.
+     ******************************************************************************/
+    struct Selection {
+        Shape shape;      // Shape of the layer.
+        Choice choice;    // The selected kernels.
+        bool benchmarked; // Indicates if the shape was benchmarked, else cached.
+    };
+
+    /*******************************************************************************
+     * @brief Provides the shape of a layer.
+     *
+     * @param layer Reference to the layer in question.
+     *
+     * @return The shape of the layer.
+     ******************************************************************************/
+    static Shape shapeOf(const DenseLayer &layer) noexcept;
+
+    /*******************************************************************************
+     * @brief Times each supported implementation of each kernel on a scratch copy
+     *        of a layer.
+     *
+     * @param layer Reference to the layer to benchmark, left untouched.
+     *
+     * @return The fastest implementation of each kernel.
+     ******************************************************************************/
+    static Choice benchmark(const DenseLayer &layer);
+
+    /*******************************************************************************
+     * @brief Reads the cache file, keeping the entries of other CPU models aside.
+     ******************************************************************************/
+    void load();
+
+    /*******************************************************************************
+     * @brief Writes the cache file through a temporary file.
+     *
+     * @return True if the cache file was written, else false.
+     ******************************************************************************/
+    bool save() const;
+
+    std::string myPath;                    // Path to the cache file.
+    std::string myCpuModel;                // CPU model of the host.
+    std::map<Shape, Choice> myChoices;     // Cached kernels of the host CPU per shape.
+    std::vector<std::string> myOtherLines; // Cache entries of other CPU models.
+    std::vector<Selection> mySelections;   // Kernels selected by the latest tuning.
+};
+
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,121 @@
+/*******************************************************************************
+ * @brief Lock-free latency histogram with HDR-style bucketing.
+ ******************************************************************************/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace ctrl {
+
+/*******************************************************************************
+ * @brief Class implementation of a lock-free latency histogram.
+ *
+ *        Values are stored in log-linear buckets: each power of two is split
+ *        into 16 sub-buckets, giving a relative precision of about 6 % over
+ *        the whole 64-bit range at a fixed memory footprint. Recording is
+ *        wait-free (relaxed atomic increments) and can be done from one
+ *        thread while another reads percentiles.
+ *
+ *        This class is non-copyable and non-movable.
+ ******************************************************************************/
+class LatencyHistogram {
+  public:
+    /*******************************************************************************
+     * @brief Structure holding summary statistics of a histogram.
+     ******************************************************************************/
+    struct Summary {
+        std::uint64_t count; // The number of recorded values.
+        std::uint64_t min;   // The smallest recorded value.
+        std::uint64_t max;   // The largest recorded value.
+        double mean;         // The mean of the recorded values.
+        std::uint64_t p50;   // The 50th percentile (median).
+        std::uint64_t p99;   // The 99th percentile.
+        std::uint64_t p999;  // The 99.9th percentile.
+    };
+
+    /*******************************************************************************
+     * @brief Creates new empty histogram.
+     ******************************************************************************/
+    LatencyHistogram() noexcept;
+
+    /*******************************************************************************
+     * @brief Deletes the histogram.
+     ******************************************************************************/
+    ~LatencyHistogram() noexcept = default;
+
+    /*******************************************************************************
+     * @brief Records a value.
+     *
+     * @param value The value to record, typically a latency in nanoseconds.
+     ******************************************************************************/
+    void record(const std::uint64_t value) noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the number of recorded values.
+     *
+     * @return The number of recorded values.
+     ******************************************************************************/
+    std::uint64_t count() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the value at given percentile.
+     *
+     * @param percentile The percentile in the range 0 - 100.
+     *
+     * @return The highest value equivalent to the percentile bucket, or 0 if
+     *         the histogram is empty.
+     ******************************************************************************/
+    std::uint64_t percentile(const double percentile) const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides summary statistics of the histogram.
+     *
+     * @return The summary statistics.
+     ******************************************************************************/
+    Summary summary() const noexcept;
+
+    /*******************************************************************************
+     * @brief Clears all recorded values.
+     *
+     * @note Values recorded concurrently with the reset may be partially kept.
+     ******************************************************************************/
+    void reset() noexcept;
+
+    LatencyHistogram(const LatencyHistogram &) = delete;            // No copy constructor.
+    LatencyHistogram(LatencyHistogram &&) = delete;                 // No move constructor.
+    LatencyHistogram &operator=(const LatencyHistogram &) = delete; // No copy assignment.
+    LatencyHistogram &operator=(LatencyHistogram &&) = delete;      // No move assignment.
+
+  private:
+    /*******************************************************************************
+     * @brief Provides the bucket index of given value.
+     *
+     * @param value The value whose bucket to find.
+     *
+     * @return The index of the bucket holding the value.
+     ******************************************************************************/
+    static std::size_t bucketIndex(const std::uint64_t value) noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the highest value that maps to given bucket.
+     *
+     * @param index The index of the bucket.
+     *
+     * @return The highest value equivalent to the bucket.
+     ******************************************************************************/
+    static std::uint64_t bucketHighestValue(const std::size_t index) noexcept;
+
+    static constexpr std::size_t LinearBucketCount{32U}; // Values stored exactly (0 - 31).
+    static constexpr std::size_t SubBucketCount{16U};    // Sub-buckets per power of two.
+    static constexpr std::size_t BucketCount{LinearBucketCount + 59U * SubBucketCount};
+
+    std::array<std::atomic<std::uint64_t>, BucketCount> myCounts; // Count per bucket.
+    std::atomic<std::uint64_t> myCount;                            // Total number of values.
+    std::atomic<std::uint64_t> mySum;                              // Sum of all values.
+    std::atomic<std::uint64_t> myMin;                              // Smallest value.
+    std::atomic<std::uint64_t> myMax;                              // Largest value.
+};
+
+} // namespace ctrl
\ No newline at end of file
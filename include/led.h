@@ -5,13 +5,16 @@
 
 #include <cstdint>
 
-struct gpiod_line;
+#include "gpio_backend.h"
 
 namespace rpi {
 
 /********************************************************************************
  * @brief Implementation of Raspberry Pi LED driver.
  *
+ *        The LED caches its output state, so reading the state never touches
+ *        the hardware and writing an unchanged value is skipped.
+ *
  *        This class is non-copyable and non-movable.
  ********************************************************************************/
 class Led {
@@ -21,8 +24,11 @@ class Led {
      *
      * @param pin        Raspberry Pi GPIO pin the LED is connected to.
      * @param startValue Initial value of the LED (default = off).
+     * @param backend    Reference to the GPIO backend to use (default = the
+     *                   default backend).
      ********************************************************************************/
-    Led(const std::uint8_t pin, const bool startValue = false) noexcept;
+    Led(const std::uint8_t pin, const bool startValue = false,
+        gpio::Backend &backend = gpio::defaultBackend()) noexcept;
 
     /********************************************************************************
      * @brief Deletes LED and releases allocated hardware.
@@ -46,7 +52,7 @@ class Led {
     /********************************************************************************
      * @brief Writes output value to enable/disable the LED.
      *
-     * @param value The value to write.
+     * @param value The value to write, ignored if equal to the current state.
      ********************************************************************************/
     void write(const bool value) noexcept;
 
@@ -59,6 +65,9 @@ class Led {
      * @brief Blinks the LED with specified blink speed.
      *
      * @param blinkSpeedMs The blinking speed measured in milliseconds.
+     *
+     * @note The calling thread is blocked for the whole blink speed, use
+     *       rpi::BlinkService to blink without blocking.
      ********************************************************************************/
     void blink(const std::uint16_t blinkSpeedMs) noexcept;
 
@@ -69,7 +78,9 @@ class Led {
     Led &operator=(Led &&) = delete;      // No move assignment.
 
   private:
-    struct gpiod_line *myLine; // Pointer to GPIO line.
+    gpio::Backend &myBackend; // Reference to the GPIO backend.
+    const std::uint8_t myPin; // GPIO pin the LED is connected to.
+    bool myEnabled;           // Last value written to the LED.
 };
 
 } // namespace rpi
\ No newline at end of file
@@ -0,0 +1,181 @@
+/*******************************************************************************
+ * @brief Per-stage latency instrumentation of the sense-predict-actuate loop.
+ ******************************************************************************/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "latency_histogram.h"
+
+namespace ctrl {
+
+/*******************************************************************************
+ * @brief Enum representing the measured stages of the control loop.
+ ******************************************************************************/
+enum class Stage : unsigned {
+    Sense,         // Reading the inputs (GPIO reads).
+    Predict,       // Running the neural network prediction.
+    Actuate,       // Writing the outputs (GPIO writes).
+    Cycle,         // A whole control cycle.
+    EdgeToActuate, // From sensing an input transition to the completed write.
+    Count,         // The number of stages available.
+};
+
+/*******************************************************************************
+ * @brief Provides the name of a given stage.
+ *
+ * @param stage The stage in question.
+ *
+ * @return The name of the stage as a string.
+ ******************************************************************************/
+const char *stageName(const Stage stage);
+
+/*******************************************************************************
+ * @brief Class implementation of a control loop profiler.
+ *
+ *        Each stage is timestamped with the monotonic clock and aggregated in
+ *        a lock-free histogram. A disabled profiler skips reading the clock,
+ *        so instrumentation costs one predictable branch per call. Reports
+ *        can be written periodically and on request (for instance from a
+ *        signal handler) by a background reporter thread.
+ *
+ *        This class is non-copyable and non-movable.
+ ******************************************************************************/
+class LoopProfiler {
+  public:
+    /*******************************************************************************
+     * @brief Creates new loop profiler.
+     *
+     * @param enabled Indicates if the profiler records anything (default = true).
+     ******************************************************************************/
+    explicit LoopProfiler(const bool enabled = true) noexcept;
+
+    /*******************************************************************************
+     * @brief Deletes the profiler, stops the reporter and writes a final report.
+     ******************************************************************************/
+    ~LoopProfiler() noexcept;
+
+    /*******************************************************************************
+     * @brief Indicates if the profiler is enabled.
+     *
+     * @return True if the profiler is enabled, else false.
+     ******************************************************************************/
+    bool isEnabled() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides a timestamp for use with record.
+     *
+     * @return Monotonic timestamp in nanoseconds, or 0 if disabled.
+     ******************************************************************************/
+    std::uint64_t now() const noexcept;
+
+    /*******************************************************************************
+     * @brief Records the latency of a stage.
+     *
+     * @param stage   The measured stage.
+     * @param startNs Timestamp at the start of the stage.
+     * @param endNs   Timestamp at the end of the stage.
+     ******************************************************************************/
+    void record(const Stage stage, const std::uint64_t startNs, const std::uint64_t endNs) noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the histogram of a stage.
+     *
+     * @param stage The stage in question.
+     *
+     * @return Reference to the histogram of the stage.
+     ******************************************************************************/
+    const LatencyHistogram &histogram(const Stage stage) const;
+
+    /*******************************************************************************
+     * @brief Prints a report with p50/p99/p999/max per stage in microseconds.
+     *
+     * @param ostream Reference to output stream (default = terminal print).
+     ******************************************************************************/
+    void print(std::ostream &ostream = std::cout) const;
+
+    /*******************************************************************************
+     * @brief Writes the report to a file, replacing it atomically.
+     *
+     * @param path Path to the report file.
+     *
+     * @return True if the report was written, else false.
+     ******************************************************************************/
+    bool dump(const std::string &path) const;
+
+    /*******************************************************************************
+     * @brief Starts a background thread dumping the report to a file.
+     *
+     * @param path     Path to the report file.
+     * @param interval Time between periodic dumps, 0 to dump on request only.
+     ******************************************************************************/
+    void startReporter(const std::string &path, const std::chrono::milliseconds interval);
+
+    /*******************************************************************************
+     * @brief Requests the reporter to dump the report as soon as possible.
+     *
+     * @note This function is async-signal-safe.
+     ******************************************************************************/
+    static void requestDump() noexcept;
+
+    /*******************************************************************************
+     * @brief Installs a signal handler that requests a report dump.
+     *
+     * @param signal The signal to handle (default = SIGUSR1).
+     *
+     * @return True if the handler was installed, else false.
+     ******************************************************************************/
+    static bool installDumpSignal(const int signal = SIGUSR1);
+
+    LoopProfiler(const LoopProfiler &) = delete;            // No copy constructor.
+    LoopProfiler(LoopProfiler &&) = delete;                 // No move constructor.
+    LoopProfiler &operator=(const LoopProfiler &) = delete; // No copy assignment.
+    LoopProfiler &operator=(LoopProfiler &&) = delete;      // No move assignment.
+
+  private:
+    /*******************************************************************************
+     * @brief Runs the reporter thread until the profiler is deleted.
+     ******************************************************************************/
+    void runReporter();
+
+    static std::atomic<bool> myDumpRequested; // Indicates if a dump is requested.
+
+    const bool myEnabled;                 // Indicates if the profiler records anything.
+    std::array<LatencyHistogram, static_cast<unsigned>(Stage::Count)>
+        myHistograms;                     // Latency histogram of each stage.
+    std::string myReportPath;             // Path to the report file.
+    std::chrono::milliseconds myInterval; // Time between periodic dumps.
+    std::mutex myMutex;                   // Mutex protecting the reporter state.
+    std::condition_variable myCondition;  // Wakes the reporter on shutdown.
+    bool myStopReporter;                  // Indicates if the reporter shall stop.
+    std::thread myReporter;               // Background reporter thread.
+};
+
+// -----------------------------------------------------------------------------
+inline bool LoopProfiler::isEnabled() const noexcept { return myEnabled; }
+
+// -----------------------------------------------------------------------------
+inline std::uint64_t LoopProfiler::now() const noexcept {
+    // Skip reading the clock when disabled.
+    if (!myEnabled) { return 0U; }
+    const auto time{std::chrono::steady_clock::now().time_since_epoch()};
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+}
+
+// -----------------------------------------------------------------------------
+inline void LoopProfiler::record(const Stage stage, const std::uint64_t startNs,
+                                 const std::uint64_t endNs) noexcept {
+    if (!myEnabled) { return; }
+    myHistograms[static_cast<unsigned>(stage)].record(endNs - startNs);
+}
+
+} // namespace ctrl
\ No newline at end of file
@@ -0,0 +1,59 @@
+/*******************************************************************************
+ * @brief Loss functions for training neural networks.
+ ******************************************************************************/
+#pragma once
+
+#include <cstddef>
+
+#include "act_func.h"
+
+namespace ml {
+
+/*******************************************************************************
+ * @brief Enum representing the loss functions available for output layers.
+ ******************************************************************************/
+enum class Loss : unsigned {
+    SquaredError, // Squared error, for any output activation function.
+    CrossEntropy, // Cross-entropy, for sigmoid or softmax outputs only.
+    Count,        // The number of loss functions available.
+};
+
+/*******************************************************************************
+ * @brief Indicates if a loss function can be used with the given output
+ *        activation function.
+ *
+ *        Cross-entropy requires sigmoid outputs (binary or multi-label) or
+ *        softmax outputs (multi-class), while softmax outputs require
+ *        cross-entropy.
+ *
+ * @param loss    The loss function in question.
+ * @param actFunc Activation function of the output layer.
+ *
+ * @return True if the combination is supported, else false.
+ ******************************************************************************/
+bool isLossSupported(const Loss loss, const ActFunc actFunc);
+
+/*******************************************************************************
+ * @brief Provides the loss of an output compared to its reference values.
+ *
+ * @param loss       The loss function to use for the calculation.
+ * @param actFunc    Activation function of the output layer.
+ * @param outputs    Pointer to array holding the output values.
+ * @param references Pointer to array holding the reference values.
+ * @param count      The number of values in the arrays.
+ *
+ * @return The loss summed over all values.
+ ******************************************************************************/
+double lossValue(const Loss loss, const ActFunc actFunc, const double *outputs,
+                 const double *references, const std::size_t count);
+
+/*******************************************************************************
+ * @brief Provides the name of a given loss function.
+ *
+ * @param loss The loss function in question.
+ *
+ * @return The name of the loss function as a string.
+ ******************************************************************************/
+const char *lossName(const Loss loss);
+
+} // namespace ml
\ No newline at end of file
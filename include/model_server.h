@@ -0,0 +1,152 @@
+/*******************************************************************************
+ * @brief Serving of neural networks with background training and hot-swap.
+ ******************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "neural_network.h"
+
+namespace ml {
+
+/*******************************************************************************
+ * @brief Class implementation of a model server.
+ *
+ *        The serving thread predicts with the latest published network via
+ *        an atomic pointer, without locks, while a background thread trains
+ *        a new network and publishes it atomically when done. Networks are
+ *        frozen into immutable inference models when published; old models
+ *        are reclaimed once the serving thread has moved on to a newer one
+ *        (hazard pointer).
+ *
+ *        Prediction must be performed from a single serving thread, while
+ *        publishing may be done from any thread.
+ *
+ *        This class is non-copyable and non-movable.
+ ******************************************************************************/
+class ModelServer {
+  public:
+    /*******************************************************************************
+     * @brief Function creating and training a network, returns a null pointer
+     *        or throws if training failed.
+     ******************************************************************************/
+    using TrainJob = std::function<std::unique_ptr<NeuralNetwork>()>;
+
+    /*******************************************************************************
+     * @brief Creates new model server without any published network.
+     ******************************************************************************/
+    ModelServer() noexcept;
+
+    /*******************************************************************************
+     * @brief Deletes the model server, waits for ongoing training to finish.
+     ******************************************************************************/
+    ~ModelServer() noexcept;
+
+    /*******************************************************************************
+     * @brief Starts training in a background thread, the resulting network is
+     *        published when the job returns. Exceptions thrown by the job are
+     *        reported and the current network stays published.
+     *
+     * @param job The training job to run.
+     *
+     * @return True if training was started, false if a job is already running.
+     ******************************************************************************/
+    bool startTraining(TrainJob job);
+
+    /*******************************************************************************
+     * @brief Indicates if a training job is running.
+     *
+     * @return True if training is in progress, else false.
+     ******************************************************************************/
+    bool isTraining() const noexcept;
+
+    /*******************************************************************************
+     * @brief Publishes a trained network, replacing the current one.
+     *
+     * @param network The network to publish, ignored if null. Only its frozen
+     *                inference model is kept.
+     ******************************************************************************/
+    void publish(std::unique_ptr<NeuralNetwork> network);
+
+    /*******************************************************************************
+     * @brief Performs prediction with the latest published network.
+     *
+     * @param input Reference to vector holding the input for which to predict.
+     *
+     * @return Pointer to vector holding the predicted output, valid until the
+     *         next prediction, or a null pointer if no network is published.
+     ******************************************************************************/
+    const std::vector<double> *predict(const std::vector<double> &input);
+
+    /*******************************************************************************
+     * @brief Provides the version of the latest published network.
+     *
+     * @return The number of networks published so far.
+     ******************************************************************************/
+    std::uint64_t version() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the duration of the last training job.
+     *
+     * @return The training time in nanoseconds.
+     ******************************************************************************/
+    std::uint64_t lastTrainingTimeNs() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the time from the last publish until the serving thread
+     *        first predicted with the new network.
+     *
+     * @return The swap latency in nanoseconds.
+     ******************************************************************************/
+    std::uint64_t lastSwapLatencyNs() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the largest swap latency observed.
+     *
+     * @return The maximum swap latency in nanoseconds.
+     ******************************************************************************/
+    std::uint64_t maxSwapLatencyNs() const noexcept;
+
+    ModelServer(const ModelServer &) = delete;            // No copy constructor.
+    ModelServer(ModelServer &&) = delete;                 // No move constructor.
+    ModelServer &operator=(const ModelServer &) = delete; // No copy assignment.
+    ModelServer &operator=(ModelServer &&) = delete;      // No move assignment.
+
+  private:
+    /*******************************************************************************
+     * @brief Structure holding a published network.
+     ******************************************************************************/
+    struct Snapshot {
+        InferenceModel model;        // The published model.
+        std::uint64_t version;       // Version of the model.
+        std::uint64_t publishTimeNs; // Monotonic time of publication.
+    };
+
+    /*******************************************************************************
+     * @brief Deletes retired snapshots no longer used by the serving thread.
+     *
+     * @note The publish mutex must be held by the caller.
+     ******************************************************************************/
+    void reclaim();
+
+    std::atomic<Snapshot *> myCurrent;             // The latest published snapshot.
+    std::atomic<Snapshot *> myHazard;              // Snapshot used by the serving thread.
+    std::vector<Snapshot *> myRetired;             // Replaced snapshots awaiting deletion.
+    std::mutex myPublishMutex;                     // Serializes publishers.
+    std::uint64_t myServedVersion;                 // Version last used for prediction.
+    InferenceModel::Scratch myScratch;             // Scratch of the serving thread.
+    std::atomic<std::uint64_t> myVersion;          // Version of the latest snapshot.
+    std::atomic<std::uint64_t> myTrainingTimeNs;   // Duration of the last training job.
+    std::atomic<std::uint64_t> mySwapLatencyNs;    // Last observed swap latency.
+    std::atomic<std::uint64_t> myMaxSwapLatencyNs; // Largest observed swap latency.
+    std::atomic<bool> myTraining;                  // Indicates if a job is running.
+    std::thread myTrainer;                         // Background training thread.
+};
+
+} // namespace ml
\ No newline at end of file
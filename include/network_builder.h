@@ -0,0 +1,145 @@
+/*******************************************************************************
+ * @brief Builder for neural networks with individually shaped layers.
+ ******************************************************************************/
+#pragma once
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "act_func.h"
+#include "loss.h"
+#include "neural_network.h"
+
+namespace ml {
+
+/*******************************************************************************
+ * @brief Class implementation of a neural network builder.
+ *
+ *        Each hidden layer is given its own node count and activation function,
+ *        so every layer can be sized to what it needs. The cost of the
+ *        configuration can be inspected before the network is built.
+ ******************************************************************************/
+class NetworkBuilder {
+  public:
+    /*******************************************************************************
+     * @brief Structure holding the cost of a single layer.
+     ******************************************************************************/
+    struct LayerCost {
+        std::size_t nodeCount;      // The number of nodes in the layer.
+        std::size_t weightCount;    // The number of weights per node.
+        ActFunc actFunc;            // Activation function of the layer.
+        std::size_t parameterCount; // The number of biases and weights.
+        std::size_t parameterBytes; // Parameter memory in bytes.
+        std::size_t flopCount;      // Floating point operations per prediction.
+    };
+
+    /*******************************************************************************
+     * @brief Structure holding the cost of a network configuration.
+     *
+     *        Every weight costs one multiplication and one addition per
+     *        prediction, every activation is counted as one operation.
+     ******************************************************************************/
+    struct Cost {
+        std::vector<LayerCost> layers; // Cost of each layer, output layer last.
+        std::size_t parameterCount;    // The total number of biases and weights.
+        std::size_t parameterBytes;    // The total parameter memory in bytes.
+        std::size_t flopCount;         // Floating point operations per prediction.
+
+        /*******************************************************************************
+         * @brief Prints the cost of each layer and the total cost.
+         *
+         * @param ostream Reference to output stream (default = terminal print).
+         ******************************************************************************/
+        void print(std::ostream &ostream = std::cout) const;
+    };
+
+    /*******************************************************************************
+     * @brief Creates new network builder.
+     *
+     * @param inputCount The number of inputs in the network.
+     ******************************************************************************/
+    explicit NetworkBuilder(const std::size_t inputCount);
+
+    /*******************************************************************************
+     * @brief Deletes the network builder.
+     ******************************************************************************/
+    ~NetworkBuilder() noexcept = default;
+
+    /*******************************************************************************
+     * @brief Appends a hidden layer after the previously added ones.
+     *
+     * @param nodeCount The number of nodes in the layer.
+     * @param actFunc   Activation function of the layer (default = ReLU).
+     *
+     * @return Reference to the builder.
+     ******************************************************************************/
+    NetworkBuilder &addHiddenLayer(const std::size_t nodeCount,
+                                   const ActFunc actFunc = ActFunc::Relu);
+
+    /*******************************************************************************
+     * @brief Sets the output layer.
+     *
+     * @param nodeCount The number of outputs in the network.
+     * @param actFunc   Activation function of the layer (default = linear).
+     *
+     * @return Reference to the builder.
+     ******************************************************************************/
+    NetworkBuilder &setOutputLayer(const std::size_t nodeCount,
+                                   const ActFunc actFunc = ActFunc::Linear);
+
+    /*******************************************************************************
+     * @brief Sets the loss function minimized during training.
+     *
+     *        Use cross-entropy with a sigmoid output layer for binary or
+     *        multi-label outputs, or with a softmax output layer for
+     *        multi-class outputs.
+     *
+     * @param loss The loss function (default = squared error).
+     *
+     * @return Reference to the builder.
+     ******************************************************************************/
+    NetworkBuilder &setLoss(const Loss loss);
+
+    /*******************************************************************************
+     * @brief Provides the number of inputs in the network.
+     *
+     * @return The number of inputs in the network.
+     ******************************************************************************/
+    std::size_t inputCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the number of hidden layers added so far.
+     *
+     * @return The number of hidden layers.
+     ******************************************************************************/
+    std::size_t hiddenLayerCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Calculates the cost of the configuration.
+     *
+     * @return The cost of each layer and of the whole network.
+     ******************************************************************************/
+    Cost cost() const;
+
+    /*******************************************************************************
+     * @brief Builds a neural network with the configured layers.
+     *
+     * @return Pointer to the new network.
+     ******************************************************************************/
+    std::unique_ptr<NeuralNetwork> build() const;
+
+  private:
+    /*******************************************************************************
+     * @brief Checks that the output layer is set before the network is used.
+     ******************************************************************************/
+    void checkComplete() const;
+
+    std::size_t myInputCount;                             // The number of inputs.
+    std::vector<NeuralNetwork::LayerSpec> myHiddenLayers; // Shape of each hidden layer.
+    NeuralNetwork::LayerSpec myOutputLayer;               // Shape of the output layer.
+    bool myOutputLayerSet;                                // Indicates if the output layer is set.
+    Loss myLoss;                                          // Loss minimized during training.
+};
+
+} // namespace ml
\ No newline at end of file
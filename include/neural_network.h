@@ -3,21 +3,99 @@
  ******************************************************************************/
 #pragma once
 
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "act_func.h"
+#include "arena.h"
+#include "checkpoint_writer.h"
 #include "dense_layer.h"
+#include "inference_model.h"
+#include "kernel_profiler.h"
+#include "kernel_tuner.h"
+#include "loss.h"
+#include "pipeline_trainer.h"
+#include "replay_buffer.h"
 
 namespace ml {
 
 /*******************************************************************************
  * @brief Class implementation of a neural network.
  *
- *        This class is non-copyable and non-movable.
+ *        The parameters of all layers live in one aligned block and their
+ *        outputs and errors in another, both planned once at construction.
+ *        The output layer is placed last in each block.
+ *
+ *        This class is movable but not copyable, use clone() to duplicate a
+ *        network. A moved-from network may only be assigned to or destroyed.
  ******************************************************************************/
 class NeuralNetwork {
   public:
+    /*******************************************************************************
+     * @brief Enumeration class representing the scope of magnitude pruning.
+     ******************************************************************************/
+    enum class PruneScope {
+        Global,   // One magnitude threshold for all layers.
+        PerLayer, // A magnitude threshold per layer.
+    };
+
+    /*******************************************************************************
+     * @brief Structure holding the result of pruning.
+     ******************************************************************************/
+    struct PruneReport {
+        std::size_t weightCount;  // The total number of weights.
+        std::size_t nonZeroCount; // The number of weights left after pruning.
+        double sparsity;          // The fraction of weights removed.
+        std::size_t denseBytes;   // Parameter memory before pruning.
+        std::size_t sparseBytes;  // Parameter memory after pruning (CSR).
+        double errorBefore;       // Mean squared error on training sets before pruning.
+        double errorAfter;        // Mean squared error after pruning and fine-tuning.
+        double accuracyBefore;    // Fraction of correct outputs before pruning.
+        double accuracyAfter;     // Fraction of correct outputs after pruning and fine-tuning.
+
+        /*******************************************************************************
+         * @brief Prints the report.
+         *
+         * @param ostream Reference to output stream (default = terminal print).
+         ******************************************************************************/
+        void print(std::ostream &ostream = std::cout) const;
+    };
+
+    /*******************************************************************************
+     * @brief Structure holding the metrics of an evaluation.
+     *
+     *        The decision of a set is the largest output for multi-output
+     *        networks, else whether the output reaches the threshold.
+     ******************************************************************************/
+    struct Evaluation {
+        std::size_t sampleCount;            // The number of evaluated sets.
+        double meanSquaredError;            // Mean squared error of all outputs.
+        double maxAbsoluteError;            // The largest absolute output error.
+        std::size_t worstSample;            // Index of the set with the largest error.
+        double threshold;                   // Decision threshold of single outputs.
+        double accuracy;                    // Fraction of sets with the reference decision.
+        std::size_t classCount;             // The number of decisions.
+        std::vector<std::size_t> confusion; // Sets per reference (row) and predicted decision.
+
+        /*******************************************************************************
+         * @brief Prints the report.
+         *
+         * @param ostream Reference to output stream (default = terminal print).
+         ******************************************************************************/
+        void print(std::ostream &ostream = std::cout) const;
+    };
+
+    /*******************************************************************************
+     * @brief Structure holding the shape of a layer.
+     ******************************************************************************/
+    struct LayerSpec {
+        std::size_t nodeCount; // The number of nodes in the layer.
+        ActFunc actFunc;       // Activation function of the layer.
+    };
+
     /*******************************************************************************
      * @brief Creates a neural network.
      *
@@ -33,11 +111,65 @@ class NeuralNetwork {
                            const ActFunc actFuncHidden = ActFunc::Relu,
                            const ActFunc actFuncOutput = ActFunc::Relu);
 
+    /*******************************************************************************
+     * @brief Creates a neural network with individually sized hidden layers.
+     *
+     *        See ml::NetworkBuilder for a more convenient way to describe the
+     *        layers.
+     *
+     * @param inputCount   The number of inputs in the network.
+     * @param hiddenLayers Reference to vector holding the shape of each hidden
+     *                     layer, first layer first. May be empty.
+     * @param outputLayer  Reference to the shape of the output layer.
+     * @param loss         The loss function minimized during training, must be
+     *                     supported by the output activation function
+     *                     (default = squared error).
+     ******************************************************************************/
+    NeuralNetwork(const std::size_t inputCount, const std::vector<LayerSpec> &hiddenLayers,
+                  const LayerSpec &outputLayer, const Loss loss = Loss::SquaredError);
+
     /*******************************************************************************
      * @brief Deletes neural network.
      ******************************************************************************/
     ~NeuralNetwork() noexcept = default;
 
+    /*******************************************************************************
+     * @brief Creates new neural network taking over another network.
+     *
+     * @param other Reference to the network to move.
+     ******************************************************************************/
+    NeuralNetwork(NeuralNetwork &&other) noexcept;
+
+    /*******************************************************************************
+     * @brief Takes over another network.
+     *
+     * @param other Reference to the network to move.
+     *
+     * @return Reference to this network.
+     ******************************************************************************/
+    NeuralNetwork &operator=(NeuralNetwork &&other) noexcept;
+
+    /*******************************************************************************
+     * @brief Creates a clone of the network sharing its parameters copy-on-write.
+     *
+     *        The clone gets its own outputs and errors, so clones can predict in
+     *        different threads. The parameters are copied by whichever network
+     *        first changes them, by training, pruning or restoring, so the
+     *        other networks are never affected. Training data is shared as
+     *        well, replay memory is copied. Profiler and checkpoint writer are
+     *        not attached to the clone.
+     *
+     * @return The clone.
+     ******************************************************************************/
+    NeuralNetwork clone() const;
+
+    /*******************************************************************************
+     * @brief Indicates if the parameters are currently shared with a clone.
+     *
+     * @return True if another network uses the same parameter arena, else false.
+     ******************************************************************************/
+    bool sharesParameters() const noexcept;
+
     /*******************************************************************************
      * @brief Provides the number of input of the network.
      *
@@ -52,6 +184,13 @@ class NeuralNetwork {
      ******************************************************************************/
     std::size_t outputCount() const noexcept;
 
+    /*******************************************************************************
+     * @brief Provides the loss function minimized during training.
+     *
+     * @return The loss function of the network.
+     ******************************************************************************/
+    Loss loss() const noexcept;
+
     /*******************************************************************************
      * @brief Provides the number of stored training sets.
      *
@@ -59,6 +198,14 @@ class NeuralNetwork {
      ******************************************************************************/
     std::size_t trainingSetCount() const noexcept;
 
+    /*******************************************************************************
+     * @brief Provides the number of epochs trained, including epochs restored
+     *        from a checkpoint.
+     *
+     * @return The number of epochs trained.
+     ******************************************************************************/
+    std::size_t epochCount() const noexcept;
+
     /*******************************************************************************
      * @brief Trains the neural network with given parameters.
      *
@@ -69,6 +216,36 @@ class NeuralNetwork {
      ******************************************************************************/
     bool train(const std::size_t epochCount, const double learningRate = 0.01);
 
+    /*******************************************************************************
+     * @brief Trains the neural network with the layers split into stages run by
+     *        separate threads, streaming micro-batches through them.
+     *
+     *        The updates of each batch of micro-batches are summed and applied
+     *        at the end of the batch (see ml::PipelineTrainer), so the result
+     *        doesn't depend on the number of stages, and with one micro-batch
+     *        per batch equals train. The kernel profiler isn't used.
+     *
+     * @param epochCount      The number of epochs for which to perform training.
+     * @param learningRate    The learning rate used for optimization.
+     * @param stageCount      The number of stages, at most one per layer.
+     * @param microBatchCount The number of micro-batches per batch, the number
+     *                        of training sets in flight at once (default = 4).
+     *
+     * @return True if training was performed, otherwise false.
+     ******************************************************************************/
+    bool trainPipelined(const std::size_t epochCount, const double learningRate,
+                        const std::size_t stageCount, const std::size_t microBatchCount = 4U);
+
+    /*******************************************************************************
+     * @brief Measures the error on the stored training sets.
+     *
+     * @param accuracy Reference to variable set to the fraction of outputs
+     *                 within 0.5 of their reference values.
+     *
+     * @return The mean squared error.
+     ******************************************************************************/
+    double trainingError(double &accuracy);
+
     /*******************************************************************************
      * @brief Performs prediction with given input.
      *
@@ -78,6 +255,17 @@ class NeuralNetwork {
      ******************************************************************************/
     const std::vector<double> &predict(const std::vector<double> &input);
 
+    /*******************************************************************************
+     * @brief Creates an immutable inference model holding only the biases,
+     *        weights and activation functions of the network.
+     *
+     *        Unlike predict, the prediction of the model is const and reentrant,
+     *        so one model can be shared by any number of threads.
+     *
+     * @return The inference model.
+     ******************************************************************************/
+    InferenceModel freeze() const;
+
     /*******************************************************************************
      * @brief Adds training data.
      *
@@ -90,45 +278,256 @@ class NeuralNetwork {
                          const std::vector<std::vector<double>> &output);
 
     /*******************************************************************************
-     * @brief Prints training result in the terminal.
+     * @brief Allocates replay memory for online learning.
+     *
+     *        Previously stored samples are discarded.
      *
-     * @param printSource Reference to print source (default = terminal print).
+     * @param capacity The maximum number of samples kept, the oldest sample is
+     *                 overwritten when full.
      ******************************************************************************/
-    void printResults(std::ostream &printSource = std::cout);
+    void setReplayCapacity(const std::size_t capacity);
+
+    /*******************************************************************************
+     * @brief Provides the number of samples stored in replay memory.
+     *
+     * @return The number of stored samples.
+     ******************************************************************************/
+    std::size_t replaySampleCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Adds labelled sample to replay memory for online learning.
+     *
+     * @param input  Reference to vector holding the input of the sample.
+     * @param output Reference to vector holding the output of the sample.
+     *
+     * @return True if the sample was added, false if replay memory is not
+     *         allocated or the sample doesn't match the network.
+     ******************************************************************************/
+    bool addSample(const std::vector<double> &input, const std::vector<double> &output);
+
+    /*******************************************************************************
+     * @brief Performs a budgeted number of SGD steps on samples drawn from
+     *        replay memory, for a predictable cost per control cycle.
+     *
+     * @param stepCount    The number of SGD steps to perform.
+     * @param learningRate The learning rate used for optimization (default = 1 %).
+     *
+     * @return The number of steps performed, 0 if replay memory is empty.
+     ******************************************************************************/
+    std::size_t learnOnline(const std::size_t stepCount, const double learningRate = 0.01);
+
+    /*******************************************************************************
+     * @brief Prunes the weights with the smallest magnitude and switches the
+     *        pruned layers to sparse (CSR) inference kernels.
+     *
+     *        An output is counted as correct if it is within 0.5 of its
+     *        reference value.
+     *
+     * @param fraction           The fraction of weights to remove, 0.0 - 1.0.
+     * @param scope              Indicates if the magnitude threshold is shared
+     *                           by all layers or set per layer (default = global).
+     * @param fineTuneEpochCount The number of epochs to train the remaining
+     *                           weights after pruning (default = none).
+     * @param learningRate       The learning rate used for fine-tuning (default = 1 %).
+     *
+     * @return Report holding the sparsity, memory saved and accuracy change.
+     ******************************************************************************/
+    PruneReport prune(const double fraction, const PruneScope scope = PruneScope::Global,
+                      const std::size_t fineTuneEpochCount = 0U, const double learningRate = 0.01);
+
+    /*******************************************************************************
+     * @brief Provides the parameters of all layers, e.g. to take a snapshot by
+     *        copying the arena.
+     *
+     *        The bias and weights of the hidden layers come first, in order,
+     *        followed by those of the output layer. The weights of pruned
+     *        layers are kept in sync with their sparse weights.
+     *
+     * @return Reference to the parameter arena.
+     ******************************************************************************/
+    const Arena &parameters() const noexcept;
+
+    /*******************************************************************************
+     * @brief Restores the parameters from a snapshot taken with parameters().
+     *
+     *        Pruned layers keep their non-zero pattern, weights pruned since the
+     *        snapshot stay zero.
+     *
+     * @param snapshot Reference to the snapshot, must match the network.
+     ******************************************************************************/
+    void restoreParameters(const Arena &snapshot);
+
+    /*******************************************************************************
+     * @brief Provides the memory used by the outputs and errors of all layers.
+     *
+     * @return The number of bytes allocated for activations.
+     ******************************************************************************/
+    std::size_t activationBytes() const noexcept;
+
+    /*******************************************************************************
+     * @brief Sets the profiler recording the kernels of each layer, hidden layers
+     *        first and output layer last.
+     *
+     * @param profiler Pointer to the profiler, nullptr to stop profiling. The
+     *                 profiler must outlive its use by the network.
+     ******************************************************************************/
+    void setProfiler(KernelProfiler *profiler);
+
+    /*******************************************************************************
+     * @brief Selects the fastest kernels of each layer for the host CPU, see
+     *        ml::KernelTuner. Results are unaffected. Tune after pruning.
+     *
+     * @param tuner Reference to the tuner holding the cached selections.
+     *
+     * @return The number of layer shapes benchmarked, 0 if all were cached.
+     ******************************************************************************/
+    std::size_t tuneKernels(KernelTuner &tuner);
+
+    /*******************************************************************************
+     * @brief Sets the writer taking checkpoints during training.
+     *
+     *        When a checkpoint is due, and at the end of each call to train, the
+     *        parameters, epoch count and random generator state are serialized
+     *        into the staging buffer of the writer, which writes them in the
+     *        background.
+     *
+     * @param writer Pointer to the writer, nullptr to stop checkpointing. The
+     *               writer must outlive its use by the network.
+     ******************************************************************************/
+    void setCheckpointWriter(CheckpointWriter *writer) noexcept;
+
+    /*******************************************************************************
+     * @brief Serializes the parameters, epoch count and the state of the random
+     *        generator of the calling thread.
+     *
+     * @param buffer Reference to buffer to serialize into, replacing its content.
+     ******************************************************************************/
+    void saveCheckpoint(std::vector<std::uint8_t> &buffer) const;
+
+    /*******************************************************************************
+     * @brief Restores the network from a checkpoint file, after which training
+     *        continues exactly as if it had not been interrupted.
+     *
+     *        The random generator of the calling thread is restored as well.
+     *        Training data and replay memory are not part of the checkpoint.
+     *
+     * @param path Path to the checkpoint file.
+     *
+     * @return True if the checkpoint was restored, false if the file can't be
+     *         read. An exception is thrown if the checkpoint is invalid or
+     *         doesn't match the shape of the network.
+     ******************************************************************************/
+    bool restoreCheckpoint(const std::string &path);
+
+    /*******************************************************************************
+     * @brief Evaluates the network on a data set, feeding the sets through the
+     *        layers in batches.
+     *
+     * @param input     Reference to vector holding the input sets.
+     * @param output    Reference to vector holding the reference output sets.
+     * @param threshold Decision threshold of single-output networks (default = 0.5).
+     *
+     * @return The metrics of the evaluation. An exception is thrown if the data
+     *         doesn't match the shape of the network.
+     ******************************************************************************/
+    Evaluation evaluate(const std::vector<std::vector<double>> &input,
+                        const std::vector<std::vector<double>> &output,
+                        const double threshold = 0.5) const;
 
     NeuralNetwork() = delete;                                 // No default constructor.
-    NeuralNetwork(const NeuralNetwork &) = delete;            // No copy constructor.
-    NeuralNetwork(NeuralNetwork &&) = delete;                 // No move constructor.
     NeuralNetwork &operator=(const NeuralNetwork &) = delete; // No copy assignment.
-    NeuralNetwork &operator=(NeuralNetwork &&) = delete;      // No move assignment.
 
   private:
     /*******************************************************************************
-     * @brief Performs feedforward operation.
+     * @brief Training or reference sets, one vector per set.
+     ******************************************************************************/
+    using DataSets = std::vector<std::vector<double>>;
+
+    /*******************************************************************************
+     * @brief Creates a clone of another network, see clone().
      *
-     * @param input Reference to the input used for the operation.
+     * @param source Reference to the network to clone.
+     ******************************************************************************/
+    NeuralNetwork(const NeuralNetwork &source);
+
+    /*******************************************************************************
+     * @brief Gives the network its own copy of the parameters if they are shared
+     *        with a clone, must be called before the parameters are changed.
+     ******************************************************************************/
+    void ownParameters();
+
+    /*******************************************************************************
+     * @brief Serializes a checkpoint into the writer and submits it.
+     ******************************************************************************/
+    void submitCheckpoint();
+
+    /*******************************************************************************
+     * @brief Points each layer at its place in the arenas, hidden layers first.
+     ******************************************************************************/
+    void placeLayers() noexcept;
+
+    /*******************************************************************************
+     * @brief Structure holding one kernel invocation of the execution plan.
      ******************************************************************************/
-    void feedforward(const std::vector<double> &input);
+    struct Step {
+        KernelPhase kernel;          // The kernel to run.
+        std::size_t layerIndex;      // Index of the layer, output layer last.
+        DenseLayer *layer;           // The layer running the kernel.
+        const DenseLayer *nextLayer; // Next layer when backpropagating a hidden layer.
+        const double *input;         // Input of the layer, nullptr for the network input.
+    };
 
     /*******************************************************************************
-     * @brief Performs backpropagation.
+     * @brief Validates the layers and builds the execution plan of one training
+     *        set: feedforward through all layers, backpropagation from the
+     *        output layer back and optimization of all layers.
+     ******************************************************************************/
+    void buildPlan();
+
+    /*******************************************************************************
+     * @brief Points the steps of the execution plan at the current layers and
+     *        their outputs, after the layers were moved or placed.
+     ******************************************************************************/
+    void resolvePlan() noexcept;
+
+    /*******************************************************************************
+     * @brief Runs the first steps of the execution plan without checks.
      *
-     * @param output Reference to the output containing reference values.
+     * @param stepCount    The number of steps to run, the layer count for
+     *                     feedforward only.
+     * @param input        Pointer to the inputCount inputs of the network.
+     * @param reference    Pointer to the outputCount reference values, may be
+     *                     nullptr when only feeding forward.
+     * @param learningRate Learning rate to use for optimization.
+     ******************************************************************************/
+    void execute(const std::size_t stepCount, const double *input, const double *reference,
+                 const double learningRate) noexcept;
+
+    /*******************************************************************************
+     * @brief Throws an exception unless each training set matches the network.
      ******************************************************************************/
-    void backpropagate(const std::vector<double> &output);
+    void validateTrainingData() const;
 
     /*******************************************************************************
-     * @brief Performs optimization.
+     * @brief Provides pointers to all layers, output layer last.
      *
-     * @param input        Reference to the input used for the operation.
-     * @param learningRate Learning rate to use for the optimization.
+     * @return Vector holding pointers to the layers.
      ******************************************************************************/
-    void optimize(const std::vector<double> &output, const double learningRate);
+    std::vector<DenseLayer *> layers();
 
-    std::vector<DenseLayer> myHiddenLayers;            // The network's hidden layers.
-    DenseLayer myOutputLayer;                          // Output layer of the network.
-    std::vector<std::vector<double>> myTrainingInput;  // Training input sets.
-    std::vector<std::vector<double>> myTrainingOutput; // Training output sets.
+    std::shared_ptr<Arena> myParameters;              // Bias and weights, shared with clones.
+    Arena myActivations;                              // Outputs and errors of all layers.
+    std::vector<DenseLayer> myHiddenLayers;           // The network's hidden layers.
+    DenseLayer myOutputLayer;                         // Output layer of the network.
+    std::vector<Step> myPlan;                         // Kernel invocations of one training set.
+    std::vector<double> myPrediction;                 // Output of the latest prediction.
+    std::shared_ptr<const DataSets> myTrainingInput;  // Training input sets, shared.
+    std::shared_ptr<const DataSets> myTrainingOutput; // Training output sets, shared.
+    std::unique_ptr<ReplayBuffer> myReplayBuffer;     // Replay memory for online learning.
+    Loss myLoss;                                      // Loss minimized during training.
+    KernelProfiler *myProfiler;                       // Kernel profiler, nullptr if disabled.
+    CheckpointWriter *myCheckpointWriter;             // Checkpoint writer, nullptr if disabled.
+    std::size_t myEpochCount;                         // The number of epochs trained.
 };
 
 } // namespace ml
\ No newline at end of file
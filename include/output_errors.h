@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * @brief Error statistics of predicted outputs compared to reference outputs.
+ ******************************************************************************/
+#pragma once
+
+#include <iostream>
+#include <vector>
+
+namespace ml {
+
+/*******************************************************************************
+ * @brief Class implementation of output error statistics.
+ *
+ *        Accumulates the absolute error of each predicted output and whether
+ *        the prediction leads to the same decision as the reference. The
+ *        decision of several outputs is the index of the largest output, the
+ *        decision of a single output is whether it reaches a threshold.
+ ******************************************************************************/
+class OutputErrors {
+  public:
+    /*******************************************************************************
+     * @brief Creates new error statistics without any samples.
+     *
+     * @param outputCount The number of outputs per sample.
+     * @param threshold   Decision threshold of single outputs (default = 0.5).
+     ******************************************************************************/
+    explicit OutputErrors(const std::size_t outputCount, const double threshold = 0.5);
+
+    /*******************************************************************************
+     * @brief Deletes the error statistics.
+     ******************************************************************************/
+    ~OutputErrors() noexcept = default;
+
+    /*******************************************************************************
+     * @brief Adds a sample.
+     *
+     * @param reference  Pointer to array holding the reference outputs.
+     * @param prediction Pointer to array holding the predicted outputs.
+     ******************************************************************************/
+    void add(const double *reference, const double *prediction) noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the decision of outputs.
+     *
+     * @param output Pointer to array holding the outputs.
+     *
+     * @return The index of the largest output, or 1 if a single output reaches
+     *         the threshold, else 0.
+     ******************************************************************************/
+    std::size_t decisionOf(const double *output) const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the number of added samples.
+     *
+     * @return The number of samples.
+     ******************************************************************************/
+    std::size_t sampleCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the largest absolute error of any output.
+     *
+     * @return The largest absolute error, 0 without samples.
+     ******************************************************************************/
+    double maxAbsoluteError() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the index of the sample with the largest absolute error.
+     *
+     * @return The index of the sample in the order added.
+     ******************************************************************************/
+    std::size_t worstSample() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the mean absolute error of all outputs.
+     *
+     * @return The mean absolute error, 0 without samples.
+     ******************************************************************************/
+    double meanAbsoluteError() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the mean squared error of all outputs.
+     *
+     * @return The mean squared error, 0 without samples.
+     ******************************************************************************/
+    double meanSquaredError() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the root mean square error of all outputs.
+     *
+     * @return The root mean square error, 0 without samples.
+     ******************************************************************************/
+    double rmsError() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the fraction of samples with the reference decision.
+     *
+     * @return The agreement in the range 0 - 1, 0 without samples.
+     ******************************************************************************/
+    double agreement() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the number of possible decisions.
+     *
+     * @return The number of outputs, or 2 for a single output.
+     ******************************************************************************/
+    std::size_t classCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the confusion matrix.
+     *
+     * @return Reference to vector holding the samples per reference (row) and
+     *         predicted decision.
+     ******************************************************************************/
+    const std::vector<std::size_t> &confusion() const noexcept;
+
+    /*******************************************************************************
+     * @brief Prints the errors and the decision agreement.
+     *
+     * @param ostream Reference to output stream (default = terminal print).
+     ******************************************************************************/
+    void print(std::ostream &ostream = std::cout) const;
+
+    OutputErrors() = delete; // No default constructor.
+
+  private:
+    std::size_t myOutputCount;            // The number of outputs per sample.
+    double myThreshold;                   // Decision threshold of single outputs.
+    std::size_t mySampleCount;            // The number of added samples.
+    double myMaxAbsoluteError;            // The largest absolute error.
+    std::size_t myWorstSample;            // Index of the sample with the largest error.
+    double myAbsoluteSum;                 // Sum of the absolute errors.
+    double mySquaredSum;                  // Sum of the squared errors.
+    std::size_t myAgreeCount;             // The number of samples with the same decision.
+    std::vector<std::size_t> myConfusion; // Samples per reference and predicted decision.
+};
+
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,108 @@
+/********************************************************************************
+ * @brief Group of output lines committed with a single bulk write.
+ ********************************************************************************/
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+
+#include "gpio_backend.h"
+
+namespace rpi {
+
+/********************************************************************************
+ * @brief Implementation of a group of output lines, such as a row of LEDs.
+ *
+ *        The lines are requested together, so the backend can set them with
+ *        a single call. New values are staged with set and written by commit,
+ *        which sets all lines of the group in one bulk call if any value
+ *        changed, and does nothing otherwise. The state of each line is
+ *        cached, so the hardware is never read back.
+ *
+ *        This class is non-copyable and non-movable.
+ ********************************************************************************/
+class OutputGroup {
+  public:
+    /********************************************************************************
+     * @brief Creates new output group, all lines start low.
+     *
+     * @param pins    GPIO pins of the lines in the group (at most LineCount).
+     * @param backend Reference to the GPIO backend to use (default = the
+     *                default backend).
+     ********************************************************************************/
+    OutputGroup(const std::initializer_list<std::uint8_t> pins,
+                gpio::Backend &backend = gpio::defaultBackend());
+
+    /********************************************************************************
+     * @brief Deletes output group and releases allocated hardware.
+     ********************************************************************************/
+    ~OutputGroup() noexcept;
+
+    /********************************************************************************
+     * @brief Provides the number of lines in the group.
+     *
+     * @return The number of lines.
+     ********************************************************************************/
+    std::size_t size() const noexcept;
+
+    /********************************************************************************
+     * @brief Provides the GPIO pin of a line.
+     *
+     * @param index Index of the line in the group.
+     *
+     * @return The GPIO pin of the line.
+     ********************************************************************************/
+    std::uint8_t pin(const std::size_t index) const noexcept;
+
+    /********************************************************************************
+     * @brief Provides the staged value of a line.
+     *
+     * @param index Index of the line in the group.
+     *
+     * @return The value to be written by the next commit.
+     ********************************************************************************/
+    bool value(const std::size_t index) const noexcept;
+
+    /********************************************************************************
+     * @brief Stages new value of a line, written by the next commit.
+     *
+     * @param index Index of the line in the group.
+     * @param value The new value.
+     ********************************************************************************/
+    void set(const std::size_t index, const bool value) noexcept;
+
+    /********************************************************************************
+     * @brief Writes all lines with a single bulk write if any value changed.
+     *
+     *        A failed write leaves the cached state as it was, so the next
+     *        commit writes the lines again.
+     *
+     * @return True if the lines were written, false if nothing changed or the
+     *         write failed.
+     ********************************************************************************/
+    bool commit() noexcept;
+
+    /********************************************************************************
+     * @brief Provides the number of bulk writes performed so far.
+     *
+     * @return The number of commits that wrote to the hardware.
+     ********************************************************************************/
+    std::size_t writeCount() const noexcept;
+
+    OutputGroup() = delete;                               // No default constructor.
+    OutputGroup(const OutputGroup &) = delete;            // No copy constructor.
+    OutputGroup(OutputGroup &&) = delete;                 // No move constructor.
+    OutputGroup &operator=(const OutputGroup &) = delete; // No copy assignment.
+    OutputGroup &operator=(OutputGroup &&) = delete;      // No move assignment.
+
+  private:
+    gpio::Backend &myBackend;                         // Reference to the GPIO backend.
+    std::array<std::uint8_t, gpio::LineCount> myPins; // GPIO pin of each line.
+    std::array<bool, gpio::LineCount> myStaged;       // Values to write on next commit.
+    std::array<bool, gpio::LineCount> myWritten;      // Values last written.
+    std::size_t mySize;                               // The number of lines in the group.
+    std::size_t myWriteCount;                         // The number of bulk writes performed.
+};
+
+} // namespace rpi
\ No newline at end of file
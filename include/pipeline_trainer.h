@@ -0,0 +1,186 @@
+/*******************************************************************************
+ * @brief Pipeline-parallel training of the layers of a neural network.
+ ******************************************************************************/
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "arena.h"
+#include "dense_layer.h"
+#include "loss.h"
+#include "spsc_queue.h"
+
+namespace ml {
+
+/*******************************************************************************
+ * @brief Class implementation of a pipeline trainer.
+ *
+ *        The layers are split into contiguous stages of about the same number
+ *        of weights, each run by its own thread; the first stage runs on the
+ *        thread calling trainEpoch. The training sets are streamed through the
+ *        stages in batches of micro-batches of one set each: every stage first
+ *        feeds all micro-batches of a batch forward, then propagates their
+ *        errors back, handing micro-batches to the neighbouring stages through
+ *        bounded lock-free queues. Each micro-batch has its own outputs and
+ *        errors, so the stages work on different micro-batches at once.
+ *
+ *        Weight updates are synchronous: each layer sums the updates of all
+ *        micro-batches of a batch, in order, and applies them when the batch
+ *        is done, so every micro-batch sees the same weights in both
+ *        directions. The result doesn't depend on the number of stages, and
+ *        with one micro-batch per batch equals ml::NeuralNetwork::train.
+ *
+ *        The layers are pointed at the activations of the trainer, their owner
+ *        must point them back when done (see DenseLayer::place).
+ *
+ *        This class is non-copyable and non-movable.
+ ******************************************************************************/
+class PipelineTrainer {
+  public:
+    /*******************************************************************************
+     * @brief Creates new pipeline trainer and starts its stage threads.
+     *
+     * @param layers          Reference to vector holding pointers to the layers,
+     *                        output layer last. The layers must outlive the trainer.
+     * @param loss            The loss function minimized by the output layer.
+     * @param stageCount      The number of stages, at most one per layer.
+     * @param microBatchCount The number of micro-batches per batch.
+     ******************************************************************************/
+    PipelineTrainer(const std::vector<DenseLayer *> &layers, const Loss loss,
+                    const std::size_t stageCount, const std::size_t microBatchCount);
+
+    /*******************************************************************************
+     * @brief Stops the stage threads and deletes the pipeline trainer.
+     ******************************************************************************/
+    ~PipelineTrainer() noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the number of stages.
+     *
+     * @return The number of stages, one thread each.
+     ******************************************************************************/
+    std::size_t stageCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the first layer of a stage.
+     *
+     * @param stage Index of the stage.
+     *
+     * @return Index of the first layer run by the stage.
+     ******************************************************************************/
+    std::size_t firstLayer(const std::size_t stage) const;
+
+    /*******************************************************************************
+     * @brief Trains each set once, returning when all updates are applied.
+     *
+     * @param input        Reference to vector holding the input sets, each
+     *                     matching the first layer.
+     * @param output       Reference to vector holding the output sets, each
+     *                     matching the output layer.
+     * @param learningRate The learning rate used for optimization.
+     ******************************************************************************/
+    void trainEpoch(const std::vector<std::vector<double>> &input,
+                    const std::vector<std::vector<double>> &output, const double learningRate);
+
+    PipelineTrainer() = delete;                                   // No default constructor.
+    PipelineTrainer(const PipelineTrainer &) = delete;            // No copy constructor.
+    PipelineTrainer(PipelineTrainer &&) = delete;                 // No move constructor.
+    PipelineTrainer &operator=(const PipelineTrainer &) = delete; // No copy assignment.
+    PipelineTrainer &operator=(PipelineTrainer &&) = delete;      // No move assignment.
+
+  private:
+    /*******************************************************************************
+     * @brief Waits for epochs to train and runs a stage on them.
+     *
+     * @param stage Index of the stage run by the thread.
+     ******************************************************************************/
+    void run(const std::size_t stage);
+
+    /*******************************************************************************
+     * @brief Runs a stage for one epoch.
+     *
+     * @param stage Index of the stage.
+     ******************************************************************************/
+    void runEpoch(const std::size_t stage) noexcept;
+
+    /*******************************************************************************
+     * @brief Propagates the error of a micro-batch back through a stage and adds
+     *        its updates to the gradients.
+     *
+     * @param stage Index of the stage.
+     * @param slot  Index of the micro-batch within the batch.
+     * @param set   Index of the training set of the micro-batch.
+     ******************************************************************************/
+    void backward(const std::size_t stage, const std::size_t slot,
+                  const std::size_t set) noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the input of a layer for a micro-batch.
+     *
+     * @param layer Index of the layer.
+     * @param slot  Index of the micro-batch within the batch.
+     * @param set   Index of the training set of the micro-batch.
+     *
+     * @return Pointer to the input, the output of the previous layer.
+     ******************************************************************************/
+    const double *inputOf(const std::size_t layer, const std::size_t slot,
+                          const std::size_t set) const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the outputs and errors of a layer for a micro-batch.
+     *
+     * @param layer Index of the layer.
+     * @param slot  Index of the micro-batch within the batch.
+     *
+     * @return Pointer to the activations of the layer.
+     ******************************************************************************/
+    double *activationsOf(const std::size_t layer, const std::size_t slot) noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the error handed back to the previous stage for a micro-batch.
+     *
+     * @param stage Index of the stage handing the error back, at least 1.
+     * @param slot  Index of the micro-batch within the batch.
+     *
+     * @return Pointer to the error at the input of the first layer of the stage.
+     ******************************************************************************/
+    double *boundaryOf(const std::size_t stage, const std::size_t slot) noexcept;
+
+    /*******************************************************************************
+     * @brief Stops and joins the stage threads.
+     ******************************************************************************/
+    void stop() noexcept;
+
+    using Queue = SpscQueue<std::size_t>; // Queue of micro-batches between two stages.
+
+    std::vector<DenseLayer *> myLayers;               // The layers, output layer last.
+    Loss myLoss;                                      // Loss minimized by the output layer.
+    std::size_t myMicroBatchCount;                    // The number of micro-batches per batch.
+    std::vector<std::size_t> myStageStart;            // First layer of each stage, then the end.
+    std::vector<std::size_t> myActivationOffset;      // Offset of each layer within a slot.
+    std::vector<std::size_t> myGradientOffset;        // Offset of each layer in the gradients.
+    std::vector<std::size_t> myBoundaryOffset;        // Offset of each stage in the boundaries.
+    std::size_t mySlotSize;                           // Activations per micro-batch.
+    std::size_t myBoundarySize;                       // Boundary errors per micro-batch.
+    Arena myActivations;                              // Outputs and errors of each micro-batch.
+    Arena myBoundaries;                               // Errors handed back between stages.
+    Arena myGradients;                                // Summed updates of the current batch.
+    std::vector<std::unique_ptr<Queue>> myForward;    // Micro-batches fed to each next stage.
+    std::vector<std::unique_ptr<Queue>> myBackward;   // Micro-batches handed back to each stage.
+    const std::vector<std::vector<double>> *myInput;  // Input sets of the current epoch.
+    const std::vector<std::vector<double>> *myOutput; // Output sets of the current epoch.
+    double myLearningRate;                            // Learning rate of the current epoch.
+    std::size_t myEpoch;                              // The number of epochs started.
+    std::size_t myDoneCount;                          // Stage threads done with the current epoch.
+    bool myStop;                                      // Indicates if the stage threads shall stop.
+    std::mutex myMutex;                               // Mutex protecting the epoch state.
+    std::condition_variable myCondition;              // Signals started and finished epochs.
+    std::vector<std::thread> myThreads;               // Threads of the stages after the first.
+};
+
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,98 @@
+/*******************************************************************************
+ * @brief Bounded replay memory of labelled samples for online learning.
+ ******************************************************************************/
+#pragma once
+
+#include <vector>
+
+namespace ml {
+
+/*******************************************************************************
+ * @brief Class implementation of a ring-buffer replay memory.
+ *
+ *        All storage is allocated when the buffer is created; adding samples
+ *        only copies values, and overwrites the oldest sample once full.
+ ******************************************************************************/
+class ReplayBuffer {
+  public:
+    /*******************************************************************************
+     * @brief Creates new replay buffer.
+     *
+     * @param capacity   The maximum number of stored samples.
+     * @param inputSize  The number of values of each input.
+     * @param outputSize The number of values of each output.
+     ******************************************************************************/
+    ReplayBuffer(const std::size_t capacity, const std::size_t inputSize,
+                 const std::size_t outputSize);
+
+    /*******************************************************************************
+     * @brief Deletes the replay buffer.
+     ******************************************************************************/
+    ~ReplayBuffer() = default;
+
+    /*******************************************************************************
+     * @brief Provides the maximum number of stored samples.
+     *
+     * @return The capacity of the buffer.
+     ******************************************************************************/
+    std::size_t capacity() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the number of stored samples.
+     *
+     * @return The number of stored samples.
+     ******************************************************************************/
+    std::size_t size() const noexcept;
+
+    /*******************************************************************************
+     * @brief Adds sample, overwriting the oldest one if the buffer is full.
+     *
+     * @param input  Reference to vector holding the input of the sample.
+     * @param output Reference to vector holding the output of the sample.
+     *
+     * @return True if the sample was added, false on shape mismatch.
+     ******************************************************************************/
+    bool push(const std::vector<double> &input, const std::vector<double> &output);
+
+    /*******************************************************************************
+     * @brief Provides the input of a stored sample.
+     *
+     * @param index Index of the sample, 0 being the oldest.
+     *
+     * @return Reference to vector holding the input.
+     ******************************************************************************/
+    const std::vector<double> &input(const std::size_t index) const;
+
+    /*******************************************************************************
+     * @brief Provides the output of a stored sample.
+     *
+     * @param index Index of the sample, 0 being the oldest.
+     *
+     * @return Reference to vector holding the output.
+     ******************************************************************************/
+    const std::vector<double> &output(const std::size_t index) const;
+
+    /*******************************************************************************
+     * @brief Removes all stored samples, keeping the allocated storage.
+     ******************************************************************************/
+    void clear() noexcept;
+
+    ReplayBuffer() = delete; // No default constructor.
+
+  private:
+    /*******************************************************************************
+     * @brief Converts sample index to storage slot.
+     *
+     * @param index Index of the sample, 0 being the oldest.
+     *
+     * @return The storage slot of the sample.
+     ******************************************************************************/
+    std::size_t slot(const std::size_t index) const;
+
+    std::vector<std::vector<double>> myInputs;  // Input of each slot.
+    std::vector<std::vector<double>> myOutputs; // Output of each slot.
+    std::size_t myNext;                         // Slot to write the next sample to.
+    std::size_t mySize;                         // The number of stored samples.
+};
+
+} // namespace ml
\ No newline at end of file
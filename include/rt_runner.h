@@ -0,0 +1,130 @@
+/*******************************************************************************
+ * @brief Real-time fixed-rate runner for the sense-predict-actuate loop.
+ ******************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "latency_histogram.h"
+
+namespace ctrl {
+
+/*******************************************************************************
+ * @brief Class implementation of a real-time fixed-rate loop runner.
+ *
+ *        Cycles are started at absolute deadlines on the monotonic clock
+ *        (clock_nanosleep with TIMER_ABSTIME), so the period doesn't drift
+ *        with the duration of each cycle. The calling thread can optionally
+ *        be given SCHED_FIFO priority and pinned to a CPU, and memory can be
+ *        locked and prefaulted to avoid page faults inside the loop.
+ *
+ *        This class is non-copyable and non-movable.
+ ******************************************************************************/
+class RtRunner {
+  public:
+    /*******************************************************************************
+     * @brief Structure holding the runner configuration.
+     ******************************************************************************/
+    struct Config {
+        std::chrono::nanoseconds period{1000000}; // Cycle period (default = 1 ms).
+        int priority{0};                          // SCHED_FIFO priority, 0 = normal scheduling.
+        int cpu{-1};                              // CPU to pin the thread to, -1 = no pinning.
+        bool lockMemory{false};                   // Lock current and future memory in RAM.
+        std::size_t prefaultStackBytes{0U};       // Stack size to touch before running.
+        std::size_t prefaultHeapBytes{0U};        // Heap size to touch and keep before running.
+    };
+
+    /*******************************************************************************
+     * @brief Creates new real-time runner.
+     *
+     * @param config Reference to the runner configuration.
+     ******************************************************************************/
+    explicit RtRunner(const Config &config);
+
+    /*******************************************************************************
+     * @brief Deletes the runner.
+     ******************************************************************************/
+    ~RtRunner() noexcept = default;
+
+    /*******************************************************************************
+     * @brief Applies the real-time settings to the calling thread.
+     *
+     * @return True if all requested settings were applied, else false. Reasons
+     *         for failures are provided by setupErrors.
+     ******************************************************************************/
+    bool prepare();
+
+    /*******************************************************************************
+     * @brief Provides descriptions of settings that couldn't be applied.
+     *
+     * @return Reference to vector holding the error descriptions.
+     ******************************************************************************/
+    const std::vector<std::string> &setupErrors() const noexcept;
+
+    /*******************************************************************************
+     * @brief Runs the loop in the calling thread at the configured rate.
+     *
+     * @param cycle      Function performing one cycle, returns false to stop.
+     * @param cycleCount The number of cycles to run, 0 = until stopped.
+     *
+     * @return The number of cycles run.
+     ******************************************************************************/
+    std::size_t run(const std::function<bool()> &cycle, const std::size_t cycleCount = 0U);
+
+    /*******************************************************************************
+     * @brief Requests the loop to stop after the current cycle.
+     ******************************************************************************/
+    void stop() noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the number of cycles that didn't finish before the next
+     *        deadline. Missed deadlines are skipped rather than run in a burst.
+     *
+     * @return The number of overruns.
+     ******************************************************************************/
+    std::size_t overrunCount() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the wake-up jitter, i.e. the time from each deadline to
+     *        the start of the cycle, in nanoseconds.
+     *
+     * @return Reference to the jitter histogram.
+     ******************************************************************************/
+    const LatencyHistogram &jitter() const noexcept;
+
+    /*******************************************************************************
+     * @brief Provides the execution time of each cycle in nanoseconds.
+     *
+     * @return Reference to the execution time histogram.
+     ******************************************************************************/
+    const LatencyHistogram &cycleTime() const noexcept;
+
+    /*******************************************************************************
+     * @brief Prints the settings, overruns and jitter statistics.
+     *
+     * @param ostream Reference to output stream (default = terminal print).
+     ******************************************************************************/
+    void print(std::ostream &ostream = std::cout) const;
+
+    RtRunner() = delete;                            // No default constructor.
+    RtRunner(const RtRunner &) = delete;            // No copy constructor.
+    RtRunner(RtRunner &&) = delete;                 // No move constructor.
+    RtRunner &operator=(const RtRunner &) = delete; // No copy assignment.
+    RtRunner &operator=(RtRunner &&) = delete;      // No move assignment.
+
+  private:
+    const Config myConfig;                   // The runner configuration.
+    std::vector<std::string> mySetupErrors;  // Settings that couldn't be applied.
+    std::atomic<bool> myStopRequested;       // Indicates if the loop shall stop.
+    std::atomic<std::size_t> myOverrunCount; // The number of overruns.
+    LatencyHistogram myJitter;               // Wake-up jitter per cycle.
+    LatencyHistogram myCycleTime;            // Execution time per cycle.
+};
+
+} // namespace ctrl
\ No newline at end of file
@@ -0,0 +1,141 @@
+/********************************************************************************
+ * @brief Simulated GPIO chip for running drivers without Raspberry Pi hardware.
+ ********************************************************************************/
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include "gpio_backend.h"
+
+namespace rpi {
+namespace gpio {
+
+/********************************************************************************
+ * @brief Implementation of an in-process simulated GPIO chip.
+ *
+ *        Input lines play scripted or random sequences, advancing one step
+ *        per read. Output writes are recorded with monotonic timestamps so
+ *        that loop latency and throughput can be measured off target.
+ *        All methods are thread-safe.
+ *
+ *        This class is non-copyable and non-movable.
+ ********************************************************************************/
+class SimChip : public Backend {
+  public:
+    /********************************************************************************
+     * @brief Structure holding a recorded output write.
+     ********************************************************************************/
+    struct Write {
+        std::uint64_t timestampNs; // Monotonic timestamp of the write in nanoseconds.
+        std::uint8_t pin;          // GPIO pin written to.
+        bool value;                // The value written.
+    };
+
+    /********************************************************************************
+     * @brief Creates new simulated chip.
+     *
+     * @param writeCapacity Maximum number of recorded writes, further writes are
+     *                      counted as dropped (default = 1 048 576).
+     * @param seed          Seed for random input sequences (default = 0).
+     ********************************************************************************/
+    explicit SimChip(const std::size_t writeCapacity = 1U << 20U, const std::uint32_t seed = 0U);
+
+    /********************************************************************************
+     * @brief Deletes the simulated chip.
+     ********************************************************************************/
+    ~SimChip() noexcept override = default;
+
+    /********************************************************************************
+     * @brief Sets constant input value of a line.
+     *
+     * @param pin   GPIO pin of the line.
+     * @param value The input value.
+     ********************************************************************************/
+    void setInput(const std::uint8_t pin, const bool value) noexcept;
+
+    /********************************************************************************
+     * @brief Plays scripted input sequence on a line, one value per read.
+     *
+     * @param pin      GPIO pin of the line.
+     * @param sequence Reference to vector holding the input sequence.
+     * @param repeat   Indicates if the sequence is repeated (default = true),
+     *                 else the last value is held when the sequence ends.
+     ********************************************************************************/
+    void script(const std::uint8_t pin, const std::vector<bool> &sequence,
+                const bool repeat = true);
+
+    /********************************************************************************
+     * @brief Plays random input sequence on a line.
+     *
+     * @param pin               GPIO pin of the line.
+     * @param toggleProbability Probability that the input toggles on each read.
+     ********************************************************************************/
+    void randomize(const std::uint8_t pin, const double toggleProbability) noexcept;
+
+    /********************************************************************************
+     * @brief Provides the recorded output writes.
+     *
+     * @return Vector holding a copy of the recorded writes in write order.
+     ********************************************************************************/
+    std::vector<Write> writes() const;
+
+    /********************************************************************************
+     * @brief Provides the number of writes that didn't fit in the record.
+     *
+     * @return The number of dropped writes.
+     ********************************************************************************/
+    std::size_t droppedWriteCount() const noexcept;
+
+    /********************************************************************************
+     * @brief Provides the number of reads performed on input lines.
+     *
+     * @return The number of reads.
+     ********************************************************************************/
+    std::size_t readCount() const noexcept;
+
+    /********************************************************************************
+     * @brief Clears recorded writes and counters.
+     ********************************************************************************/
+    void clearRecord() noexcept;
+
+    bool requestLine(const std::uint8_t pin, const Direction direction) noexcept override;
+    void releaseLine(const std::uint8_t pin) noexcept override;
+    bool read(const std::uint8_t pin) noexcept override;
+    void write(const std::uint8_t pin, const bool value) noexcept override;
+    bool writeBulk(const std::uint8_t *pins, const bool *values,
+                   const std::size_t count) noexcept override;
+
+    SimChip(const SimChip &) = delete;            // No copy constructor.
+    SimChip(SimChip &&) = delete;                 // No move constructor.
+    SimChip &operator=(const SimChip &) = delete; // No copy assignment.
+    SimChip &operator=(SimChip &&) = delete;      // No move assignment.
+
+  private:
+    /********************************************************************************
+     * @brief Structure holding the state of a simulated line.
+     ********************************************************************************/
+    struct Line {
+        bool requested;           // Indicates if the line is requested.
+        Direction direction;      // Data direction of the line.
+        bool value;               // Current value of the line.
+        std::vector<bool> script; // Scripted input sequence (empty if none).
+        std::size_t scriptIndex;  // Index of the next scripted value.
+        bool repeat;              // Indicates if the script is repeated.
+        double toggleProbability; // Probability of random toggle per read.
+    };
+
+    mutable std::mutex myMutex;          // Mutex protecting the chip state.
+    std::array<Line, LineCount> myLines; // Simulated lines, indexed by pin.
+    std::vector<Write> myWrites;         // Recorded output writes.
+    std::size_t myWriteCapacity;         // Maximum number of recorded writes.
+    std::size_t myDroppedWriteCount;     // Number of writes not recorded.
+    std::size_t myReadCount;             // Number of reads performed.
+    std::mt19937 myGenerator;            // Generator for random input sequences.
+};
+
+} // namespace gpio
+} // namespace rpi
\ No newline at end of file
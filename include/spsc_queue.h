@@ -0,0 +1,183 @@
+/*******************************************************************************
+ * @brief Bounded lock-free queue between one producer and one consumer thread.
+ ******************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace ml {
+
+/*******************************************************************************
+ * @brief Class implementation of a single-producer single-consumer queue.
+ *
+ *        A ring buffer with one slot kept free, the producer only writes the
+ *        tail and the consumer only writes the head, so neither side takes a
+ *        lock. Head and tail live on separate cache lines to avoid false
+ *        sharing. Blocking push and pop retry a bounded number of times, then
+ *        sleep on a condition variable until the other side makes progress,
+ *        so waiting stages don't starve each other on a busy CPU. The other
+ *        side only takes the mutex when a waiter is announced.
+ *
+ *        This class is non-copyable and non-movable.
+ *
+ * @tparam T The value type, should be cheap to copy.
+ ******************************************************************************/
+template <typename T> class SpscQueue {
+  public:
+    /*******************************************************************************
+     * @brief Creates new queue.
+     *
+     * @param capacity The maximum number of queued values.
+     ******************************************************************************/
+    explicit SpscQueue(const std::size_t capacity)
+        : mySlots(capacity + 1U), myHead{0U}, myTail{0U}, myProducerWaiting{false},
+          myConsumerWaiting{false}, myMutex{}, myCondition{} {}
+
+    /*******************************************************************************
+     * @brief Deletes the queue.
+     ******************************************************************************/
+    ~SpscQueue() noexcept = default;
+
+    /*******************************************************************************
+     * @brief Adds value to the queue if there is room, producer only.
+     *
+     * @param value The value to add.
+     *
+     * @return True if the value was added, false if the queue is full.
+     ******************************************************************************/
+    bool tryPush(const T &value) noexcept {
+        const auto tail{myTail.load(std::memory_order_relaxed)};
+        const auto next{tail + 1U == mySlots.size() ? 0U : tail + 1U};
+        if (next == myHead.load(std::memory_order_acquire)) { return false; }
+        mySlots[tail] = value;
+        myTail.store(next, std::memory_order_release);
+        wake(myConsumerWaiting);
+        return true;
+    }
+
+    /*******************************************************************************
+     * @brief Takes the oldest value from the queue if there is one, consumer only.
+     *
+     * @param value Reference to variable set to the value taken.
+     *
+     * @return True if a value was taken, false if the queue is empty.
+     ******************************************************************************/
+    bool tryPop(T &value) noexcept {
+        const auto head{myHead.load(std::memory_order_relaxed)};
+        if (head == myTail.load(std::memory_order_acquire)) { return false; }
+        value = mySlots[head];
+        myHead.store(head + 1U == mySlots.size() ? 0U : head + 1U, std::memory_order_release);
+        wake(myProducerWaiting);
+        return true;
+    }
+
+    /*******************************************************************************
+     * @brief Adds value to the queue, waiting for room if it is full.
+     *
+     * @param value The value to add.
+     ******************************************************************************/
+    void push(const T &value) noexcept {
+        while (!tryPush(value)) {
+            wait(myProducerWaiting, [this]() { return !isFull(); });
+        }
+    }
+
+    /*******************************************************************************
+     * @brief Takes the oldest value from the queue, waiting for one if it is empty.
+     *
+     * @return The value taken.
+     ******************************************************************************/
+    T pop() noexcept {
+        T value{};
+        while (!tryPop(value)) {
+            wait(myConsumerWaiting, [this]() { return !isEmpty(); });
+        }
+        return value;
+    }
+
+    /*******************************************************************************
+     * @brief Provides the maximum number of queued values.
+     *
+     * @return The capacity of the queue.
+     ******************************************************************************/
+    std::size_t capacity() const noexcept { return mySlots.size() - 1U; }
+
+    SpscQueue() = delete;                             // No default constructor.
+    SpscQueue(const SpscQueue &) = delete;            // No copy constructor.
+    SpscQueue(SpscQueue &&) = delete;                 // No move constructor.
+    SpscQueue &operator=(const SpscQueue &) = delete; // No copy assignment.
+    SpscQueue &operator=(SpscQueue &&) = delete;      // No move assignment.
+
+  private:
+    /*******************************************************************************
+     * @brief The number of attempts before a waiting side goes to sleep.
+     ******************************************************************************/
+    static constexpr std::size_t SpinCount{64U};
+
+    /*******************************************************************************
+     * @brief Indicates if the queue is full, producer only.
+     *
+     * @return True if there is no room for another value, else false.
+     ******************************************************************************/
+    bool isFull() const noexcept {
+        const auto tail{myTail.load(std::memory_order_relaxed)};
+        const auto next{tail + 1U == mySlots.size() ? 0U : tail + 1U};
+        return next == myHead.load(std::memory_order_acquire);
+    }
+
+    /*******************************************************************************
+     * @brief Indicates if the queue is empty, consumer only.
+     *
+     * @return True if there is no value to take, else false.
+     ******************************************************************************/
+    bool isEmpty() const noexcept {
+        return myHead.load(std::memory_order_relaxed) == myTail.load(std::memory_order_acquire);
+    }
+
+    /*******************************************************************************
+     * @brief Waits until the other side makes progress, sleeping after SpinCount
+     *        checks.
+     *
+     * @param waiting Reference to the flag announcing the waiting side.
+     * @param isReady Check returning true once the waiting side can proceed.
+     ******************************************************************************/
+    template <typename Ready> void wait(std::atomic<bool> &waiting, Ready &&isReady) noexcept {
+        for (std::size_t i{}; i < SpinCount; ++i) {
+            if (isReady()) { return; }
+        }
+
+        // Announce the waiter before checking again, pairs with the fence in wake().
+        std::unique_lock<std::mutex> lock{myMutex};
+        waiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        myCondition.wait(lock, isReady);
+        waiting.store(false, std::memory_order_relaxed);
+    }
+
+    /*******************************************************************************
+     * @brief Wakes the other side if it announced that it is waiting.
+     *
+     * @param waiting Reference to the flag announcing the other side.
+     ******************************************************************************/
+    void wake(std::atomic<bool> &waiting) noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock{myMutex};
+            myCondition.notify_all();
+        }
+    }
+
+    std::vector<T> mySlots;                      // Ring buffer, one slot kept free.
+    alignas(64) std::atomic<std::size_t> myHead; // Index of the oldest value.
+    alignas(64) std::atomic<std::size_t> myTail; // Index of the next free slot.
+    std::atomic<bool> myProducerWaiting;         // Indicates if the producer sleeps.
+    std::atomic<bool> myConsumerWaiting;         // Indicates if the consumer sleeps.
+    std::mutex myMutex;                          // Protects sleeping and waking.
+    std::condition_variable myCondition;         // Wakes a sleeping side.
+};
+
+} // namespace ml
\ No newline at end of file
@@ -6,10 +6,25 @@
 
 #include <cstdint>
 #include <iostream>
+#include <random>
 #include <string>
 #include <vector>
 
 namespace utils {
+namespace detail {
+
+/*******************************************************************************
+ * @brief Provides the random generator of the calling thread.
+ *
+ *        Declared outside the anonymous namespace, so that all translation
+ *        units share one generator per thread.
+ *
+ * @return Reference to the random generator of the calling thread.
+ ******************************************************************************/
+inline std::mt19937 &randomGenerator();
+
+} // namespace detail
+
 namespace {
 
 namespace random {
@@ -26,6 +41,34 @@ namespace random {
  ******************************************************************************/
 template <typename T> T getNumber(const T min = 0, const T max = 100);
 
+/*******************************************************************************
+ * @brief Seeds the random generator of the calling thread.
+ *
+ *        Each thread has its own generator, seeded from std::random_device on
+ *        first use, so threads can generate random numbers concurrently and
+ *        reproducibly after seeding.
+ *
+ * @param value The seed to use.
+ ******************************************************************************/
+inline void seed(const std::uint32_t value);
+
+/*******************************************************************************
+ * @brief Provides the state of the random generator of the calling thread.
+ *
+ * @return The state as a string, to be passed to setState.
+ ******************************************************************************/
+inline std::string state();
+
+/*******************************************************************************
+ * @brief Sets the state of the random generator of the calling thread, so it
+ *        continues the sequence from where the state was read.
+ *
+ * @param state Reference to a state provided by the state function.
+ *
+ * @return True if the state was valid, else false.
+ ******************************************************************************/
+inline bool setState(const std::string &state);
+
 } // namespace random
 
 namespace vector {
@@ -216,14 +259,58 @@ constexpr double tanh(const double number);
 
 /*******************************************************************************
  * @brief Provides the gradient of the hyperbolic tangent (tanh) for a
- *        given input.
+ *        given tanh output.
  *
- * @param number The number for which to calculate the gradient of the
- *               hyperbolic tangent.
+ * @param output The tanh output for which to calculate the gradient, as
+ *               stored by a layer after feedforward.
  *
  * @return The gradient of the hyperbolic tangent as a double.
  ******************************************************************************/
-constexpr double tanhGradient(const double number);
+constexpr double tanhGradient(const double output);
+
+/*******************************************************************************
+ * @brief Provides the logistic sigmoid for a given input.
+ *
+ * @param number The number for which to calculate the sigmoid.
+ *
+ * @return The sigmoid as a double, 0.0 - 1.0.
+ ******************************************************************************/
+constexpr double sigmoid(const double number);
+
+/*******************************************************************************
+ * @brief Provides the gradient of the logistic sigmoid for a given sigmoid
+ *        output.
+ *
+ * @param output The sigmoid output for which to calculate the gradient.
+ *
+ * @return The gradient of the sigmoid as a double.
+ ******************************************************************************/
+constexpr double sigmoidGradient(const double output);
+
+/*******************************************************************************
+ * @brief Slope of the leaky Rectified Linear Unit for negative inputs.
+ ******************************************************************************/
+constexpr double LeakyReluSlope{0.01};
+
+/*******************************************************************************
+ * @brief Provides the leaky Rectified Linear Unit (leaky ReLU) activation for
+ *        a given input.
+ *
+ * @param number The number for which to calculate the leaky ReLU.
+ *
+ * @return The leaky ReLU activation as a double.
+ ******************************************************************************/
+constexpr double leakyRelu(const double number);
+
+/*******************************************************************************
+ * @brief Provides the gradient of the leaky Rectified Linear Unit (leaky ReLU)
+ *        function for a given input or output, which have the same sign.
+ *
+ * @param number The number for which to calculate the leaky ReLU gradient.
+ *
+ * @return The leaky ReLU gradient as a double.
+ ******************************************************************************/
+constexpr double leakyReluGradient(const double number);
 
 } // namespace math
 
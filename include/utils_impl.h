@@ -7,27 +7,27 @@
 
 #include <cmath>
 #include <cstdint>
-#include <cstdlib>
-#include <ctime>
 #include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
 #include <type_traits>
 #include <vector>
 
 namespace utils {
-namespace {
-namespace random {
+namespace detail {
 
 // -----------------------------------------------------------------------------
-inline void init() {
-    static auto generatorInitialized{false};
-
-    // Only initialize the random generator once.
-    if (!generatorInitialized) {
-        std::srand(std::time(nullptr));
-        generatorInitialized = true;
-    }
+inline std::mt19937 &randomGenerator() {
+    thread_local std::mt19937 generator{std::random_device{}()};
+    return generator;
 }
 
+} // namespace detail
+
+namespace {
+namespace random {
+
 // -----------------------------------------------------------------------------
 template <typename T> T getNumber(const T min, const T max) {
     // Generate a compilation error if given type is not arithmetic.
@@ -39,17 +39,38 @@ template <typename T> T getNumber(const T min, const T max) {
         throw std::invalid_argument("Cannot generate random number when min is more than max!");
     }
 
-    // Initialize the random generator (if not previously initialized).
-    init();
-
-    // Return value between min and max.
+    // Return value between min and max, drawn from the generator of the calling thread.
     if constexpr (std::is_integral<T>::value) {
-        return static_cast<T>((std::rand() % (max + 1 - min)) + min);
+        using Integer = typename std::conditional<std::is_signed<T>::value, long long,
+                                                  unsigned long long>::type;
+        std::uniform_int_distribution<Integer> distribution{min, max};
+        return static_cast<T>(distribution(detail::randomGenerator()));
     } else {
-        return (std::rand() / static_cast<T>(RAND_MAX)) * (max - min) + min;
+        std::uniform_real_distribution<T> distribution{min, max};
+        return distribution(detail::randomGenerator());
     }
 }
 
+// -----------------------------------------------------------------------------
+inline void seed(const std::uint32_t value) { detail::randomGenerator().seed(value); }
+
+// -----------------------------------------------------------------------------
+inline std::string state() {
+    std::ostringstream stream{};
+    stream << detail::randomGenerator();
+    return stream.str();
+}
+
+// -----------------------------------------------------------------------------
+inline bool setState(const std::string &state) {
+    // Parse into a copy, so an invalid state leaves the generator untouched.
+    std::istringstream stream{state};
+    std::mt19937 generator{};
+    if (!(stream >> generator)) { return false; }
+    detail::randomGenerator() = generator;
+    return true;
+}
+
 } // namespace random
 
 namespace vector {
@@ -105,7 +126,7 @@ template <typename T> void shuffle(std::vector<T> &vector) {
     // Swap each element one by one.
     for (std::size_t i{}; i < vector.size(); ++i) {
         // Generate random index to used for swapping.
-        const auto r{static_cast<std::size_t>(std::rand() % vector.size())};
+        const auto r{random::getNumber<std::size_t>(0U, vector.size() - 1U)};
 
         // Store temporary copy of the first value.
         const auto temp{vector[i]};
@@ -123,7 +144,7 @@ template <typename T> void shuffle(std::vector<std::vector<T>> &vector) {
     // Swap each element one by one.
     for (std::size_t i{}; i < vector.size(); ++i) {
         // Generate random index to used for swapping.
-        const auto r{static_cast<std::size_t>(std::rand() % vector.size())};
+        const auto r{random::getNumber<std::size_t>(0U, vector.size() - 1U)};
 
         // Store temporary copy of the first value.
         const auto temp{vector[i]};
@@ -289,7 +310,23 @@ constexpr double reluGradient(const double number) { return number > 0.0 ? 1.0 :
 constexpr double tanh(const double number) { return std::tanh(number); }
 
 // -----------------------------------------------------------------------------
-constexpr double tanhGradient(const double number) { return 1 - std::pow(std::tanh(number), 2); }
+constexpr double tanhGradient(const double output) { return 1.0 - output * output; }
+
+// -----------------------------------------------------------------------------
+constexpr double sigmoid(const double number) { return 1.0 / (1.0 + std::exp(-number)); }
+
+// -----------------------------------------------------------------------------
+constexpr double sigmoidGradient(const double output) { return output * (1.0 - output); }
+
+// -----------------------------------------------------------------------------
+constexpr double leakyRelu(const double number) {
+    return number > 0.0 ? number : LeakyReluSlope * number;
+}
+
+// -----------------------------------------------------------------------------
+constexpr double leakyReluGradient(const double number) {
+    return number > 0.0 ? 1.0 : LeakyReluSlope;
+}
 
 } // namespace math
 } // namespace
@@ -1,37 +1,209 @@
 /*******************************************************************************
  * @brief Implementation details for activation function calculations.
  ******************************************************************************/
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 
 #include "act_func.h"
 #include "utils.h"
 
 namespace ml {
+namespace {
+
+/*******************************************************************************
+ * @brief Kernel holding the output and gradient of an activation function.
+ *
+ *        The kernels are specialized per activation function at compile time,
+ *        so loops using them contain no branch on the activation function.
+ *
+ * @tparam actFunc The activation function of the kernel.
+ ******************************************************************************/
+template <ActFunc actFunc> struct Kernel;
+
+template <> struct Kernel<ActFunc::Relu> {
+    static constexpr double output(const double x) { return utils::math::relu(x); }
+    static constexpr double gradient(const double y) { return utils::math::reluGradient(y); }
+};
+
+template <> struct Kernel<ActFunc::Tanh> {
+    static constexpr double output(const double x) { return utils::math::tanh(x); }
+    static constexpr double gradient(const double y) { return utils::math::tanhGradient(y); }
+};
+
+template <> struct Kernel<ActFunc::Linear> {
+    static constexpr double output(const double x) { return x; }
+    static constexpr double gradient(const double) { return 1.0; }
+};
+
+template <> struct Kernel<ActFunc::Sigmoid> {
+    static constexpr double output(const double x) { return utils::math::sigmoid(x); }
+    static constexpr double gradient(const double y) { return utils::math::sigmoidGradient(y); }
+};
+
+template <> struct Kernel<ActFunc::LeakyRelu> {
+    static constexpr double output(const double x) { return utils::math::leakyRelu(x); }
+    static constexpr double gradient(const double y) { return utils::math::leakyReluGradient(y); }
+};
 
 // -----------------------------------------------------------------------------
-double actFuncOutput(const ActFunc actFunc, const double number) {
+template <typename Function> void dispatch(const ActFunc actFunc, Function &&function) {
+    // Call the function with the kernel of the activation function.
     switch (actFunc) {
     case ActFunc::Relu:
-        return utils::math::relu(number);
+        return function(Kernel<ActFunc::Relu>{});
     case ActFunc::Tanh:
-        return utils::math::tanh(number);
+        return function(Kernel<ActFunc::Tanh>{});
+    case ActFunc::Linear:
+        return function(Kernel<ActFunc::Linear>{});
+    case ActFunc::Sigmoid:
+        return function(Kernel<ActFunc::Sigmoid>{});
+    case ActFunc::LeakyRelu:
+        return function(Kernel<ActFunc::LeakyRelu>{});
+    case ActFunc::Softmax:
+        throw std::invalid_argument("Softmax cannot be applied element-wise!\n");
     default:
         throw std::invalid_argument("Invalid activation function!\n");
     }
 }
 
 // -----------------------------------------------------------------------------
-double actFuncGradient(const ActFunc actFunc, const double number) {
+template <ActFunc actFunc> void outputKernel(double *numbers, const std::size_t count) noexcept {
+    for (std::size_t i{}; i < count; ++i) {
+        numbers[i] = Kernel<actFunc>::output(numbers[i]);
+    }
+}
+
+// -----------------------------------------------------------------------------
+template <ActFunc actFunc>
+void gradientKernel(const double *outputs, double *errors, const std::size_t count) noexcept {
+    for (std::size_t i{}; i < count; ++i) {
+        errors[i] *= Kernel<actFunc>::gradient(outputs[i]);
+    }
+}
+
+// -----------------------------------------------------------------------------
+template <ActFunc actFunc>
+void denseKernel(const double *input, const double *weights, const double *bias, double *output,
+                 const std::size_t nodeCount, const std::size_t weightCount) noexcept {
+    // Calculate four nodes at a time, so each input is loaded once per four rows of weights,
+    // and pass each sum through the activation function while it is still in a register.
+    // Each sum is accumulated in the same order as in the scalar dense kernel.
+    std::size_t i{};
+    for (; i + 4U <= nodeCount; i += 4U) {
+        const auto *weights0{weights + i * weightCount};
+        const auto *weights1{weights0 + weightCount};
+        const auto *weights2{weights1 + weightCount};
+        const auto *weights3{weights2 + weightCount};
+        auto sum0{bias[i]}, sum1{bias[i + 1U]}, sum2{bias[i + 2U]}, sum3{bias[i + 3U]};
+        for (std::size_t j{}; j < weightCount; ++j) {
+            const auto value{input[j]};
+            sum0 += value * weights0[j];
+            sum1 += value * weights1[j];
+            sum2 += value * weights2[j];
+            sum3 += value * weights3[j];
+        }
+        output[i] = Kernel<actFunc>::output(sum0);
+        output[i + 1U] = Kernel<actFunc>::output(sum1);
+        output[i + 2U] = Kernel<actFunc>::output(sum2);
+        output[i + 3U] = Kernel<actFunc>::output(sum3);
+    }
+
+    // Calculate the remaining nodes one at a time.
+    for (; i < nodeCount; ++i) {
+        const auto *row{weights + i * weightCount};
+        auto sum{bias[i]};
+        for (std::size_t j{}; j < weightCount; ++j) {
+            sum += input[j] * row[j];
+        }
+        output[i] = Kernel<actFunc>::output(sum);
+    }
+}
+
+// -----------------------------------------------------------------------------
+void softmax(double *numbers, const std::size_t count) noexcept {
+    if (count == 0U) { return; }
+
+    // Subtract the largest number before exponentiating to avoid overflow.
+    const auto max{*std::max_element(numbers, numbers + count)};
+    double sum{};
+
+    for (std::size_t i{}; i < count; ++i) {
+        numbers[i] = std::exp(numbers[i] - max);
+        sum += numbers[i];
+    }
+    for (std::size_t i{}; i < count; ++i) {
+        numbers[i] /= sum;
+    }
+}
+
+// -----------------------------------------------------------------------------
+void softmaxDense(const double *input, const double *weights, const double *bias, double *output,
+                  const std::size_t nodeCount, const std::size_t weightCount) noexcept {
+    // Softmax normalizes over all nodes, so it is applied once all sums are complete.
+    denseKernel<ActFunc::Linear>(input, weights, bias, output, nodeCount, weightCount);
+    softmax(output, nodeCount);
+}
+
+// -----------------------------------------------------------------------------
+void keepErrors(const double *, double *, const std::size_t) noexcept {}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+ActFuncKernels actFuncKernels(const ActFunc actFunc) {
     switch (actFunc) {
     case ActFunc::Relu:
-        return utils::math::reluGradient(number);
+        return {outputKernel<ActFunc::Relu>, gradientKernel<ActFunc::Relu>,
+                denseKernel<ActFunc::Relu>};
     case ActFunc::Tanh:
-        return utils::math::tanhGradient(number);
+        return {outputKernel<ActFunc::Tanh>, gradientKernel<ActFunc::Tanh>,
+                denseKernel<ActFunc::Tanh>};
+    case ActFunc::Linear:
+        return {outputKernel<ActFunc::Linear>, gradientKernel<ActFunc::Linear>,
+                denseKernel<ActFunc::Linear>};
+    case ActFunc::Sigmoid:
+        return {outputKernel<ActFunc::Sigmoid>, gradientKernel<ActFunc::Sigmoid>,
+                denseKernel<ActFunc::Sigmoid>};
+    case ActFunc::LeakyRelu:
+        return {outputKernel<ActFunc::LeakyRelu>, gradientKernel<ActFunc::LeakyRelu>,
+                denseKernel<ActFunc::LeakyRelu>};
+    case ActFunc::Softmax:
+        return {softmax, keepErrors, softmaxDense};
     default:
         throw std::invalid_argument("Invalid activation function!\n");
     }
 }
 
+// -----------------------------------------------------------------------------
+double actFuncOutput(const ActFunc actFunc, const double number) {
+    double output{};
+    dispatch(actFunc, [&](auto kernel) { output = kernel.output(number); });
+    return output;
+}
+
+// -----------------------------------------------------------------------------
+void actFuncOutput(const ActFunc actFunc, double *numbers, const std::size_t count) {
+    actFuncKernels(actFunc).output(numbers, count);
+}
+
+// -----------------------------------------------------------------------------
+double actFuncGradient(const ActFunc actFunc, const double output) {
+    double gradient{};
+    dispatch(actFunc, [&](auto kernel) { gradient = kernel.gradient(output); });
+    return gradient;
+}
+
+// -----------------------------------------------------------------------------
+void actFuncGradient(const ActFunc actFunc, const double *outputs, double *errors,
+                     const std::size_t count) {
+    // The softmax gradient kernel is only valid with the fused cross-entropy gradient.
+    if (actFunc == ActFunc::Softmax) {
+        throw std::invalid_argument("Softmax cannot be applied element-wise!\n");
+    }
+    actFuncKernels(actFunc).gradient(outputs, errors, count);
+}
+
 // -----------------------------------------------------------------------------
 const char *actFuncName(const ActFunc actFunc) {
     switch (actFunc) {
@@ -39,6 +211,14 @@ const char *actFuncName(const ActFunc actFunc) {
         return "Rectified Linear Unit (ReLU)";
     case ActFunc::Tanh:
         return "Hyperbolic tangent (tanh)";
+    case ActFunc::Linear:
+        return "Linear (identity)";
+    case ActFunc::Sigmoid:
+        return "Logistic sigmoid";
+    case ActFunc::LeakyRelu:
+        return "Leaky Rectified Linear Unit (leaky ReLU)";
+    case ActFunc::Softmax:
+        return "Softmax";
     default:
         throw std::invalid_argument("Invalid activation function!\n");
     }
@@ -0,0 +1,60 @@
+/*******************************************************************************
+ * @brief Implementation details of the ml::Arena class.
+ ******************************************************************************/
+#include <algorithm>
+#include <stdexcept>
+
+#include "arena.h"
+
+namespace ml {
+
+// -----------------------------------------------------------------------------
+Arena::Arena(const std::size_t size) : myData{}, mySize{size} {
+    if (size == 0U) { return; }
+    auto *data{static_cast<double *>(
+        ::operator new[](alignedCount(size) * sizeof(double), std::align_val_t{Alignment}))};
+    std::fill(data, data + size, 0.0);
+    myData.reset(data);
+}
+
+// -----------------------------------------------------------------------------
+Arena::Arena(const Arena &other) : Arena{other.mySize} {
+    std::copy(other.data(), other.data() + mySize, data());
+}
+
+// -----------------------------------------------------------------------------
+Arena::Arena(Arena &&other) noexcept : myData{std::move(other.myData)}, mySize{other.mySize} {
+    other.mySize = 0U;
+}
+
+// -----------------------------------------------------------------------------
+Arena &Arena::operator=(const Arena &other) {
+    // Copy in place, so pointers into the arena stay valid.
+    if (other.mySize != mySize) {
+        throw std::invalid_argument("Cannot copy arenas of different sizes!");
+    }
+    std::copy(other.data(), other.data() + mySize, data());
+    return *this;
+}
+
+// -----------------------------------------------------------------------------
+Arena &Arena::operator=(Arena &&other) noexcept {
+    myData = std::move(other.myData);
+    mySize = other.mySize;
+    other.mySize = 0U;
+    return *this;
+}
+
+// -----------------------------------------------------------------------------
+double *Arena::data() noexcept { return myData.get(); }
+
+// -----------------------------------------------------------------------------
+const double *Arena::data() const noexcept { return myData.get(); }
+
+// -----------------------------------------------------------------------------
+std::size_t Arena::size() const noexcept { return mySize; }
+
+// -----------------------------------------------------------------------------
+std::size_t Arena::byteCount() const noexcept { return alignedCount(mySize) * sizeof(double); }
+
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,164 @@
+/********************************************************************************
+ * @brief Implementation details of the blink and software PWM service.
+ ********************************************************************************/
+#include <algorithm>
+#include <cerrno>
+#include <ctime>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "blink_service.h"
+
+namespace rpi {
+namespace {
+
+constexpr std::uint64_t NsPerMs{1000000U};        // Nanoseconds per millisecond.
+constexpr std::uint64_t NsPerSecond{1000000000U}; // Nanoseconds per second.
+
+// -----------------------------------------------------------------------------
+std::uint64_t monotonicNs() noexcept {
+    timespec time{};
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<std::uint64_t>(time.tv_sec) * NsPerSecond +
+           static_cast<std::uint64_t>(time.tv_nsec);
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+BlinkService::BlinkService()
+    : myMutex{}, myChannels{}, myEpollFd{epoll_create1(EPOLL_CLOEXEC)},
+      myTimerFd{timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)},
+      myEventFd{eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC)}, myStop{false}, myThread{} {
+    // Monitor the timer and the wake-up event, throw an exception on failure.
+    epoll_event timerEvent{}, wakeEvent{};
+    timerEvent.events = wakeEvent.events = EPOLLIN;
+    timerEvent.data.fd = myTimerFd;
+    wakeEvent.data.fd = myEventFd;
+
+    if ((myEpollFd < 0) || (myTimerFd < 0) || (myEventFd < 0) ||
+        (epoll_ctl(myEpollFd, EPOLL_CTL_ADD, myTimerFd, &timerEvent) != 0) ||
+        (epoll_ctl(myEpollFd, EPOLL_CTL_ADD, myEventFd, &wakeEvent) != 0)) {
+        for (const auto fd : {myEpollFd, myTimerFd, myEventFd}) {
+            if (fd >= 0) { close(fd); }
+        }
+        throw std::runtime_error("Failed to create timer for blink service!");
+    }
+    myThread = std::thread{&BlinkService::run, this};
+}
+
+// -----------------------------------------------------------------------------
+BlinkService::~BlinkService() noexcept {
+    myStop = true;
+    wake();
+    myThread.join();
+
+    for (auto &channel : myChannels) {
+        channel.led->write(false);
+    }
+    close(myEventFd);
+    close(myTimerFd);
+    close(myEpollFd);
+}
+
+// -----------------------------------------------------------------------------
+void BlinkService::setPattern(Led &led, const std::uint32_t periodMs, const double dutyCycle) {
+    // Throw an exception if any parameter is invalid.
+    if (periodMs == 0U) {
+        throw std::invalid_argument("The blink period must exceed 0 ms!");
+    }
+    if ((dutyCycle < 0.0) || (dutyCycle > 1.0)) {
+        throw std::invalid_argument("The duty cycle must be in the range 0.0 - 1.0!");
+    }
+    const auto periodNs{periodMs * NsPerMs};
+    const auto onNs{static_cast<std::uint64_t>(periodNs * dutyCycle + 0.5)};
+    const auto offNs{periodNs - onNs};
+    {
+        std::lock_guard<std::mutex> lock{myMutex};
+        auto channel{std::find_if(myChannels.begin(), myChannels.end(),
+                                  [&led](const Channel &channel) { return channel.led == &led; })};
+        if (channel == myChannels.end()) {
+            myChannels.push_back({&led, 0U, 0U, 0U});
+            channel = myChannels.end() - 1;
+        }
+
+        // Start each period with the LED on, steady patterns never need a toggle.
+        led.write(onNs > 0U);
+        channel->onNs = onNs;
+        channel->offNs = offNs;
+        channel->nextNs = (onNs > 0U) && (offNs > 0U) ? monotonicNs() + onNs : 0U;
+    }
+    wake();
+}
+
+// -----------------------------------------------------------------------------
+void BlinkService::clearPattern(Led &led, const bool value) {
+    {
+        std::lock_guard<std::mutex> lock{myMutex};
+        myChannels.erase(std::remove_if(myChannels.begin(), myChannels.end(),
+                                        [&led](const Channel &channel) {
+                                            return channel.led == &led;
+                                        }),
+                         myChannels.end());
+        led.write(value);
+    }
+    wake();
+}
+
+// -----------------------------------------------------------------------------
+std::size_t BlinkService::ledCount() const {
+    std::lock_guard<std::mutex> lock{myMutex};
+    return myChannels.size();
+}
+
+// -----------------------------------------------------------------------------
+std::uint64_t BlinkService::update(const std::uint64_t nowNs) {
+    std::lock_guard<std::mutex> lock{myMutex};
+    std::uint64_t nextNs{};
+
+    for (auto &channel : myChannels) {
+        if (channel.nextNs == 0U) { continue; }
+
+        // Toggle the LED when due, restart the pattern if we have fallen behind.
+        if (nowNs >= channel.nextNs) {
+            channel.led->toggle();
+            const auto duration{channel.led->isEnabled() ? channel.onNs : channel.offNs};
+            channel.nextNs = nowNs - channel.nextNs < duration ? channel.nextNs + duration
+                                                               : nowNs + duration;
+        }
+        if ((nextNs == 0U) || (channel.nextNs < nextNs)) { nextNs = channel.nextNs; }
+    }
+    return nextNs;
+}
+
+// -----------------------------------------------------------------------------
+void BlinkService::wake() noexcept {
+    const std::uint64_t value{1U};
+    [[maybe_unused]] const auto result{::write(myEventFd, &value, sizeof(value))};
+}
+
+// -----------------------------------------------------------------------------
+void BlinkService::run() {
+    while (!myStop) {
+        // Arm the timer for the next toggle, or disarm it if nothing is blinking.
+        const auto nextNs{update(monotonicNs())};
+        itimerspec timer{};
+        timer.it_value.tv_sec = static_cast<time_t>(nextNs / NsPerSecond);
+        timer.it_value.tv_nsec = static_cast<long>(nextNs % NsPerSecond);
+        timerfd_settime(myTimerFd, TFD_TIMER_ABSTIME, &timer, nullptr);
+
+        // Sleep until the timer expires or a pattern changes.
+        epoll_event events[2U];
+        const auto eventCount{epoll_wait(myEpollFd, events, 2, -1)};
+
+        for (int i{}; i < eventCount; ++i) {
+            std::uint64_t value{};
+            [[maybe_unused]] const auto result{::read(events[i].data.fd, &value, sizeof(value))};
+        }
+    }
+}
+
+} // namespace rpi
\ No newline at end of file
@@ -1,33 +1,43 @@
 /********************************************************************************
  * @brief Implementation details of the Raspberry Pi button driver.
  ********************************************************************************/
-#include <gpiod.h>
+#include <chrono>
+#include <thread>
 
 #include "button.h"
-#include "gpiod_utils.h"
 
 namespace rpi {
 
 // -----------------------------------------------------------------------------
-Button::Button(const std::uint8_t pin, const bool activeHigh) noexcept
-    : myLine{gpiod_line_new(pin, GPIOD_LINE_DIRECTION_IN)}, myActiveHigh{activeHigh},
-      myLastInput{!myActiveHigh} {}
+Button::Button(const std::uint8_t pin, const bool activeHigh, gpio::Backend &backend) noexcept
+    : myBackend{backend}, myPin{pin}, myActiveHigh{activeHigh}, myLastInput{!myActiveHigh} {
+    myBackend.requestLine(myPin, gpio::Direction::In);
+}
 
 // -----------------------------------------------------------------------------
-Button::~Button() noexcept { gpiod_line_release(myLine); }
+Button::~Button() noexcept { myBackend.releaseLine(myPin); }
 
 // -----------------------------------------------------------------------------
-std::uint8_t Button::pin() const noexcept { return gpiod_line_offset(myLine); }
+std::uint8_t Button::pin() const noexcept { return myPin; }
 
 // -----------------------------------------------------------------------------
 bool Button::isPressed() noexcept {
-    myLastInput = gpiod_line_get_value(myLine);
+    myLastInput = myBackend.read(myPin);
     return myActiveHigh ? myLastInput : !myLastInput;
 }
 
 // -----------------------------------------------------------------------------
 bool Button::isEventDetected(const Edge edge) noexcept {
-    return gpiod_line_event_detected(myLine, static_cast<gpiod_line_edge>(edge), &myLastInput);
+    // Wait for contact bounces to settle before sampling the input.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const auto oldInput{myLastInput};
+    const auto newInput{myBackend.read(myPin)};
+    myLastInput = newInput;
+
+    if (oldInput == newInput) { return false; }
+    if (edge == Edge::Rising) { return newInput && !oldInput; }
+    if (edge == Edge::Falling) { return !newInput && oldInput; }
+    return true;
 }
 
 } // namespace rpi
\ No newline at end of file
@@ -0,0 +1,141 @@
+/*******************************************************************************
+ * @brief Implementation details of the ml::CheckpointWriter class.
+ ******************************************************************************/
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "checkpoint_writer.h"
+
+namespace ml {
+
+// -----------------------------------------------------------------------------
+CheckpointWriter::CheckpointWriter(const std::string &path, const std::size_t epochInterval,
+                                   const std::chrono::milliseconds timeInterval)
+    : myPath{path}, myEpochInterval{epochInterval}, myInterval{timeInterval}, myLastEpoch{},
+      myLastTime{Clock::now()}, myStaging{}, myPending{}, myWriting{}, myHasPending{false},
+      myIsWriting{false}, myStop{false}, myWrittenCount{}, myLostCount{}, myMutex{},
+      myCondition{}, myThread{} {
+    // Throw an exception if checkpoints could never be taken or written.
+    if (path.empty()) {
+        throw std::invalid_argument("Cannot create checkpoint writer without a path!");
+    }
+    if ((epochInterval == 0U) && (timeInterval.count() <= 0)) {
+        throw std::invalid_argument("Cannot create checkpoint writer without an interval!");
+    }
+    myThread = std::thread{&CheckpointWriter::run, this};
+}
+
+// -----------------------------------------------------------------------------
+CheckpointWriter::~CheckpointWriter() noexcept {
+    {
+        std::lock_guard<std::mutex> lock{myMutex};
+        myStop = true;
+    }
+    myCondition.notify_all();
+    if (myThread.joinable()) { myThread.join(); }
+}
+
+// -----------------------------------------------------------------------------
+const std::string &CheckpointWriter::path() const noexcept { return myPath; }
+
+// -----------------------------------------------------------------------------
+bool CheckpointWriter::isDue(const std::size_t epoch) const noexcept {
+    if ((myEpochInterval > 0U) && (epoch >= myLastEpoch + myEpochInterval)) { return true; }
+    return (myInterval.count() > 0) && (Clock::now() - myLastTime >= myInterval);
+}
+
+// -----------------------------------------------------------------------------
+std::size_t CheckpointWriter::lastEpoch() const noexcept { return myLastEpoch; }
+
+// -----------------------------------------------------------------------------
+std::vector<std::uint8_t> &CheckpointWriter::stagingBuffer() noexcept { return myStaging; }
+
+// -----------------------------------------------------------------------------
+void CheckpointWriter::submit(const std::size_t epoch) {
+    myLastEpoch = epoch;
+    myLastTime = Clock::now();
+    {
+        // Replace a checkpoint the I/O thread has not picked up yet.
+        std::lock_guard<std::mutex> lock{myMutex};
+        if (myHasPending) { ++myLostCount; }
+        myPending.swap(myStaging);
+        myHasPending = true;
+    }
+    myCondition.notify_all();
+}
+
+// -----------------------------------------------------------------------------
+void CheckpointWriter::flush() {
+    std::unique_lock<std::mutex> lock{myMutex};
+    myCondition.wait(lock, [this]() { return !myHasPending && !myIsWriting; });
+}
+
+// -----------------------------------------------------------------------------
+std::size_t CheckpointWriter::writtenCount() const {
+    std::lock_guard<std::mutex> lock{myMutex};
+    return myWrittenCount;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t CheckpointWriter::lostCount() const {
+    std::lock_guard<std::mutex> lock{myMutex};
+    return myLostCount;
+}
+
+// -----------------------------------------------------------------------------
+void CheckpointWriter::run() {
+    std::unique_lock<std::mutex> lock{myMutex};
+    while (true) {
+        myCondition.wait(lock, [this]() { return myHasPending || myStop; });
+        if (!myHasPending) { return; }
+
+        // Take the pending checkpoint and write it without holding the mutex.
+        myWriting.swap(myPending);
+        myHasPending = false;
+        myIsWriting = true;
+        lock.unlock();
+        const auto written{write(myWriting)};
+        lock.lock();
+
+        myIsWriting = false;
+        written ? ++myWrittenCount : ++myLostCount;
+        myCondition.notify_all();
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool CheckpointWriter::write(const std::vector<std::uint8_t> &buffer) const {
+    // Write to a temporary file first so the checkpoint file is never partial, and sync it
+    // before the rename so a power loss can't leave an empty checkpoint behind.
+    const auto tempPath{myPath + ".tmp"};
+    const auto fd{::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)};
+    if (fd < 0) { return false; }
+    std::size_t written{};
+    while (written < buffer.size()) {
+        const auto count{::write(fd, buffer.data() + written, buffer.size() - written)};
+        if (count < 0) {
+            if (errno == EINTR) { continue; }
+            break;
+        }
+        written += static_cast<std::size_t>(count);
+    }
+    const auto isSynced{(written == buffer.size()) && (::fsync(fd) == 0)};
+    if ((::close(fd) != 0) || !isSynced) { return false; }
+    if (std::rename(tempPath.c_str(), myPath.c_str()) != 0) { return false; }
+
+    // Sync the directory as well, so the rename itself survives a power loss.
+    const auto separator{myPath.find_last_of('/')};
+    const auto directory{separator == std::string::npos ? std::string{"."}
+                                                         : myPath.substr(0U, separator + 1U)};
+    const auto directoryFd{::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)};
+    if (directoryFd >= 0) {
+        ::fsync(directoryFd);
+        ::close(directoryFd);
+    }
+    return true;
+}
+
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,151 @@
+/*******************************************************************************
+ * @brief Implementation details of the ml::CsrMatrix class.
+ ******************************************************************************/
+#include <stdexcept>
+#include <utility>
+
+#include "csr_matrix.h"
+
+namespace ml {
+
+// -----------------------------------------------------------------------------
+CsrMatrix::CsrMatrix(const double *dense, const std::size_t rowCount,
+                     const std::size_t columnCount)
+    : myRowStart{}, myColumns{}, myValues{}, myColumnCount{columnCount} {
+    myRowStart.reserve(rowCount + 1U);
+    myRowStart.push_back(0U);
+
+    // Store the non-zero entries row by row.
+    for (std::size_t i{}; i < rowCount; ++i) {
+        const auto *row{dense + i * columnCount};
+        for (std::size_t j{}; j < columnCount; ++j) {
+            if (row[j] != 0.0) {
+                myColumns.push_back(static_cast<std::uint32_t>(j));
+                myValues.push_back(row[j]);
+            }
+        }
+        myRowStart.push_back(static_cast<std::uint32_t>(myValues.size()));
+    }
+}
+
+// -----------------------------------------------------------------------------
+CsrMatrix::CsrMatrix(const std::size_t columnCount, std::vector<std::uint32_t> rowStart,
+                     std::vector<std::uint32_t> columns, std::vector<double> values)
+    : myRowStart{std::move(rowStart)}, myColumns{std::move(columns)}, myValues{std::move(values)},
+      myColumnCount{columnCount} {
+    // Throw an exception if the arrays don't describe a valid matrix.
+    if (myRowStart.empty() || (myRowStart.front() != 0U) ||
+        (myRowStart.back() != myValues.size()) || (myColumns.size() != myValues.size())) {
+        throw std::invalid_argument("Invalid CSR matrix arrays!");
+    }
+    for (std::size_t i{}; i + 1U < myRowStart.size(); ++i) {
+        if (myRowStart[i] > myRowStart[i + 1U]) {
+            throw std::invalid_argument("Invalid CSR matrix arrays!");
+        }
+    }
+    for (const auto column : myColumns) {
+        if (column >= myColumnCount) { throw std::invalid_argument("Invalid CSR matrix arrays!"); }
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t CsrMatrix::rowCount() const noexcept {
+    return myRowStart.empty() ? 0U : myRowStart.size() - 1U;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t CsrMatrix::columnCount() const noexcept { return myColumnCount; }
+
+// -----------------------------------------------------------------------------
+std::size_t CsrMatrix::nonZeroCount() const noexcept { return myValues.size(); }
+
+// -----------------------------------------------------------------------------
+std::size_t CsrMatrix::byteCount() const noexcept {
+    return myRowStart.size() * sizeof(std::uint32_t) + myColumns.size() * sizeof(std::uint32_t) +
+           myValues.size() * sizeof(double);
+}
+
+// -----------------------------------------------------------------------------
+const std::vector<std::uint32_t> &CsrMatrix::rowStart() const noexcept { return myRowStart; }
+
+// -----------------------------------------------------------------------------
+const std::vector<std::uint32_t> &CsrMatrix::columns() const noexcept { return myColumns; }
+
+// -----------------------------------------------------------------------------
+const std::vector<double> &CsrMatrix::values() const noexcept { return myValues; }
+
+// -----------------------------------------------------------------------------
+void CsrMatrix::multiplyAdd(const double *input, double *output) const noexcept {
+    const auto *columns{myColumns.data()};
+    const auto *values{myValues.data()};
+
+    // Accumulate the contribution of each stored entry of each row.
+    for (std::size_t i{}; i < rowCount(); ++i) {
+        auto sum{output[i]};
+        for (auto k{myRowStart[i]}; k < myRowStart[i + 1U]; ++k) {
+            sum += values[k] * input[columns[k]];
+        }
+        output[i] = sum;
+    }
+}
+
+// -----------------------------------------------------------------------------
+void CsrMatrix::multiplyTransposeAdd(const double *input, double *output) const noexcept {
+    const auto *columns{myColumns.data()};
+    const auto *values{myValues.data()};
+
+    // Scatter the contribution of each row to the outputs of its stored columns.
+    for (std::size_t i{}; i < rowCount(); ++i) {
+        const auto scale{input[i]};
+        for (auto k{myRowStart[i]}; k < myRowStart[i + 1U]; ++k) {
+            output[columns[k]] += values[k] * scale;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void CsrMatrix::addOuterProduct(const double *rowScale, const double factor,
+                                const double *input) noexcept {
+    const auto *columns{myColumns.data()};
+    auto *values{myValues.data()};
+
+    // Update the stored entries only, pruned entries stay zero.
+    for (std::size_t i{}; i < rowCount(); ++i) {
+        const auto scale{rowScale[i] * factor};
+        for (auto k{myRowStart[i]}; k < myRowStart[i + 1U]; ++k) {
+            values[k] += scale * input[columns[k]];
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void CsrMatrix::scatter(double *dense) const noexcept {
+    for (std::size_t i{}; i < rowCount(); ++i) {
+        auto *row{dense + i * myColumnCount};
+        for (auto k{myRowStart[i]}; k < myRowStart[i + 1U]; ++k) {
+            row[myColumns[k]] = myValues[k];
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void CsrMatrix::gather(const double *dense) noexcept {
+    for (std::size_t i{}; i < rowCount(); ++i) {
+        const auto *row{dense + i * myColumnCount};
+        for (auto k{myRowStart[i]}; k < myRowStart[i + 1U]; ++k) {
+            myValues[k] = row[myColumns[k]];
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void CsrMatrix::addMasked(const double *dense) noexcept {
+    for (std::size_t i{}; i < rowCount(); ++i) {
+        const auto *row{dense + i * myColumnCount};
+        for (auto k{myRowStart[i]}; k < myRowStart[i + 1U]; ++k) {
+            myValues[k] += row[myColumns[k]];
+        }
+    }
+}
+
+} // namespace ml
\ No newline at end of file
@@ -1,15 +1,43 @@
 /*******************************************************************************
  * @brief Implementation details of the ml::DenseLayer class.
  ******************************************************************************/
+#include <algorithm>
+#include <stdexcept>
+
+#include "arena.h"
 #include "dense_layer.h"
 #include "utils.h"
 
 namespace ml {
+namespace {
+
+// -----------------------------------------------------------------------------
+constexpr std::size_t indexOf(const KernelPhase phase) noexcept {
+    return static_cast<std::size_t>(phase);
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+std::size_t DenseLayer::parameterCount(const std::size_t nodeCount,
+                                       const std::size_t weightCount) noexcept {
+    // The bias first, then the weights, each starting on a new cache line.
+    return Arena::alignedCount(nodeCount) + Arena::alignedCount(nodeCount * weightCount);
+}
+
+// -----------------------------------------------------------------------------
+std::size_t DenseLayer::activationCount(const std::size_t nodeCount) noexcept {
+    // The output first, then the error, each starting on a new cache line.
+    return 2U * Arena::alignedCount(nodeCount);
+}
 
 // -----------------------------------------------------------------------------
 DenseLayer::DenseLayer(const std::size_t nodeCount, const std::size_t weightCount,
-                       const ActFunc actFunc)
-    : myOutput(nodeCount, 0.0), myError(nodeCount, 0.0), myBias{}, myWeights{}, myActFunc{actFunc} {
+                       const ActFunc actFunc, double *parameters, double *activations)
+    : myNodeCount{nodeCount}, myWeightCount{weightCount}, myOutput{activations},
+      myError{activations + Arena::alignedCount(nodeCount)}, myBias{parameters},
+      myWeights{parameters + Arena::alignedCount(nodeCount)}, mySparseWeights{},
+      mySparse{false}, myActFunc{actFunc}, myActKernels{}, myKernels{} {
     // Throw an exception if any parameter is invalid.
     if (nodeCount == 0U) {
         throw std::invalid_argument("Cannot create dense layer without nodes!");
@@ -20,133 +48,445 @@ DenseLayer::DenseLayer(const std::size_t nodeCount, const std::size_t weightCoun
     if (actFunc >= ActFunc::Count) {
         throw std::invalid_argument("Invalid activation function!");
     }
+    if (!parameters || !activations) {
+        throw std::invalid_argument("Cannot create dense layer without memory!");
+    }
+    myActKernels = actFuncKernels(actFunc);
 
-    // Initialize node biases and weights with random values between 0.0 - 1.0
-    utils::vector::initRandom<double>(myBias, nodeCount, 0.0, 1.0);
-    utils::vector::initRandom<double>(myWeights, nodeCount, weightCount, 0.0, 1.0);
+    // Initialize node biases and weights with random values between -1.0 - 1.0, symmetric
+    // around zero so that saturating activation functions start in their linear range.
+    for (std::size_t i{}; i < nodeCount; ++i) {
+        myBias[i] = utils::random::getNumber<double>(-1.0, 1.0);
+    }
+    for (std::size_t i{}; i < nodeCount * weightCount; ++i) {
+        myWeights[i] = utils::random::getNumber<double>(-1.0, 1.0);
+    }
 }
 
 // -----------------------------------------------------------------------------
-const std::vector<double> &DenseLayer::output() const { return myOutput; }
+const double *DenseLayer::output() const { return myOutput; }
+
+// -----------------------------------------------------------------------------
+const double *DenseLayer::error() const { return myError; }
 
 // -----------------------------------------------------------------------------
-const std::vector<double> &DenseLayer::error() const { return myError; }
+const double *DenseLayer::bias() const { return myBias; }
 
 // -----------------------------------------------------------------------------
-const std::vector<double> &DenseLayer::bias() const { return myBias; }
+const double *DenseLayer::weights() const { return myWeights; }
 
 // -----------------------------------------------------------------------------
-const std::vector<std::vector<double>> &DenseLayer::weights() const { return myWeights; }
+const CsrMatrix &DenseLayer::sparseWeights() const { return mySparseWeights; }
 
 // -----------------------------------------------------------------------------
 ActFunc DenseLayer::actFunc() const { return myActFunc; }
 
 // -----------------------------------------------------------------------------
-std::size_t DenseLayer::nodeCount() const { return myOutput.size(); }
+std::size_t DenseLayer::nodeCount() const { return myNodeCount; }
+
+// -----------------------------------------------------------------------------
+std::size_t DenseLayer::weightCount() const { return myWeightCount; }
+
+// -----------------------------------------------------------------------------
+bool DenseLayer::isSparse() const { return mySparse; }
+
+// -----------------------------------------------------------------------------
+bool DenseLayer::supportsKernel(const KernelPhase phase,
+                                const KernelVariant variant) const noexcept {
+    if ((phase >= KernelPhase::Count) || (variant >= KernelVariant::Count)) { return false; }
+    if (variant == KernelVariant::Sparse) { return mySparse; }
+    return !mySparse || (phase != KernelPhase::Optimize);
+}
 
 // -----------------------------------------------------------------------------
-std::size_t DenseLayer::weightCount() const {
-    return myWeights.size() > 0U ? myWeights[0U].size() : 0U;
+KernelVariant DenseLayer::kernel(const KernelPhase phase) const noexcept {
+    return phase < KernelPhase::Count ? myKernels[indexOf(phase)] : KernelVariant::Count;
 }
 
 // -----------------------------------------------------------------------------
-void DenseLayer::feedforward(const std::vector<double> &input) {
-    // Throw an exception on mismatch between the input and the shape of the dense layer.
-    if (input.size() != weightCount()) {
-        throw std::invalid_argument(
-            "Feedforward input does not match the shape of the dense layer!");
+void DenseLayer::setKernel(const KernelPhase phase, const KernelVariant variant) {
+    if (!supportsKernel(phase, variant)) {
+        throw std::invalid_argument("Kernel variant not supported by the dense layer!");
     }
+    myKernels[indexOf(phase)] = variant;
+}
 
-    // Calculate new output for each node.
-    for (std::size_t i{}; i < nodeCount(); ++i) {
-        auto sum{myBias[i]};
+// -----------------------------------------------------------------------------
+std::size_t DenseLayer::nonZeroCount() const {
+    if (mySparse) { return mySparseWeights.nonZeroCount(); }
+    return static_cast<std::size_t>(
+        std::count_if(myWeights, myWeights + myNodeCount * myWeightCount,
+                      [](const double weight) { return weight != 0.0; }));
+}
 
-        // Accumulate the node bias value and the contribution from each input.
-        for (std::size_t j{}; j < weightCount(); ++j) {
-            sum += input[j] * myWeights[i][j];
+// -----------------------------------------------------------------------------
+std::size_t DenseLayer::parameterBytes() const {
+    const auto weightBytes{mySparse ? mySparseWeights.byteCount()
+                                    : nodeCount() * weightCount() * sizeof(double)};
+    return nodeCount() * sizeof(double) + weightBytes;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t DenseLayer::prune(const double threshold) {
+    // Zero the weights whose magnitude is below the threshold.
+    std::size_t prunedCount{};
+    for (auto *weight{myWeights}; weight < myWeights + myNodeCount * myWeightCount; ++weight) {
+        if ((*weight != 0.0) && (utils::math::absoluteValue(*weight) < threshold)) {
+            *weight = 0.0;
+            ++prunedCount;
         }
+    }
+
+    // Keep the remaining weights in CSR format for the sparse kernels.
+    mySparseWeights = CsrMatrix{myWeights, myNodeCount, myWeightCount};
+    mySparse = true;
+    myKernels.fill(KernelVariant::Sparse);
+    return prunedCount;
+}
 
-        // Pass accumulated value through the activation function filter.
-        myOutput[i] = actFuncOutput(myActFunc, sum);
+// -----------------------------------------------------------------------------
+void DenseLayer::setParameters(const std::vector<double> &bias,
+                               const std::vector<double> &weights) {
+    // Throw an exception on mismatch between the parameters and the shape of the dense layer.
+    if ((bias.size() != nodeCount()) || (weights.size() != nodeCount() * weightCount())) {
+        throw std::invalid_argument("Parameters do not match the shape of the dense layer!");
     }
+    std::copy(bias.begin(), bias.end(), myBias);
+    std::copy(weights.begin(), weights.end(), myWeights);
+    mySparseWeights = CsrMatrix{};
+    mySparse = false;
+    myKernels.fill(KernelVariant::Scalar);
 }
 
 // -----------------------------------------------------------------------------
-void DenseLayer::backpropagate(const std::vector<double> &reference) {
-    // Throw an exception on mismatch between the reference and the shape of the dense layer.
-    if (reference.size() != nodeCount()) {
-        throw std::invalid_argument(
-            "Backpropagation reference does not match the shape of the dense layer!");
+void DenseLayer::setParameters(const std::vector<double> &bias, const CsrMatrix &sparseWeights) {
+    // Throw an exception on mismatch between the parameters and the shape of the dense layer.
+    if ((bias.size() != nodeCount()) || (sparseWeights.rowCount() != nodeCount()) ||
+        (sparseWeights.columnCount() != weightCount())) {
+        throw std::invalid_argument("Parameters do not match the shape of the dense layer!");
     }
+    std::copy(bias.begin(), bias.end(), myBias);
+    mySparseWeights = sparseWeights;
+    mySparse = true;
+    myKernels.fill(KernelVariant::Sparse);
 
-    // Calculate the error for each node.
-    for (std::size_t i{}; i < nodeCount(); ++i) {
-        // Calculate the error by comparing the reference and predicted values.
-        const auto error{reference[i] - myOutput[i]};
+    // Keep the dense copy in sync, as after optimization.
+    std::fill(myWeights, myWeights + myNodeCount * myWeightCount, 0.0);
+    mySparseWeights.scatter(myWeights);
+}
 
-        // Pass calculated error value through the activation function filter.
-        myError[i] = error * actFuncGradient(myActFunc, myOutput[i]);
-    }
+// -----------------------------------------------------------------------------
+void DenseLayer::place(double *parameters, double *activations) noexcept {
+    myBias = parameters;
+    myWeights = parameters + Arena::alignedCount(myNodeCount);
+    placeActivations(activations);
+}
+
+// -----------------------------------------------------------------------------
+void DenseLayer::placeActivations(double *activations) noexcept {
+    myOutput = activations;
+    myError = activations + Arena::alignedCount(myNodeCount);
+}
+
+// -----------------------------------------------------------------------------
+void DenseLayer::reloadSparseWeights() noexcept {
+    if (mySparse) { mySparseWeights.gather(myWeights); }
 }
 
 // -----------------------------------------------------------------------------
-void DenseLayer::backpropagate(const DenseLayer &nextLayer) {
-    // Throw an exception on mismatch between the shapes of the dense layers.
-    if (nextLayer.weightCount() != nodeCount()) {
-        throw std::invalid_argument(
-            "The shape of the next layer does not match the current layer!");
+void DenseLayer::feedforward(const double *input) noexcept {
+    // The blocked kernel passes each node through the activation function as it completes.
+    if (myKernels[indexOf(KernelPhase::Feedforward)] == KernelVariant::Blocked) {
+        myActKernels.dense(input, myWeights, myBias, myOutput, myNodeCount, myWeightCount);
+        return;
     }
 
-    // Calculate the error for each node.
-    for (std::size_t i{}; i < nodeCount(); ++i) {
-        double error{};
+    // The sparse kernel of pruned layers scales with the non-zeros.
+    if (myKernels[indexOf(KernelPhase::Feedforward)] == KernelVariant::Sparse) {
+        std::copy(myBias, myBias + myNodeCount, myOutput);
+        mySparseWeights.multiplyAdd(input, myOutput);
+    } else {
+        // Calculate new output for each node.
+        for (std::size_t i{}; i < nodeCount(); ++i) {
+            const auto *weights{myWeights + i * myWeightCount};
+            auto sum{myBias[i]};
 
-        // Accumulate the error by using weights and error values of next layer.
-        for (std::size_t j{}; j < nextLayer.nodeCount(); ++j) {
-            error += nextLayer.error()[j] * nextLayer.weights()[j][i];
+            // Accumulate the node bias value and the contribution from each input.
+            for (std::size_t j{}; j < weightCount(); ++j) {
+                sum += input[j] * weights[j];
+            }
+            myOutput[i] = sum;
         }
+    }
+
+    // Pass the accumulated values through the activation function filter.
+    myActKernels.output(myOutput, nodeCount());
+}
 
-        // Pass calculated error value through the activation function filter.
-        myError[i] = error * actFuncGradient(myActFunc, myOutput[i]);
+// -----------------------------------------------------------------------------
+void DenseLayer::feedforward(const double *input, double *output,
+                             const std::size_t sampleCount) const noexcept {
+    // Use the sparse kernel for pruned layers, one set at a time.
+    if (mySparse) {
+        for (std::size_t k{}; k < sampleCount; ++k) {
+            auto *sampleOutput{output + k * myNodeCount};
+            std::copy(myBias, myBias + myNodeCount, sampleOutput);
+            mySparseWeights.multiplyAdd(input + k * myWeightCount, sampleOutput);
+        }
+    } else {
+        // Run each node over the whole batch while its weights are in cache, four sets at a
+        // time sharing each weight load. Each sum is accumulated in the same order as in the
+        // single-set kernel, so the outputs are identical.
+        for (std::size_t i{}; i < nodeCount(); ++i) {
+            const auto *weights{myWeights + i * myWeightCount};
+            std::size_t k{};
+            for (; k + 4U <= sampleCount; k += 4U) {
+                const auto *input0{input + k * myWeightCount};
+                const auto *input1{input0 + myWeightCount};
+                const auto *input2{input1 + myWeightCount};
+                const auto *input3{input2 + myWeightCount};
+                auto sum0{myBias[i]}, sum1{myBias[i]}, sum2{myBias[i]}, sum3{myBias[i]};
+                for (std::size_t j{}; j < weightCount(); ++j) {
+                    sum0 += input0[j] * weights[j];
+                    sum1 += input1[j] * weights[j];
+                    sum2 += input2[j] * weights[j];
+                    sum3 += input3[j] * weights[j];
+                }
+                output[k * myNodeCount + i] = sum0;
+                output[(k + 1U) * myNodeCount + i] = sum1;
+                output[(k + 2U) * myNodeCount + i] = sum2;
+                output[(k + 3U) * myNodeCount + i] = sum3;
+            }
+            for (; k < sampleCount; ++k) {
+                const auto *sampleInput{input + k * myWeightCount};
+                auto sum{myBias[i]};
+                for (std::size_t j{}; j < weightCount(); ++j) {
+                    sum += sampleInput[j] * weights[j];
+                }
+                output[k * myNodeCount + i] = sum;
+            }
+        }
+    }
+
+    // Pass each set through the activation function, softmax normalizes per set.
+    for (std::size_t k{}; k < sampleCount; ++k) {
+        myActKernels.output(output + k * myNodeCount, nodeCount());
     }
 }
 
 // -----------------------------------------------------------------------------
-void DenseLayer::optimize(const std::vector<double> &input, const double learningRate) {
-    // Throw an exception on mismatch between the input and the shape of the dense layer.
-    if (input.size() != weightCount()) {
-        throw std::invalid_argument(
-            "Optimization input does not match the shape of the dense layer!");
+void DenseLayer::backpropagate(const double *reference, const Loss loss) noexcept {
+    // Calculate the error for each node by comparing the reference and predicted values.
+    for (std::size_t i{}; i < nodeCount(); ++i) {
+        myError[i] = reference[i] - myOutput[i];
     }
 
-    // Throw an exception if the learning rate is invalid.
-    if (learningRate <= 0.0) {
-        throw std::invalid_argument("The learning rate must exceed 0!");
+    // Pass the calculated error values through the activation function filter, unless the
+    // gradient is fused with the cross-entropy loss.
+    if (loss == Loss::SquaredError) {
+        myActKernels.gradient(myOutput, myError, nodeCount());
+    }
+}
+
+// -----------------------------------------------------------------------------
+void DenseLayer::backpropagate(const DenseLayer &nextLayer) noexcept {
+    // Pass the error propagated by the next layer through the activation function filter.
+    nextLayer.propagateError(myError);
+    myActKernels.gradient(myOutput, myError, nodeCount());
+}
+
+// -----------------------------------------------------------------------------
+void DenseLayer::backpropagateError(const double *outputError) noexcept {
+    std::copy(outputError, outputError + myNodeCount, myError);
+    myActKernels.gradient(myOutput, myError, nodeCount());
+}
+
+// -----------------------------------------------------------------------------
+void DenseLayer::propagateError(double *inputError) const noexcept {
+    // Accumulate the error of each input as the transposed weights times the error. The weights
+    // are walked row by row in memory order, each row adding its scaled weights to all errors,
+    // so no column-wise stride is needed.
+    std::fill(inputError, inputError + myWeightCount, 0.0);
+
+    if (myKernels[indexOf(KernelPhase::Backpropagate)] == KernelVariant::Sparse) {
+        mySparseWeights.multiplyTransposeAdd(myError, inputError);
+    } else if (myKernels[indexOf(KernelPhase::Backpropagate)] == KernelVariant::Blocked) {
+        propagateErrorBlocked(inputError);
+    } else {
+        for (std::size_t j{}; j < nodeCount(); ++j) {
+            const auto scale{myError[j]};
+            const auto *weights{myWeights + j * myWeightCount};
+            for (std::size_t i{}; i < weightCount(); ++i) {
+                inputError[i] += scale * weights[i];
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void DenseLayer::optimize(const double *input, const double learningRate) noexcept {
+    // Update only the remaining weights of pruned layers, keeping the dense copy in sync.
+    if (mySparse) {
+        for (std::size_t i{}; i < nodeCount(); ++i) {
+            myBias[i] += myError[i] * learningRate;
+        }
+        mySparseWeights.addOuterProduct(myError, learningRate, input);
+        mySparseWeights.scatter(myWeights);
+        return;
+    }
+    if (myKernels[indexOf(KernelPhase::Optimize)] == KernelVariant::Blocked) {
+        optimizeBlocked(input, learningRate);
+        return;
     }
 
     // Update the bias and weights for each node.
     for (std::size_t i{}; i < nodeCount(); ++i) {
+        auto *weights{myWeights + i * myWeightCount};
+
         // Update the bias by using calculated error value and the learning rate.
         myBias[i] += myError[i] * learningRate;
 
         // Update each weight by using calculated error, the learning rate and the associated input.
         for (std::size_t j{}; j < weightCount(); ++j) {
-            myWeights[i][j] += myError[i] * learningRate * input[j];
+            weights[j] += myError[i] * learningRate * input[j];
         }
     }
 }
 
+// -----------------------------------------------------------------------------
+void DenseLayer::propagateErrorBlocked(double *inputError) const noexcept {
+    // Add four rows at a time, so each error is loaded and stored once per four rows. The
+    // rows are still added one after another, as in the scalar kernel.
+    std::size_t j{};
+    for (; j + 4U <= nodeCount(); j += 4U) {
+        const auto *weights0{myWeights + j * myWeightCount};
+        const auto *weights1{weights0 + myWeightCount};
+        const auto *weights2{weights1 + myWeightCount};
+        const auto *weights3{weights2 + myWeightCount};
+        const auto scale0{myError[j]}, scale1{myError[j + 1U]};
+        const auto scale2{myError[j + 2U]}, scale3{myError[j + 3U]};
+        for (std::size_t i{}; i < weightCount(); ++i) {
+            auto error{inputError[i]};
+            error += scale0 * weights0[i];
+            error += scale1 * weights1[i];
+            error += scale2 * weights2[i];
+            error += scale3 * weights3[i];
+            inputError[i] = error;
+        }
+    }
+
+    // Add the remaining rows one at a time.
+    for (; j < nodeCount(); ++j) {
+        const auto scale{myError[j]};
+        const auto *weights{myWeights + j * myWeightCount};
+        for (std::size_t i{}; i < weightCount(); ++i) {
+            inputError[i] += scale * weights[i];
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void DenseLayer::optimizeBlocked(const double *input, const double learningRate) noexcept {
+    for (std::size_t i{}; i < nodeCount(); ++i) {
+        myBias[i] += myError[i] * learningRate;
+    }
+
+    // Update four rows at a time, so each input is loaded once per four rows of weights.
+    std::size_t i{};
+    for (; i + 4U <= nodeCount(); i += 4U) {
+        auto *weights0{myWeights + i * myWeightCount};
+        auto *weights1{weights0 + myWeightCount};
+        auto *weights2{weights1 + myWeightCount};
+        auto *weights3{weights2 + myWeightCount};
+        const auto scale0{myError[i] * learningRate}, scale1{myError[i + 1U] * learningRate};
+        const auto scale2{myError[i + 2U] * learningRate};
+        const auto scale3{myError[i + 3U] * learningRate};
+        for (std::size_t j{}; j < weightCount(); ++j) {
+            const auto value{input[j]};
+            weights0[j] += scale0 * value;
+            weights1[j] += scale1 * value;
+            weights2[j] += scale2 * value;
+            weights3[j] += scale3 * value;
+        }
+    }
+
+    // Update the remaining rows one at a time.
+    for (; i < nodeCount(); ++i) {
+        auto *weights{myWeights + i * myWeightCount};
+        for (std::size_t j{}; j < weightCount(); ++j) {
+            weights[j] += myError[i] * learningRate * input[j];
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void DenseLayer::accumulateGradient(const double *input, const double learningRate,
+                                    double *gradient) const noexcept {
+    auto *biasGradient{gradient};
+    auto *weightGradient{gradient + Arena::alignedCount(myNodeCount)};
+
+    // Accumulate the terms of optimize in the same order, so that a single sample gives
+    // exactly the same update.
+    for (std::size_t i{}; i < nodeCount(); ++i) {
+        biasGradient[i] += myError[i] * learningRate;
+    }
+    if (mySparse) {
+        const auto &rowStart{mySparseWeights.rowStart()};
+        const auto &columns{mySparseWeights.columns()};
+        for (std::size_t i{}; i < nodeCount(); ++i) {
+            const auto scale{myError[i] * learningRate};
+            auto *row{weightGradient + i * myWeightCount};
+            for (auto k{rowStart[i]}; k < rowStart[i + 1U]; ++k) {
+                row[columns[k]] += scale * input[columns[k]];
+            }
+        }
+        return;
+    }
+    for (std::size_t i{}; i < nodeCount(); ++i) {
+        auto *row{weightGradient + i * myWeightCount};
+        for (std::size_t j{}; j < weightCount(); ++j) {
+            row[j] += myError[i] * learningRate * input[j];
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void DenseLayer::applyGradient(const double *gradient) noexcept {
+    const auto *weightGradient{gradient + Arena::alignedCount(myNodeCount)};
+    for (std::size_t i{}; i < nodeCount(); ++i) {
+        myBias[i] += gradient[i];
+    }
+
+    // Update only the remaining weights of pruned layers, keeping the dense copy in sync.
+    if (mySparse) {
+        mySparseWeights.addMasked(weightGradient);
+        mySparseWeights.scatter(myWeights);
+        return;
+    }
+    for (std::size_t i{}; i < nodeCount() * weightCount(); ++i) {
+        myWeights[i] += weightGradient[i];
+    }
+}
+
 // -----------------------------------------------------------------------------
 void DenseLayer::print(std::ostream &ostream, const std::size_t decimalCount) const {
     ostream << "--------------------------------------------------------------------------------\n";
+    // Copy the values into vectors for printing, the weights row by row.
+    const auto vectorOf = [](const double *values, const std::size_t count) {
+        return std::vector<double>(values, values + count);
+    };
+    std::vector<std::vector<double>> weights{};
+    for (std::size_t i{}; i < nodeCount(); ++i) {
+        weights.push_back(vectorOf(myWeights + i * myWeightCount, myWeightCount));
+    }
     ostream << "Output:\t\t\t";
-    utils::vector::print(myOutput, ostream, "\n", decimalCount);
+    utils::vector::print(vectorOf(myOutput, myNodeCount), ostream, "\n", decimalCount);
     ostream << "Error:\t\t\t";
-    utils::vector::print(myError, ostream, "\n", decimalCount);
+    utils::vector::print(vectorOf(myError, myNodeCount), ostream, "\n", decimalCount);
     ostream << "Bias:\t\t\t";
-    utils::vector::print(myBias, ostream, "\n", decimalCount);
+    utils::vector::print(vectorOf(myBias, myNodeCount), ostream, "\n", decimalCount);
     ostream << "Weights:\t\t";
-    utils::vector::print(myWeights, ostream, "\n", decimalCount);
+    utils::vector::print(weights, ostream, "\n", decimalCount);
     ostream << "Activation function:\t" << actFuncName(myActFunc) << "\n";
     ostream
         << "--------------------------------------------------------------------------------\n\n";
@@ -0,0 +1,148 @@
+/*******************************************************************************
+ * @brief Implementation details of the ml::Distiller class.
+ ******************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+
+#include "distiller.h"
+#include "utils.h"
+
+namespace ml {
+namespace {
+
+/*******************************************************************************
+ * @brief Minimum time to predict when measuring latency, in nanoseconds.
+ ******************************************************************************/
+constexpr std::int64_t MinTimingNs{20000000};
+
+// -----------------------------------------------------------------------------
+double meanLatencyUs(const InferenceModel &model,
+                     const std::vector<std::vector<double>> &inputs) {
+    // Predict all inputs until enough time has passed to average out timer resolution.
+    auto scratch{model.makeScratch()};
+    std::size_t predictionCount{};
+    const auto startTime{std::chrono::steady_clock::now()};
+    std::chrono::nanoseconds elapsed{};
+    do {
+        for (const auto &input : inputs) { model.predict(input, scratch); }
+        predictionCount += inputs.size();
+        elapsed = std::chrono::steady_clock::now() - startTime;
+    } while (elapsed.count() < MinTimingNs);
+    return utils::math::divide(elapsed.count() / 1e3, predictionCount);
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+void Distiller::Report::print(std::ostream &ostream) const {
+    ostream << "Student fidelity over " << errors.sampleCount() << " inputs:\n";
+    errors.print(ostream);
+    ostream << "Parameter memory: " << teacherBytes << " -> " << studentBytes << " bytes\n";
+    ostream << "Prediction time: " << teacherLatencyUs << " -> " << studentLatencyUs << " us ("
+            << speedup << "x)\n";
+}
+
+// -----------------------------------------------------------------------------
+Distiller::Distiller(const NeuralNetwork &teacher) : myTeacher{teacher.freeze()} {}
+
+// -----------------------------------------------------------------------------
+const InferenceModel &Distiller::teacher() const noexcept { return myTeacher; }
+
+// -----------------------------------------------------------------------------
+std::vector<std::vector<double>>
+Distiller::densify(const std::vector<std::vector<double>> &inputs, const std::size_t count,
+                   const std::uint32_t seed) const {
+    if (inputs.empty()) { throw std::invalid_argument("Cannot densify without inputs!"); }
+    checkInputs(inputs);
+
+    // Find the range of each input value.
+    auto low{inputs[0U]}, high{inputs[0U]};
+    for (const auto &input : inputs) {
+        for (std::size_t i{}; i < input.size(); ++i) {
+            low[i] = std::min(low[i], input[i]);
+            high[i] = std::max(high[i], input[i]);
+        }
+    }
+
+    // Draw each value of the new inputs separately within its range.
+    auto densified{inputs};
+    densified.reserve(inputs.size() + count);
+    std::mt19937 generator{seed};
+    for (std::size_t i{}; i < count; ++i) {
+        std::vector<double> input(low.size());
+        for (std::size_t j{}; j < input.size(); ++j) {
+            input[j] = std::uniform_real_distribution<double>{low[j], high[j]}(generator);
+        }
+        densified.push_back(std::move(input));
+    }
+    return densified;
+}
+
+// -----------------------------------------------------------------------------
+std::vector<std::vector<double>>
+Distiller::label(const std::vector<std::vector<double>> &inputs) const {
+    checkInputs(inputs);
+    std::vector<std::vector<double>> outputs{};
+    outputs.reserve(inputs.size());
+    auto scratch{myTeacher.makeScratch()};
+    for (const auto &input : inputs) { outputs.push_back(myTeacher.predict(input, scratch)); }
+    return outputs;
+}
+
+// -----------------------------------------------------------------------------
+Distiller::Report Distiller::distill(NeuralNetwork &student,
+                                     const std::vector<std::vector<double>> &inputs,
+                                     const std::size_t epochCount,
+                                     const double learningRate) const {
+    // Throw an exception if the student can't be trained to mimic the teacher.
+    if ((student.inputCount() != myTeacher.inputCount()) ||
+        (student.outputCount() != myTeacher.outputCount())) {
+        throw std::invalid_argument("Student does not match the shape of the teacher!");
+    }
+    if (inputs.empty() || (epochCount == 0U) || (learningRate <= 0.0)) {
+        throw std::invalid_argument("Invalid distillation parameters!");
+    }
+    student.addTrainingData(inputs, label(inputs));
+    student.train(epochCount, learningRate);
+    return compare(student.freeze(), inputs);
+}
+
+// -----------------------------------------------------------------------------
+Distiller::Report Distiller::compare(const InferenceModel &student,
+                                     const std::vector<std::vector<double>> &inputs) const {
+    if ((student.inputCount() != myTeacher.inputCount()) ||
+        (student.outputCount() != myTeacher.outputCount())) {
+        throw std::invalid_argument("Student does not match the shape of the teacher!");
+    }
+    checkInputs(inputs);
+    Report report{OutputErrors{myTeacher.outputCount()}, myTeacher.parameterBytes(),
+                  student.parameterBytes(), 0.0, 0.0, 0.0};
+    if (inputs.empty()) { return report; }
+
+    auto teacherScratch{myTeacher.makeScratch()};
+    auto studentScratch{student.makeScratch()};
+    for (const auto &input : inputs) {
+        report.errors.add(myTeacher.predict(input, teacherScratch).data(),
+                          student.predict(input, studentScratch).data());
+    }
+
+    // Time both models on the same inputs, the student is what ships.
+    report.teacherLatencyUs = meanLatencyUs(myTeacher, inputs);
+    report.studentLatencyUs = meanLatencyUs(student, inputs);
+    report.speedup = utils::math::divide(report.teacherLatencyUs, report.studentLatencyUs);
+    return report;
+}
+
+// -----------------------------------------------------------------------------
+void Distiller::checkInputs(const std::vector<std::vector<double>> &inputs) const {
+    for (const auto &input : inputs) {
+        if (input.size() != myTeacher.inputCount()) {
+            throw std::invalid_argument("Input does not match the shape of the teacher!");
+        }
+    }
+}
+
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,233 @@
+/*******************************************************************************
+ * @brief Implementation details of the ml::EnsembleModel class.
+ ******************************************************************************/
+#include <algorithm>
+#include <stdexcept>
+
+#include "ensemble_model.h"
+
+namespace ml {
+namespace {
+
+// -----------------------------------------------------------------------------
+void multiplyAdd(const EnsembleModel::Block &block, const double *input, const double *weights,
+                 double *output) noexcept {
+    const auto n{block.weightCount};
+    std::size_t i{};
+
+    // Four rows at a time, so the sums form independent dependency chains.
+    for (; i + 4U <= block.nodeCount; i += 4U) {
+        const auto *w0{weights + i * n};
+        const auto *w1{w0 + n};
+        const auto *w2{w1 + n};
+        const auto *w3{w2 + n};
+        auto sum0{output[i]}, sum1{output[i + 1U]}, sum2{output[i + 2U]}, sum3{output[i + 3U]};
+        for (std::size_t j{}; j < n; ++j) {
+            const auto x{input[j]};
+            sum0 += x * w0[j];
+            sum1 += x * w1[j];
+            sum2 += x * w2[j];
+            sum3 += x * w3[j];
+        }
+        output[i] = sum0;
+        output[i + 1U] = sum1;
+        output[i + 2U] = sum2;
+        output[i + 3U] = sum3;
+    }
+    for (; i < block.nodeCount; ++i) {
+        const auto *w{weights + i * n};
+        auto sum{output[i]};
+        for (std::size_t j{}; j < n; ++j) {
+            sum += input[j] * w[j];
+        }
+        output[i] = sum;
+    }
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+EnsembleModel::EnsembleModel(const std::vector<InferenceModel> &members, const Combine combine)
+    : myLayers{}, myMemberCount{members.size()}, myInputCount{}, myOutputCount{}, myMaxWidth{},
+      myCombine{combine} {
+    // Throw an exception if the members can't be packed together.
+    if (members.empty()) {
+        throw std::invalid_argument("Cannot create ensemble without members!");
+    }
+    const auto &first{members.front()};
+    for (const auto &member : members) {
+        if ((member.inputCount() != first.inputCount()) ||
+            (member.outputCount() != first.outputCount()) ||
+            (member.layers().size() != first.layers().size())) {
+            throw std::invalid_argument("The shapes of the ensemble members don't match!");
+        }
+    }
+    myInputCount = first.inputCount();
+    myOutputCount = first.outputCount();
+    myMaxWidth = myInputCount;
+
+    // Pack layer i of all members, each block reading the previous block of its member.
+    std::vector<std::size_t> inputOffsets(members.size(), 0U);
+    for (std::size_t i{}; i < first.layers().size(); ++i) {
+        Layer layer{0U, {}, {}, {}};
+
+        for (std::size_t m{}; m < members.size(); ++m) {
+            const auto &source{members[m].layers()[i]};
+
+            // Merge with the previous block if both read the same input with the same
+            // activation, as in the first layer; softmax normalizes each member separately.
+            if (!layer.blocks.empty() && (layer.blocks.back().inputOffset == inputOffsets[m]) &&
+                (layer.blocks.back().weightCount == source.weightCount) &&
+                (layer.blocks.back().actFunc == source.actFunc) &&
+                (source.actFunc != ActFunc::Softmax)) {
+                layer.blocks.back().nodeCount += source.nodeCount;
+            } else {
+                layer.blocks.push_back(Block{layer.nodeCount, source.nodeCount, inputOffsets[m],
+                                             source.weightCount, layer.weights.size(),
+                                             source.actFunc});
+            }
+            layer.bias.insert(layer.bias.end(), source.bias.begin(), source.bias.end());
+
+            // Pruned layers are expanded with zeros.
+            if (source.weights.empty()) {
+                const auto offset{layer.weights.size()};
+                layer.weights.resize(offset + source.nodeCount * source.weightCount, 0.0);
+                source.sparseWeights.scatter(layer.weights.data() + offset);
+            } else {
+                layer.weights.insert(layer.weights.end(), source.weights.begin(),
+                                     source.weights.end());
+            }
+            inputOffsets[m] = layer.nodeCount;
+            layer.nodeCount += source.nodeCount;
+        }
+        myMaxWidth = std::max(myMaxWidth, layer.nodeCount);
+        myLayers.push_back(std::move(layer));
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t EnsembleModel::memberCount() const noexcept { return myMemberCount; }
+
+// -----------------------------------------------------------------------------
+std::size_t EnsembleModel::inputCount() const noexcept { return myInputCount; }
+
+// -----------------------------------------------------------------------------
+std::size_t EnsembleModel::outputCount() const noexcept { return myOutputCount; }
+
+// -----------------------------------------------------------------------------
+EnsembleModel::Combine EnsembleModel::combine() const noexcept { return myCombine; }
+
+// -----------------------------------------------------------------------------
+const std::vector<EnsembleModel::Layer> &EnsembleModel::layers() const noexcept {
+    return myLayers;
+}
+
+// -----------------------------------------------------------------------------
+const std::vector<double> &EnsembleModel::predict(const std::vector<double> &input,
+                                                  Scratch &scratch) const {
+    // Throw an exception on mismatch between the input and the shape of the ensemble.
+    if (input.size() != inputCount()) {
+        throw std::invalid_argument("Prediction input does not match the shape of the ensemble!");
+    }
+    scratch.input.reserve(myMaxWidth);
+    scratch.output.reserve(myMaxWidth);
+    scratch.input.assign(input.begin(), input.end());
+
+    // Feed the input through each packed layer, all members at once.
+    for (const auto &layer : myLayers) {
+        scratch.output.assign(layer.bias.begin(), layer.bias.end());
+        auto *output{scratch.output.data()};
+
+        for (const auto &block : layer.blocks) {
+            const auto *blockInput{scratch.input.data() + block.inputOffset};
+
+            multiplyAdd(block, blockInput, layer.weights.data() + block.weightOffset,
+                        output + block.nodeOffset);
+            actFuncOutput(block.actFunc, output + block.nodeOffset, block.nodeCount);
+        }
+        scratch.input.swap(scratch.output);
+    }
+    combineOutputs(scratch);
+    return scratch.result;
+}
+
+// -----------------------------------------------------------------------------
+const std::vector<double> &EnsembleModel::predict(const std::vector<double> &input) const {
+    // Each thread keeps its own scratch, which grows to fit the widest ensemble used.
+    thread_local Scratch scratch{};
+    return predict(input, scratch);
+}
+
+// -----------------------------------------------------------------------------
+const double *EnsembleModel::memberOutput(const Scratch &scratch,
+                                          const std::size_t member) const noexcept {
+    // The output blocks of the members are stored back to back.
+    return scratch.input.data() + member * myOutputCount;
+}
+
+// -----------------------------------------------------------------------------
+void EnsembleModel::print(std::ostream &ostream) const {
+    ostream << "Ensemble of " << myMemberCount << " members with " << inputCount()
+            << " inputs:\n";
+    for (const auto &layer : myLayers) {
+        ostream << "  " << layer.nodeCount << " nodes in " << layer.blocks.size() << " block"
+                << (layer.blocks.size() == 1U ? "" : "s") << ", " << layer.weights.size()
+                << " weights\n";
+    }
+}
+
+// -----------------------------------------------------------------------------
+void EnsembleModel::combineOutputs(Scratch &scratch) const {
+    scratch.result.assign(myOutputCount, 0.0);
+
+    switch (myCombine) {
+    case Combine::Average:
+        for (std::size_t m{}; m < myMemberCount; ++m) {
+            const auto *output{memberOutput(scratch, m)};
+            for (std::size_t i{}; i < myOutputCount; ++i) {
+                scratch.result[i] += output[i];
+            }
+        }
+        for (auto &value : scratch.result) {
+            value /= static_cast<double>(myMemberCount);
+        }
+        break;
+    case Combine::Median:
+        // Sort the member outputs of each output in the (otherwise unused) output buffer.
+        for (std::size_t i{}; i < myOutputCount; ++i) {
+            scratch.output.clear();
+            for (std::size_t m{}; m < myMemberCount; ++m) {
+                scratch.output.push_back(memberOutput(scratch, m)[i]);
+            }
+            const auto middle{scratch.output.begin() + myMemberCount / 2U};
+            std::nth_element(scratch.output.begin(), middle, scratch.output.end());
+            auto median{*middle};
+            if (myMemberCount % 2U == 0U) {
+                median = (median + *std::max_element(scratch.output.begin(), middle)) / 2.0;
+            }
+            scratch.result[i] = median;
+        }
+        break;
+    case Combine::Vote:
+        // Each member votes for its largest output, or for 1 or 0 with a single output.
+        for (std::size_t m{}; m < myMemberCount; ++m) {
+            const auto *output{memberOutput(scratch, m)};
+            if (myOutputCount == 1U) {
+                scratch.result[0U] += output[0U] >= 0.5 ? 1.0 : 0.0;
+            } else {
+                scratch.result[std::max_element(output, output + myOutputCount) - output] += 1.0;
+            }
+        }
+        if (myOutputCount == 1U) {
+            scratch.result[0U] = 2.0 * scratch.result[0U] > myMemberCount ? 1.0 : 0.0;
+        } else {
+            const auto winner{std::max_element(scratch.result.begin(), scratch.result.end()) -
+                              scratch.result.begin()};
+            std::fill(scratch.result.begin(), scratch.result.end(), 0.0);
+            scratch.result[winner] = 1.0;
+        }
+        break;
+    }
+}
+
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,349 @@
+/*******************************************************************************
+ * @brief Implementation details of the ml::FixedPointModel class.
+ ******************************************************************************/
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "fixed_point_model.h"
+
+namespace ml {
+namespace {
+
+/*******************************************************************************
+ * @brief Tanh lookup table in Q15, covering -4.0 - 4.0 in steps of 1/32.
+ ******************************************************************************/
+constexpr std::size_t TanhLutSize{257U};
+constexpr int TanhLutStepShift{7};
+constexpr std::int32_t TanhLutOffset{4 << fixed::LutInputFraction};
+
+/*******************************************************************************
+ * @brief Slope of leaky ReLU in Q15, approximately 0.01.
+ ******************************************************************************/
+constexpr std::int64_t LeakyReluSlopeQ15{328};
+
+// -----------------------------------------------------------------------------
+std::array<std::int16_t, TanhLutSize> makeTanhLut() {
+    std::array<std::int16_t, TanhLutSize> lut{};
+    for (std::size_t i{}; i < lut.size(); ++i) {
+        const auto x{-4.0 + static_cast<double>(i) / 32.0};
+        lut[i] = fixed::saturate16(std::llround(std::tanh(x) * 32768.0));
+    }
+    return lut;
+}
+
+const auto TanhLut{makeTanhLut()};
+
+// -----------------------------------------------------------------------------
+int fractionFor(const double maxAbsolute) {
+    // Use as many fractional bits as possible without saturating the largest value.
+    int fraction{15};
+    while ((fraction > 0) && (maxAbsolute * std::ldexp(1.0, fraction) > 32767.0)) {
+        --fraction;
+    }
+    return fraction;
+}
+
+// -----------------------------------------------------------------------------
+double maxAbsolute(const std::vector<double> &values) {
+    double max{};
+    for (const auto value : values) {
+        max = std::max(max, std::abs(value));
+    }
+    return max;
+}
+
+// -----------------------------------------------------------------------------
+bool usesLut(const ActFunc actFunc) {
+    return (actFunc == ActFunc::Tanh) || (actFunc == ActFunc::Sigmoid);
+}
+
+} // namespace
+
+namespace fixed {
+
+// -----------------------------------------------------------------------------
+std::int16_t saturate16(const std::int64_t value) noexcept {
+    return static_cast<std::int16_t>(
+        std::clamp<std::int64_t>(value, std::numeric_limits<std::int16_t>::min(),
+                                 std::numeric_limits<std::int16_t>::max()));
+}
+
+// -----------------------------------------------------------------------------
+std::int32_t addSaturate32(const std::int32_t a, const std::int32_t b) noexcept {
+    const auto sum{static_cast<std::int64_t>(a) + b};
+    return static_cast<std::int32_t>(
+        std::clamp<std::int64_t>(sum, std::numeric_limits<std::int32_t>::min(),
+                                 std::numeric_limits<std::int32_t>::max()));
+}
+
+// -----------------------------------------------------------------------------
+std::int64_t shiftRound(const std::int64_t value, const int shift) noexcept {
+    if (shift <= 0) { return value * (std::int64_t{1} << -shift); }
+    return (value + (std::int64_t{1} << (shift - 1))) >> shift;
+}
+
+// -----------------------------------------------------------------------------
+std::int16_t tanh(const std::int16_t input) noexcept {
+    // Offset the input to a table position, saturating outside the table.
+    const auto position{std::clamp<std::int32_t>(input + TanhLutOffset, 0,
+                                                 2 * TanhLutOffset)};
+    const auto index{static_cast<std::size_t>(position >> TanhLutStepShift)};
+    if (index + 1U >= TanhLutSize) { return TanhLut[TanhLutSize - 1U]; }
+
+    // Interpolate linearly between the two nearest entries.
+    const auto fraction{position & ((1 << TanhLutStepShift) - 1)};
+    const auto delta{static_cast<std::int64_t>(TanhLut[index + 1U]) - TanhLut[index]};
+    return saturate16(TanhLut[index] + shiftRound(delta * fraction, TanhLutStepShift));
+}
+
+// -----------------------------------------------------------------------------
+std::int16_t sigmoid(const std::int16_t input) noexcept {
+    const auto halfTanh{tanh(saturate16(shiftRound(input, 1)))};
+    return saturate16(shiftRound(32768 + halfTanh, 1));
+}
+
+} // namespace fixed
+
+// -----------------------------------------------------------------------------
+void FixedPointModel::ErrorReport::print(std::ostream &ostream) const {
+    ostream << "Fixed-point error over " << errors.sampleCount() << " inputs:\n";
+    errors.print(ostream);
+    ostream << "Parameter memory: " << doubleBytes << " -> " << fixedBytes << " bytes\n";
+}
+
+// -----------------------------------------------------------------------------
+FixedPointModel::FixedPointModel(const InferenceModel &model,
+                                 const std::vector<std::vector<double>> &calibrationInputs)
+    : myLayers{}, myMaxWidth{model.inputCount()} {
+    // Throw an exception if the calibration inputs don't match the model.
+    if (calibrationInputs.empty()) {
+        throw std::invalid_argument("Cannot quantize model without calibration inputs!");
+    }
+    for (const auto &input : calibrationInputs) {
+        if (input.size() != model.inputCount()) {
+            throw std::invalid_argument("Calibration input does not match the shape of the model!");
+        }
+    }
+
+    // Feed the calibration inputs through the floating-point layers, choosing the format of each
+    // layer output from the largest value seen.
+    auto activations{calibrationInputs};
+    double inputMax{};
+    for (const auto &input : activations) {
+        inputMax = std::max(inputMax, maxAbsolute(input));
+    }
+    auto inputFraction{fractionFor(inputMax)};
+
+    for (const auto &source : model.layers()) {
+        if (source.actFunc == ActFunc::Softmax) {
+            throw std::invalid_argument("Cannot quantize softmax layers!");
+        }
+
+        // Get dense weights, pruned layers are expanded with zeros.
+        auto weights{source.weights};
+        if (weights.empty()) {
+            weights.resize(source.nodeCount * source.weightCount, 0.0);
+            source.sparseWeights.scatter(weights.data());
+        }
+
+        // Calculate the floating-point outputs, tracking the largest output and the largest sum
+        // of absolute bias and products, which bounds every partial sum of the accumulators.
+        double outputMax{}, accumulatorMax{};
+        for (auto &activation : activations) {
+            std::vector<double> output{source.bias};
+            for (std::size_t i{}; i < source.nodeCount; ++i) {
+                auto bound{std::abs(output[i])};
+                for (std::size_t j{}; j < source.weightCount; ++j) {
+                    const auto product{weights[i * source.weightCount + j] * activation[j]};
+                    output[i] += product;
+                    bound += std::abs(product);
+                }
+                accumulatorMax = std::max(accumulatorMax, bound);
+            }
+            actFuncOutput(source.actFunc, output.data(), output.size());
+            outputMax = std::max(outputMax, maxAbsolute(output));
+            activation.swap(output);
+        }
+
+        // Use the most precise weights whose accumulators can't saturate. Tanh and sigmoid
+        // outputs are within -1.0 - 1.0, other outputs use the calibrated format.
+        Layer layer{source.nodeCount, source.weightCount, source.actFunc, inputFraction,
+                    fractionFor(maxAbsolute(weights)), 15, {}, {}};
+        while ((layer.weightFraction > 0) &&
+               (accumulatorMax * std::ldexp(1.0, layer.inputFraction + layer.weightFraction) >
+                std::numeric_limits<std::int32_t>::max())) {
+            --layer.weightFraction;
+        }
+        if (!usesLut(layer.actFunc)) { layer.outputFraction = fractionFor(outputMax); }
+
+        const auto accumulatorScale{std::ldexp(1.0, layer.inputFraction + layer.weightFraction)};
+        const auto weightScale{std::ldexp(1.0, layer.weightFraction)};
+
+        layer.bias.reserve(layer.nodeCount);
+        for (const auto bias : source.bias) {
+            const auto value{std::clamp<double>(std::round(bias * accumulatorScale),
+                                                std::numeric_limits<std::int32_t>::min(),
+                                                std::numeric_limits<std::int32_t>::max())};
+            layer.bias.push_back(static_cast<std::int32_t>(value));
+        }
+        layer.weights.reserve(weights.size());
+        for (const auto weight : weights) {
+            layer.weights.push_back(fixed::saturate16(std::llround(weight * weightScale)));
+        }
+
+        inputFraction = layer.outputFraction;
+        myMaxWidth = std::max(myMaxWidth, layer.nodeCount);
+        myLayers.push_back(std::move(layer));
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t FixedPointModel::inputCount() const noexcept { return myLayers.front().weightCount; }
+
+// -----------------------------------------------------------------------------
+std::size_t FixedPointModel::outputCount() const noexcept { return myLayers.back().nodeCount; }
+
+// -----------------------------------------------------------------------------
+const std::vector<FixedPointModel::Layer> &FixedPointModel::layers() const noexcept {
+    return myLayers;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t FixedPointModel::parameterBytes() const noexcept {
+    std::size_t byteCount{};
+    for (const auto &layer : myLayers) {
+        byteCount += layer.bias.size() * sizeof(std::int32_t) +
+                     layer.weights.size() * sizeof(std::int16_t);
+    }
+    return byteCount;
+}
+
+// -----------------------------------------------------------------------------
+std::vector<std::int16_t> FixedPointModel::quantizeInput(const std::vector<double> &input) const {
+    const auto scale{std::ldexp(1.0, myLayers.front().inputFraction)};
+    std::vector<std::int16_t> quantized{};
+    quantized.reserve(input.size());
+    for (const auto value : input) {
+        quantized.push_back(fixed::saturate16(std::llround(value * scale)));
+    }
+    return quantized;
+}
+
+// -----------------------------------------------------------------------------
+std::vector<double> FixedPointModel::dequantizeOutput(
+    const std::vector<std::int16_t> &output) const {
+    const auto scale{std::ldexp(1.0, -myLayers.back().outputFraction)};
+    std::vector<double> values{};
+    values.reserve(output.size());
+    for (const auto value : output) {
+        values.push_back(value * scale);
+    }
+    return values;
+}
+
+// -----------------------------------------------------------------------------
+const std::vector<std::int16_t> &FixedPointModel::predict(const std::vector<std::int16_t> &input,
+                                                          Scratch &scratch) const {
+    // Throw an exception on mismatch between the input and the shape of the model.
+    if (input.size() != inputCount()) {
+        throw std::invalid_argument("Prediction input does not match the shape of the model!");
+    }
+    scratch.input.reserve(myMaxWidth);
+    scratch.output.reserve(myMaxWidth);
+    scratch.input.assign(input.begin(), input.end());
+
+    for (const auto &layer : myLayers) {
+        scratch.output.resize(layer.nodeCount);
+        auto *output{scratch.output.data()};
+        const auto *layerInput{scratch.input.data()};
+
+        // Round the accumulators to the lookup table input or to the output format.
+        const auto preFraction{usesLut(layer.actFunc) ? fixed::LutInputFraction
+                                                      : layer.outputFraction};
+        const auto shift{layer.inputFraction + layer.weightFraction - preFraction};
+
+        for (std::size_t i{}; i < layer.nodeCount; ++i) {
+            const auto *weights{layer.weights.data() + i * layer.weightCount};
+            auto sum{layer.bias[i]};
+            for (std::size_t j{}; j < layer.weightCount; ++j) {
+                sum = fixed::addSaturate32(sum, static_cast<std::int32_t>(weights[j]) *
+                                                    layerInput[j]);
+            }
+            output[i] = fixed::saturate16(fixed::shiftRound(sum, shift));
+        }
+
+        // Apply the activation function to all nodes.
+        switch (layer.actFunc) {
+        case ActFunc::Relu:
+            for (std::size_t i{}; i < layer.nodeCount; ++i) {
+                output[i] = std::max<std::int16_t>(output[i], 0);
+            }
+            break;
+        case ActFunc::LeakyRelu:
+            for (std::size_t i{}; i < layer.nodeCount; ++i) {
+                if (output[i] < 0) {
+                    output[i] = fixed::saturate16(
+                        fixed::shiftRound(output[i] * LeakyReluSlopeQ15, 15));
+                }
+            }
+            break;
+        case ActFunc::Tanh:
+            for (std::size_t i{}; i < layer.nodeCount; ++i) {
+                output[i] = fixed::tanh(output[i]);
+            }
+            break;
+        case ActFunc::Sigmoid:
+            for (std::size_t i{}; i < layer.nodeCount; ++i) {
+                output[i] = fixed::sigmoid(output[i]);
+            }
+            break;
+        default:
+            break;
+        }
+        scratch.input.swap(scratch.output);
+    }
+    return scratch.input;
+}
+
+// -----------------------------------------------------------------------------
+std::vector<double> FixedPointModel::predict(const std::vector<double> &input) const {
+    // Each thread keeps its own scratch, which grows to fit the widest model used.
+    thread_local Scratch scratch{};
+    return dequantizeOutput(predict(quantizeInput(input), scratch));
+}
+
+// -----------------------------------------------------------------------------
+FixedPointModel::ErrorReport FixedPointModel::compare(
+    const InferenceModel &model, const std::vector<std::vector<double>> &inputs) const {
+    if (model.outputCount() != outputCount()) {
+        throw std::invalid_argument("Cannot compare models with different output counts!");
+    }
+    ErrorReport report{OutputErrors{outputCount()}, model.parameterBytes(), parameterBytes()};
+    for (const auto &input : inputs) {
+        report.errors.add(model.predict(input).data(), predict(input).data());
+    }
+    return report;
+}
+
+// -----------------------------------------------------------------------------
+void FixedPointModel::print(std::ostream &ostream) const {
+    // Prints a fixed-point format in Qm.f notation.
+    const auto format = [](const int fraction) {
+        return "Q" + std::to_string(15 - fraction) + "." + std::to_string(fraction);
+    };
+
+    ostream << "Fixed-point model with " << inputCount() << " inputs ("
+            << format(myLayers.front().inputFraction) << "):\n";
+    for (const auto &layer : myLayers) {
+        ostream << "  " << layer.nodeCount << " nodes x " << layer.weightCount << " weights ("
+                << format(layer.weightFraction) << "), " << actFuncName(layer.actFunc)
+                << ", output " << format(layer.outputFraction) << "\n";
+    }
+    ostream << "Parameter memory: " << parameterBytes() << " bytes\n";
+}
+
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,56 @@
+/********************************************************************************
+ * @brief Implementation details of the default GPIO backend selection.
+ ********************************************************************************/
+#include "gpio_backend.h"
+
+#ifdef RPI_GPIO_SIM
+#include "sim_chip.h"
+#else
+#include "gpiod_backend.h"
+#endif
+
+namespace rpi {
+namespace gpio {
+namespace {
+
+Backend *currentBackend{nullptr}; // The backend used by drivers by default.
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+bool Backend::requestOutputs(const std::uint8_t *pins, const std::size_t count) noexcept {
+    bool isRequested{true};
+    for (std::size_t i{}; i < count; ++i) {
+        if (!requestLine(pins[i], Direction::Out)) { isRequested = false; }
+    }
+    return isRequested;
+}
+
+// -----------------------------------------------------------------------------
+bool Backend::writeBulk(const std::uint8_t *pins, const bool *values,
+                        const std::size_t count) noexcept {
+    for (std::size_t i{}; i < count; ++i) {
+        write(pins[i], values[i]);
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+Backend &defaultBackend() noexcept {
+    // Create the built-in backend on first use, unless another backend has been set.
+    if (!currentBackend) {
+#ifdef RPI_GPIO_SIM
+        static SimChip builtIn{};
+#else
+        static GpiodBackend builtIn{};
+#endif
+        currentBackend = &builtIn;
+    }
+    return *currentBackend;
+}
+
+// -----------------------------------------------------------------------------
+void setDefaultBackend(Backend &backend) noexcept { currentBackend = &backend; }
+
+} // namespace gpio
+} // namespace rpi
\ No newline at end of file
@@ -0,0 +1,134 @@
+/********************************************************************************
+ * @brief Implementation details of the libgpiod GPIO backend.
+ ********************************************************************************/
+#include <gpiod.h>
+
+#include "gpiod_backend.h"
+#include "gpiod_utils.h"
+
+namespace rpi {
+namespace gpio {
+
+// -----------------------------------------------------------------------------
+GpiodBackend::GpiodBackend(const char *chipPath) noexcept
+    : myChip{gpiod_chip_open(chipPath)}, myLines{}, myGroups{} {}
+
+// -----------------------------------------------------------------------------
+GpiodBackend::~GpiodBackend() noexcept {
+    for (std::uint8_t pin{}; pin < LineCount; ++pin) {
+        releaseLine(pin);
+    }
+    if (myChip) { gpiod_chip_close(myChip); }
+}
+
+// -----------------------------------------------------------------------------
+bool GpiodBackend::isOpen() const noexcept { return myChip != nullptr; }
+
+// -----------------------------------------------------------------------------
+bool GpiodBackend::requestLine(const std::uint8_t pin, const Direction direction) noexcept {
+    if ((pin >= LineCount) || myLines[pin]) { return false; }
+    const auto lineDirection{direction == Direction::In ? GPIOD_LINE_DIRECTION_IN
+                                                        : GPIOD_LINE_DIRECTION_OUT};
+    myLines[pin] = gpiod_line_new_from_chip(myChip, pin, lineDirection);
+    return myLines[pin] != nullptr;
+}
+
+// -----------------------------------------------------------------------------
+void GpiodBackend::releaseLine(const std::uint8_t pin) noexcept {
+    if ((pin < LineCount) && myLines[pin]) {
+        gpiod_line_release(myLines[pin]);
+        myLines[pin] = nullptr;
+        myGroups[pin] = {};
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool GpiodBackend::read(const std::uint8_t pin) noexcept {
+    return isSingle(pin) && (gpiod_line_get_value(myLines[pin]) > 0);
+}
+
+// -----------------------------------------------------------------------------
+void GpiodBackend::write(const std::uint8_t pin, const bool value) noexcept {
+    if (isSingle(pin)) { gpiod_line_set_value(myLines[pin], static_cast<int>(value)); }
+}
+
+// -----------------------------------------------------------------------------
+bool GpiodBackend::requestOutputs(const std::uint8_t *pins, const std::size_t count) noexcept {
+    // Collect the lines, all of them must be free.
+    struct gpiod_line *lines[GPIOD_LINE_BULK_MAX_LINES]{};
+    bool isFree{myChip && (count > 0U) && (count <= GPIOD_LINE_BULK_MAX_LINES)};
+    for (std::size_t i{}; isFree && (i < count); ++i) {
+        if ((pins[i] < LineCount) && !myLines[pins[i]]) {
+            lines[i] = gpiod_chip_get_line(myChip, pins[i]);
+        }
+        isFree = lines[i] != nullptr;
+    }
+
+    // Request the lines with a single handle, driven low, so one ioctl sets them all. Fall
+    // back to requesting the lines one by one if the chip refuses.
+    if (isFree) {
+        gpiod_line_bulk bulk;
+        gpiod_line_bulk_init(&bulk);
+        int defaultValues[GPIOD_LINE_BULK_MAX_LINES]{};
+        for (std::size_t i{}; i < count; ++i) {
+            gpiod_line_bulk_add(&bulk, lines[i]);
+        }
+        if (gpiod_line_request_bulk_output(&bulk, "", defaultValues) == 0) {
+            for (std::size_t i{}; i < count; ++i) {
+                myLines[pins[i]] = lines[i];
+                myGroups[pins[i]] = {pins[0U], static_cast<std::uint8_t>(i),
+                                     static_cast<std::uint8_t>(count)};
+            }
+            return true;
+        }
+    }
+    return Backend::requestOutputs(pins, count);
+}
+
+// -----------------------------------------------------------------------------
+bool GpiodBackend::writeBulk(const std::uint8_t *pins, const bool *values,
+                             const std::size_t count) noexcept {
+    // The ioctl behind a bulk write sets all lines of a single request in the requested
+    // order, so only a whole group requested together can be set in one call.
+    if (isGroup(pins, count)) {
+        gpiod_line_bulk bulk;
+        gpiod_line_bulk_init(&bulk);
+        int bulkValues[GPIOD_LINE_BULK_MAX_LINES]{};
+        for (std::size_t i{}; i < count; ++i) {
+            bulkValues[i] = static_cast<int>(values[i]);
+            gpiod_line_bulk_add(&bulk, myLines[pins[i]]);
+        }
+        return gpiod_line_set_value_bulk(&bulk, bulkValues) == 0;
+    }
+
+    // Write lines requested one by one separately.
+    bool isWritten{true};
+    for (std::size_t i{}; i < count; ++i) {
+        if (!isSingle(pins[i]) ||
+            (gpiod_line_set_value(myLines[pins[i]], static_cast<int>(values[i])) != 0)) {
+            isWritten = false;
+        }
+    }
+    return isWritten;
+}
+
+// -----------------------------------------------------------------------------
+bool GpiodBackend::isGroup(const std::uint8_t *pins, const std::size_t count) const noexcept {
+    if (count == 0U) { return false; }
+    for (std::size_t i{}; i < count; ++i) {
+        if ((pins[i] >= LineCount) || !myLines[pins[i]]) { return false; }
+        const auto &group{myGroups[pins[i]]};
+        if ((group.first != pins[0U]) || (group.index != i) || (group.size != count)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool GpiodBackend::isSingle(const std::uint8_t pin) const noexcept {
+    return (pin < LineCount) && myLines[pin] && (myGroups[pin].size <= 1U);
+}
+
+} // namespace gpio
+} // namespace rpi
\ No newline at end of file
@@ -24,7 +24,16 @@ static inline struct gpiod_chip* get_gpiod_chip0(void)
 // -----------------------------------------------------------------------------
 struct gpiod_line* gpiod_line_new(const uint8_t pin, const enum gpiod_line_direction direction) 
 {
-    struct gpiod_line* self = gpiod_chip_get_line(get_gpiod_chip0(), pin);
+    return gpiod_line_new_from_chip(get_gpiod_chip0(), pin, direction);
+}
+
+// -----------------------------------------------------------------------------
+struct gpiod_line* gpiod_line_new_from_chip(struct gpiod_chip* chip, const uint8_t pin, 
+                                             const enum gpiod_line_direction direction)
+{
+    if (!chip) { return NULL; }
+    struct gpiod_line* self = gpiod_chip_get_line(chip, pin);
+    if (!self) { return NULL; }
     if (direction == GPIOD_LINE_DIRECTION_IN) { gpiod_line_request_input(self, ""); }
     else { gpiod_line_request_output(self, "", 0); }
     return self;
@@ -0,0 +1,314 @@
+/*******************************************************************************
+ * @brief Implementation details of the ml::HyperparameterSweep class.
+ ******************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#include "hyperparameter_sweep.h"
+#include "network_builder.h"
+#include "utils.h"
+
+namespace ml {
+namespace {
+
+// -----------------------------------------------------------------------------
+const char *shortName(const ActFunc actFunc) {
+    switch (actFunc) {
+    case ActFunc::Relu:
+        return "relu";
+    case ActFunc::Tanh:
+        return "tanh";
+    case ActFunc::Linear:
+        return "lin";
+    case ActFunc::Sigmoid:
+        return "sig";
+    case ActFunc::LeakyRelu:
+        return "lrelu";
+    case ActFunc::Softmax:
+        return "smax";
+    default:
+        return "?";
+    }
+}
+
+// -----------------------------------------------------------------------------
+template <typename T> const T &draw(const std::vector<T> &values, std::mt19937 &generator) {
+    std::uniform_int_distribution<std::size_t> distribution{0U, values.size() - 1U};
+    return values[distribution(generator)];
+}
+
+// -----------------------------------------------------------------------------
+bool isComplete(const HyperparameterSweep::SearchSpace &space) {
+    return !space.hiddenLayerCounts.empty() && !space.hiddenNodeCounts.empty() &&
+           !space.hiddenActFuncs.empty() && !space.outputActFuncs.empty() &&
+           !space.learningRates.empty() && !space.epochCounts.empty();
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+std::string HyperparameterSweep::Candidate::topology() const {
+    std::string description{};
+    for (const auto &layer : hiddenLayers) {
+        description += std::to_string(layer.nodeCount) + " " + shortName(layer.actFunc) + ", ";
+    }
+    return description + std::to_string(outputLayer.nodeCount) + " " +
+           shortName(outputLayer.actFunc);
+}
+
+// -----------------------------------------------------------------------------
+HyperparameterSweep::HyperparameterSweep(const std::vector<std::vector<double>> &input,
+                                         const std::vector<std::vector<double>> &output,
+                                         const Loss loss)
+    : myInput{input}, myOutput{output}, myLoss{loss}, myThreadCount{}, myCheckpointCount{10U},
+      myCancelRatio{4.0}, myErrorFloor{1.0e-3} {
+    // Throw an exception if the training sets are missing or don't match.
+    if (input.empty() || (input.size() != output.size())) {
+        throw std::invalid_argument("Cannot create sweep without matching training sets!");
+    }
+    if (input[0U].empty() || output[0U].empty()) {
+        throw std::invalid_argument("Cannot create sweep without inputs or outputs!");
+    }
+}
+
+// -----------------------------------------------------------------------------
+void HyperparameterSweep::setThreadCount(const std::size_t threadCount) noexcept {
+    myThreadCount = threadCount;
+}
+
+// -----------------------------------------------------------------------------
+void HyperparameterSweep::setCancellation(const std::size_t checkpointCount,
+                                          const double cancelRatio, const double errorFloor) {
+    if ((checkpointCount == 0U) || (cancelRatio < 0.0) || (errorFloor < 0.0)) {
+        throw std::invalid_argument("Invalid cancellation parameters!");
+    }
+    myCheckpointCount = checkpointCount;
+    myCancelRatio = cancelRatio;
+    myErrorFloor = errorFloor;
+}
+
+// -----------------------------------------------------------------------------
+std::vector<HyperparameterSweep::Candidate>
+HyperparameterSweep::gridCandidates(const SearchSpace &space, const std::uint32_t seed) const {
+    if (!isComplete(space)) {
+        throw std::invalid_argument("Cannot create candidates from incomplete search space!");
+    }
+    std::vector<Candidate> candidates{};
+    auto nextSeed{seed};
+
+    // Create a candidate for each combination, skipping combinations that can't be built.
+    for (const auto layerCount : space.hiddenLayerCounts) {
+        for (const auto nodeCount : space.hiddenNodeCounts) {
+            for (const auto hiddenActFunc : space.hiddenActFuncs) {
+                for (const auto outputActFunc : space.outputActFuncs) {
+                    for (const auto learningRate : space.learningRates) {
+                        for (const auto epochCount : space.epochCounts) {
+                            const NeuralNetwork::LayerSpec hidden{nodeCount, hiddenActFunc};
+                            Candidate candidate{
+                                std::vector<NeuralNetwork::LayerSpec>(layerCount, hidden),
+                                NeuralNetwork::LayerSpec{myOutput[0U].size(), outputActFunc},
+                                learningRate, epochCount, nextSeed++};
+                            if (isValid(candidate)) {
+                                candidates.push_back(std::move(candidate));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return candidates;
+}
+
+// -----------------------------------------------------------------------------
+std::vector<HyperparameterSweep::Candidate>
+HyperparameterSweep::randomCandidates(const SearchSpace &space, const std::size_t count,
+                                      const std::uint32_t seed) const {
+    if (!isComplete(space)) {
+        throw std::invalid_argument("Cannot create candidates from incomplete search space!");
+    }
+    std::vector<Candidate> candidates{};
+    std::mt19937 generator{seed};
+
+    // Draw candidates until enough valid ones are found, giving up after many invalid draws.
+    for (std::size_t attempt{}; (candidates.size() < count) && (attempt < 100U * count);
+         ++attempt) {
+        Candidate candidate{{}, {}, 0.0, 0U, 0U};
+        const auto layerCount{draw(space.hiddenLayerCounts, generator)};
+        for (std::size_t i{}; i < layerCount; ++i) {
+            candidate.hiddenLayers.push_back(NeuralNetwork::LayerSpec{
+                draw(space.hiddenNodeCounts, generator), draw(space.hiddenActFuncs, generator)});
+        }
+        candidate.outputLayer = {myOutput[0U].size(), draw(space.outputActFuncs, generator)};
+        candidate.learningRate = draw(space.learningRates, generator);
+        candidate.epochCount = draw(space.epochCounts, generator);
+        candidate.seed = static_cast<std::uint32_t>(generator());
+        if (isValid(candidate)) { candidates.push_back(std::move(candidate)); }
+    }
+    return candidates;
+}
+
+// -----------------------------------------------------------------------------
+std::vector<HyperparameterSweep::Result>
+HyperparameterSweep::run(const std::vector<Candidate> &candidates) const {
+    std::vector<Result> results(candidates.size());
+    if (candidates.empty()) { return results; }
+
+    // Candidates are compared after the same number of epochs, at milestones spread evenly over
+    // the longest training. The best error of any candidate at each milestone is kept.
+    std::size_t maxEpochCount{};
+    for (const auto &candidate : candidates) {
+        maxEpochCount = std::max(maxEpochCount, candidate.epochCount);
+    }
+    const auto milestoneEpochs{std::max<std::size_t>(
+        (maxEpochCount + myCheckpointCount - 1U) / myCheckpointCount, 1U)};
+    std::vector<double> bestErrors(myCheckpointCount, std::numeric_limits<double>::infinity());
+    std::mutex bestErrorsMutex{};
+    std::atomic<std::size_t> nextIndex{};
+
+    // Trains one candidate, measuring the error at each milestone and after the last epoch.
+    const auto train = [&](const Candidate &candidate, Result &result) {
+        result = Result{candidate, std::numeric_limits<double>::infinity(), 0.0, 0U, false, 0U,
+                        0U, 0.0};
+        const auto startTime{std::chrono::steady_clock::now()};
+
+        // Seed the generator of this thread, so the weights only depend on the candidate.
+        utils::random::seed(candidate.seed);
+        NetworkBuilder builder{myInput[0U].size()};
+        for (const auto &layer : candidate.hiddenLayers) {
+            builder.addHiddenLayer(layer.nodeCount, layer.actFunc);
+        }
+        builder.setOutputLayer(candidate.outputLayer.nodeCount, candidate.outputLayer.actFunc)
+            .setLoss(myLoss);
+        const auto cost{builder.cost()};
+        result.flopCount = cost.flopCount;
+        result.parameterBytes = cost.parameterBytes;
+
+        auto network{builder.build()};
+        network->addTrainingData(myInput, myOutput);
+
+        while (result.epochsRun < candidate.epochCount) {
+            const auto epochEnd{
+                std::min(candidate.epochCount, (result.epochsRun / milestoneEpochs + 1U) *
+                                                   milestoneEpochs)};
+            network->train(epochEnd - result.epochsRun, candidate.learningRate);
+            result.epochsRun = epochEnd;
+            result.error = network->trainingError(result.accuracy);
+
+            // Cancel the candidate if it diverged.
+            if (!std::isfinite(result.error)) {
+                result.cancelled = true;
+                break;
+            }
+            if (epochEnd % milestoneEpochs != 0U) { continue; }
+
+            // Cancel the candidate if it is far behind the best candidate at this milestone,
+            // unless its error is already small or it has finished.
+            std::lock_guard<std::mutex> lock{bestErrorsMutex};
+            auto &bestError{bestErrors[epochEnd / milestoneEpochs - 1U]};
+            bestError = std::min(bestError, result.error);
+            if ((myCancelRatio > 0.0) && (epochEnd < candidate.epochCount) &&
+                (result.error > myErrorFloor) && (result.error > myCancelRatio * bestError)) {
+                result.cancelled = true;
+                break;
+            }
+        }
+        result.trainingTimeS =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    };
+
+    // Let each thread train candidates until none are left.
+    const auto work = [&]() {
+        for (auto i{nextIndex++}; i < candidates.size(); i = nextIndex++) {
+            try {
+                train(candidates[i], results[i]);
+            } catch (const std::exception &) {
+                results[i].cancelled = true;
+            }
+        }
+    };
+
+    const auto hardwareThreadCount{std::max(std::thread::hardware_concurrency(), 1U)};
+    const auto threadCount{std::min<std::size_t>(
+        myThreadCount > 0U ? myThreadCount : hardwareThreadCount, candidates.size())};
+    std::vector<std::thread> threads{};
+    for (std::size_t i{1U}; i < threadCount; ++i) {
+        threads.emplace_back(work);
+    }
+
+    // Training on this thread reseeds its generator, so restore the state of the caller.
+    const auto callerState{utils::random::state()};
+    work();
+    utils::random::setState(callerState);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    // Rank finished candidates before cancelled ones, then by error and inference cost.
+    // Diverged candidates rank last, a NaN error can't be ordered.
+    const auto rankedError = [](const Result &result) {
+        return std::isfinite(result.error) ? result.error
+                                           : std::numeric_limits<double>::infinity();
+    };
+    std::stable_sort(results.begin(), results.end(), [&](const Result &a, const Result &b) {
+        if (a.cancelled != b.cancelled) { return b.cancelled; }
+        if (rankedError(a) != rankedError(b)) { return rankedError(a) < rankedError(b); }
+        return a.flopCount < b.flopCount;
+    });
+    return results;
+}
+
+// -----------------------------------------------------------------------------
+void HyperparameterSweep::print(const std::vector<Result> &results, std::ostream &ostream) {
+    // Fit the topology column to the longest topology.
+    std::size_t topologyWidth{10U};
+    for (const auto &result : results) {
+        topologyWidth = std::max(topologyWidth, result.candidate.topology().size() + 2U);
+    }
+    const auto width{static_cast<int>(topologyWidth)};
+
+    const auto flags{ostream.flags()};
+    const auto precision{ostream.precision(4)};
+    ostream << "--------------------------------------------------------------------------------\n";
+    ostream << std::left << std::setw(5) << "Rank" << std::setw(width) << "Topology" << std::setw(9)
+            << "Rate" << std::setw(9) << "Epochs" << std::setw(11) << "Error" << std::setw(10)
+            << "Accuracy" << std::setw(8) << "FLOPs" << std::setw(8) << "Bytes" << "Time [s]\n";
+    for (std::size_t i{}; i < results.size(); ++i) {
+        const auto &result{results[i]};
+        ostream << std::setw(5) << (i + 1U) << std::setw(width) << result.candidate.topology()
+                << std::setw(9) << result.candidate.learningRate << std::setw(9)
+                << (std::to_string(result.epochsRun) + (result.cancelled ? "*" : ""))
+                << std::setw(11) << result.error << std::setw(10) << result.accuracy
+                << std::setw(8) << result.flopCount << std::setw(8) << result.parameterBytes
+                << result.trainingTimeS << "\n";
+    }
+    ostream << "* = cancelled\n";
+    ostream << "--------------------------------------------------------------------------------\n";
+    ostream.flags(flags);
+    ostream.precision(precision);
+}
+
+// -----------------------------------------------------------------------------
+bool HyperparameterSweep::isValid(const Candidate &candidate) const noexcept {
+    if ((candidate.epochCount == 0U) || (candidate.learningRate <= 0.0) ||
+        !isLossSupported(myLoss, candidate.outputLayer.actFunc)) {
+        return false;
+    }
+    for (const auto &layer : candidate.hiddenLayers) {
+        if ((layer.nodeCount == 0U) || (layer.actFunc == ActFunc::Softmax) ||
+            (layer.actFunc >= ActFunc::Count)) {
+            return false;
+        }
+    }
+    return candidate.outputLayer.nodeCount == myOutput[0U].size();
+}
+
+} // namespace ml
\ No newline at end of file
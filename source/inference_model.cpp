@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * @brief Implementation details of the ml::InferenceModel class.
+ ******************************************************************************/
+#include <algorithm>
+#include <stdexcept>
+
+#include "inference_model.h"
+
+namespace ml {
+
+// -----------------------------------------------------------------------------
+InferenceModel::InferenceModel(std::vector<Layer> layers)
+    : myLayers{std::move(layers)}, myMaxWidth{} {
+    // Throw an exception if the model is empty or the layers don't fit together.
+    if (myLayers.empty()) {
+        throw std::invalid_argument("Cannot create inference model without layers!");
+    }
+    myMaxWidth = myLayers[0U].weightCount;
+
+    for (std::size_t i{}; i < myLayers.size(); ++i) {
+        const auto &layer{myLayers[i]};
+        if ((i > 0U) && (layer.weightCount != myLayers[i - 1U].nodeCount)) {
+            throw std::invalid_argument("The shapes of the inference model layers don't match!");
+        }
+        if ((layer.bias.size() != layer.nodeCount) ||
+            ((layer.weights.size() != layer.nodeCount * layer.weightCount) &&
+             (layer.sparseWeights.rowCount() != layer.nodeCount))) {
+            throw std::invalid_argument("The parameters don't match the shape of the layer!");
+        }
+        myMaxWidth = std::max(myMaxWidth, layer.nodeCount);
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t InferenceModel::inputCount() const noexcept { return myLayers.front().weightCount; }
+
+// -----------------------------------------------------------------------------
+std::size_t InferenceModel::outputCount() const noexcept { return myLayers.back().nodeCount; }
+
+// -----------------------------------------------------------------------------
+const std::vector<InferenceModel::Layer> &InferenceModel::layers() const noexcept {
+    return myLayers;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t InferenceModel::parameterBytes() const noexcept {
+    std::size_t byteCount{};
+    for (const auto &layer : myLayers) {
+        byteCount += (layer.bias.size() + layer.weights.size()) * sizeof(double) +
+                     layer.sparseWeights.byteCount();
+    }
+    return byteCount;
+}
+
+// -----------------------------------------------------------------------------
+InferenceModel::Scratch InferenceModel::makeScratch() const {
+    Scratch scratch{};
+    scratch.input.reserve(myMaxWidth);
+    scratch.output.reserve(myMaxWidth);
+    return scratch;
+}
+
+// -----------------------------------------------------------------------------
+const std::vector<double> &InferenceModel::predict(const std::vector<double> &input,
+                                                   Scratch &scratch) const {
+    // Throw an exception on mismatch between the input and the shape of the model.
+    if (input.size() != inputCount()) {
+        throw std::invalid_argument("Prediction input does not match the shape of the model!");
+    }
+    scratch.input.assign(input.begin(), input.end());
+
+    // Feed the input through each layer, swapping the scratch buffers in between.
+    for (const auto &layer : myLayers) {
+        scratch.output.assign(layer.bias.begin(), layer.bias.end());
+        auto *output{scratch.output.data()};
+        const auto *layerInput{scratch.input.data()};
+
+        if (layer.weights.empty()) {
+            layer.sparseWeights.multiplyAdd(layerInput, output);
+        } else {
+            for (std::size_t i{}; i < layer.nodeCount; ++i) {
+                const auto *weights{layer.weights.data() + i * layer.weightCount};
+                auto sum{output[i]};
+                for (std::size_t j{}; j < layer.weightCount; ++j) {
+                    sum += layerInput[j] * weights[j];
+                }
+                output[i] = sum;
+            }
+        }
+        actFuncOutput(layer.actFunc, output, layer.nodeCount);
+        scratch.input.swap(scratch.output);
+    }
+    return scratch.input;
+}
+
+// -----------------------------------------------------------------------------
+const std::vector<double> &InferenceModel::predict(const std::vector<double> &input) const {
+    // Each thread keeps its own scratch, which grows to fit the widest model used.
+    thread_local Scratch scratch{};
+    return predict(input, scratch);
+}
+
+// -----------------------------------------------------------------------------
+void InferenceModel::print(std::ostream &ostream) const {
+    ostream << "Inference model with " << inputCount() << " inputs:\n";
+    for (const auto &layer : myLayers) {
+        ostream << "  " << layer.nodeCount << " nodes x " << layer.weightCount << " weights, "
+                << actFuncName(layer.actFunc)
+                << (layer.weights.empty() ? " (sparse)\n" : "\n");
+    }
+    ostream << "Parameter memory: " << parameterBytes() << " bytes\n";
+}
+
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,264 @@
+/*******************************************************************************
+ * @brief Implementation details of the ml::KernelProfiler class.
+ ******************************************************************************/
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "kernel_profiler.h"
+
+namespace ml {
+namespace {
+
+constexpr auto PhaseCount{static_cast<unsigned>(KernelPhase::Count)};
+
+// -----------------------------------------------------------------------------
+std::uint64_t monotonicNs() noexcept {
+    const auto time{std::chrono::steady_clock::now().time_since_epoch()};
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+}
+
+#ifdef __linux__
+// -----------------------------------------------------------------------------
+int openCounter(const KernelCounter counter, const int groupFd) noexcept {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.exclude_kernel = 1U;
+    attr.exclude_hv = 1U;
+    attr.read_format =
+        PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    switch (counter) {
+    case KernelCounter::Cycles:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case KernelCounter::Instructions:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case KernelCounter::L1Misses:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8U) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16U);
+        break;
+    case KernelCounter::LlcMisses:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    default:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    }
+    // Count the calling thread on any CPU.
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0UL));
+}
+#endif
+
+// -----------------------------------------------------------------------------
+const char *counterName(const KernelCounter counter) {
+    switch (counter) {
+    case KernelCounter::Cycles:
+        return "cycles";
+    case KernelCounter::Instructions:
+        return "instructions";
+    case KernelCounter::L1Misses:
+        return "L1 misses";
+    case KernelCounter::LlcMisses:
+        return "LLC misses";
+    case KernelCounter::BranchMisses:
+        return "branch misses";
+    default:
+        return "Unknown";
+    }
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+const char *kernelPhaseName(const KernelPhase phase) {
+    switch (phase) {
+    case KernelPhase::Feedforward:
+        return "feedforward";
+    case KernelPhase::Backpropagate:
+        return "backpropagate";
+    case KernelPhase::Optimize:
+        return "optimize";
+    default:
+        return "Unknown";
+    }
+}
+
+// -----------------------------------------------------------------------------
+KernelProfiler::KernelProfiler(const std::size_t layerCount)
+    : myFds{}, myGroupIndex{}, myLeaderFd{-1}, myOpenCount{}, myUnavailableReason{},
+      myTotals(layerCount * PhaseCount, Totals{}) {
+    if (layerCount == 0U) {
+        throw std::invalid_argument("Cannot create kernel profiler without layers!");
+    }
+    myFds.fill(-1);
+
+#ifdef __linux__
+    // The first counter opened leads the group, counters that fail to open are skipped.
+    for (unsigned i{}; i < CounterCount; ++i) {
+        const auto counter{static_cast<KernelCounter>(i)};
+        const auto fd{openCounter(counter, myLeaderFd)};
+        if (fd < 0) {
+            if (myUnavailableReason.empty()) {
+                myUnavailableReason = std::string{counterName(counter)} + ": " + strerror(errno);
+            }
+            continue;
+        }
+        if (myLeaderFd < 0) { myLeaderFd = fd; }
+        myFds[i] = fd;
+
+        // Group reads list the values in opening order.
+        myGroupIndex[i] = myOpenCount++;
+    }
+#else
+    myUnavailableReason = "perf_event_open requires Linux";
+#endif
+}
+
+// -----------------------------------------------------------------------------
+KernelProfiler::~KernelProfiler() noexcept {
+#ifdef __linux__
+    for (const auto fd : myFds) {
+        if (fd >= 0) { close(fd); }
+    }
+#endif
+}
+
+// -----------------------------------------------------------------------------
+std::size_t KernelProfiler::layerCount() const noexcept { return myTotals.size() / PhaseCount; }
+
+// -----------------------------------------------------------------------------
+bool KernelProfiler::isAvailable(const KernelCounter counter) const noexcept {
+    return (counter < KernelCounter::Count) && (myFds[static_cast<unsigned>(counter)] >= 0);
+}
+
+// -----------------------------------------------------------------------------
+const std::string &KernelProfiler::unavailableReason() const noexcept {
+    return myUnavailableReason;
+}
+
+// -----------------------------------------------------------------------------
+void KernelProfiler::read(Snapshot &snapshot) const noexcept {
+#ifdef __linux__
+    // Read the whole group at once: count, time enabled, time running, then the values.
+    if (myOpenCount > 0U) {
+        std::uint64_t buffer[3U + CounterCount]{};
+        if (::read(myLeaderFd, buffer, sizeof(buffer)) > 0) {
+            snapshot.timeEnabled = buffer[1U];
+            snapshot.timeRunning = buffer[2U];
+            for (unsigned i{}; i < CounterCount; ++i) {
+                snapshot.values[i] = myFds[i] >= 0 ? buffer[3U + myGroupIndex[i]] : 0U;
+            }
+        }
+    }
+#endif
+    snapshot.timeNs = monotonicNs();
+}
+
+// -----------------------------------------------------------------------------
+void KernelProfiler::record(const std::size_t layer, const KernelPhase phase,
+                            const Snapshot &start) noexcept {
+    if ((layer >= layerCount()) || (phase >= KernelPhase::Count)) { return; }
+    Snapshot end{};
+    read(end);
+    auto &totals{myTotals[layer * PhaseCount + static_cast<unsigned>(phase)]};
+    ++totals.callCount;
+    totals.timeNs += end.timeNs - start.timeNs;
+
+    // Scale the counts up if the group was multiplexed with other events.
+    const auto running{end.timeRunning - start.timeRunning};
+    if (running == 0U) { return; }
+    const auto scale{static_cast<double>(end.timeEnabled - start.timeEnabled) / running};
+    for (unsigned i{}; i < CounterCount; ++i) {
+        totals.counts[i] += static_cast<double>(end.values[i] - start.values[i]) * scale;
+    }
+}
+
+// -----------------------------------------------------------------------------
+const KernelProfiler::Totals &KernelProfiler::totals(const std::size_t layer,
+                                                     const KernelPhase phase) const {
+    if ((layer >= layerCount()) || (phase >= KernelPhase::Count)) {
+        throw std::out_of_range("Kernel profiler layer or phase out of range!");
+    }
+    return myTotals[layer * PhaseCount + static_cast<unsigned>(phase)];
+}
+
+// -----------------------------------------------------------------------------
+void KernelProfiler::reset() noexcept {
+    for (auto &totals : myTotals) {
+        totals = Totals{};
+    }
+}
+
+// -----------------------------------------------------------------------------
+void KernelProfiler::print(std::ostream &ostream) const {
+    const auto count = [](const Totals &totals, const KernelCounter counter) {
+        return totals.counts[static_cast<unsigned>(counter)];
+    };
+    // Prints a ratio, or "-" if a counter it depends on is unavailable.
+    const auto ratio = [&](const bool available, const double numerator,
+                           const double denominator) {
+        ostream << std::setw(10);
+        if (available && (denominator > 0.0)) {
+            ostream << numerator / denominator;
+        } else {
+            ostream << "-";
+        }
+    };
+    const auto hasInstructions{isAvailable(KernelCounter::Instructions)};
+
+    const auto flags{ostream.flags()};
+    const auto precision{ostream.precision()};
+    if (myOpenCount == 0U) {
+        ostream << "Hardware counters unavailable (" << myUnavailableReason
+                << "), wall-clock time only\n";
+    } else if (!myUnavailableReason.empty()) {
+        ostream << "Some hardware counters are unavailable (" << myUnavailableReason << ")\n";
+    }
+    ostream << std::left << std::setw(7) << "layer" << std::setw(15) << "phase" << std::right
+            << std::setw(10) << "calls" << std::setw(11) << "time [ms]" << std::setw(10)
+            << "ns/call" << std::setw(10) << "IPC" << std::setw(10) << "L1 MPKI" << std::setw(10)
+            << "LLC MPKI" << std::setw(10) << "br MPKI" << "\n";
+    ostream << std::fixed << std::setprecision(3);
+
+    for (std::size_t layer{}; layer < layerCount(); ++layer) {
+        for (unsigned phase{}; phase < PhaseCount; ++phase) {
+            const auto &totals{myTotals[layer * PhaseCount + phase]};
+            if (totals.callCount == 0U) { continue; }
+            const auto instructions{count(totals, KernelCounter::Instructions) / 1000.0};
+
+            ostream << std::left << std::setw(7) << layer << std::setw(15)
+                    << kernelPhaseName(static_cast<KernelPhase>(phase)) << std::right
+                    << std::setw(10) << totals.callCount << std::setw(11)
+                    << totals.timeNs / 1.0e6;
+            ratio(true, static_cast<double>(totals.timeNs), static_cast<double>(totals.callCount));
+            ratio(hasInstructions && isAvailable(KernelCounter::Cycles),
+                  count(totals, KernelCounter::Instructions), count(totals, KernelCounter::Cycles));
+            ratio(hasInstructions && isAvailable(KernelCounter::L1Misses),
+                  count(totals, KernelCounter::L1Misses), instructions);
+            ratio(hasInstructions && isAvailable(KernelCounter::LlcMisses),
+                  count(totals, KernelCounter::LlcMisses), instructions);
+            ratio(hasInstructions && isAvailable(KernelCounter::BranchMisses),
+                  count(totals, KernelCounter::BranchMisses), instructions);
+            ostream << "\n";
+        }
+    }
+    ostream.flags(flags);
+    ostream.precision(precision);
+}
+
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,293 @@
+/*******************************************************************************
+ * @brief Implementation details of the ml::KernelTuner class.
+ ******************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+
+#include "arena.h"
+#include "kernel_tuner.h"
+
+namespace ml {
+namespace {
+
+/*******************************************************************************
+ * @brief Minimum duration of a timed round, and the number of rounds of which
+ *        the fastest is kept.
+ ******************************************************************************/
+constexpr std::int64_t MinRoundNs{100000};
+constexpr std::size_t RoundCount{5U};
+
+constexpr auto PhaseCount{static_cast<std::size_t>(KernelPhase::Count)};
+constexpr auto VariantCount{static_cast<std::size_t>(KernelVariant::Count)};
+
+// -----------------------------------------------------------------------------
+const char *variantName(const KernelVariant variant) {
+    switch (variant) {
+    case KernelVariant::Scalar:
+        return "scalar";
+    case KernelVariant::Blocked:
+        return "blocked";
+    case KernelVariant::Sparse:
+        return "sparse";
+    default:
+        return "unknown";
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool parseVariant(const std::string &name, KernelVariant &variant) {
+    for (std::size_t i{}; i < VariantCount; ++i) {
+        if (name == variantName(static_cast<KernelVariant>(i))) {
+            variant = static_cast<KernelVariant>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+std::string trim(const std::string &text) {
+    const auto first{text.find_first_not_of(" \t")};
+    if (first == std::string::npos) { return std::string{}; }
+    return text.substr(first, text.find_last_not_of(" \t") - first + 1U);
+}
+
+// -----------------------------------------------------------------------------
+template <typename Kernel> double nsPerCall(Kernel &&kernel) {
+    using Clock = std::chrono::steady_clock;
+    const auto timeRound = [&](const std::size_t callCount) {
+        const auto startTime{Clock::now()};
+        for (std::size_t i{}; i < callCount; ++i) { kernel(); }
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - startTime)
+            .count();
+    };
+
+    // Double the calls per round until a round is long enough to time, then keep the fastest
+    // of several rounds to filter out interrupts and frequency changes.
+    std::size_t callCount{1U};
+    while (timeRound(callCount) < MinRoundNs) { callCount *= 2U; }
+    auto fastest{std::numeric_limits<std::int64_t>::max()};
+    for (std::size_t round{}; round < RoundCount; ++round) {
+        fastest = std::min<std::int64_t>(fastest, timeRound(callCount));
+    }
+    return static_cast<double>(fastest) / callCount;
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+bool KernelTuner::Shape::operator<(const Shape &other) const noexcept {
+    return std::tie(nodeCount, weightCount, isSparse, density) <
+           std::tie(other.nodeCount, other.weightCount, other.isSparse, other.density);
+}
+
+// -----------------------------------------------------------------------------
+KernelTuner::KernelTuner(const std::string &cachePath)
+    : myPath{cachePath}, myCpuModel{cpuModel()}, myChoices{}, myOtherLines{},
+      mySelections{} {
+    // Throw an exception if the cache could never be written.
+    if (cachePath.empty()) {
+        throw std::invalid_argument("Cannot create kernel tuner without cache path!");
+    }
+    load();
+}
+
+// -----------------------------------------------------------------------------
+std::string KernelTuner::cpuModel() {
+    // Raspberry Pi kernels name the board, other systems the processor.
+    std::ifstream file{"/proc/cpuinfo"};
+    std::string line{}, board{}, modelName{}, part{};
+    while (std::getline(file, line)) {
+        const auto separator{line.find(':')};
+        if (separator == std::string::npos) { continue; }
+        const auto key{trim(line.substr(0U, separator))};
+        const auto value{trim(line.substr(separator + 1U))};
+        if (key == "Model") {
+            board = value;
+        } else if ((key == "model name") && modelName.empty()) {
+            modelName = value;
+        } else if ((key == "CPU part") && part.empty()) {
+            part = "CPU part " + value;
+        }
+    }
+    auto model{!board.empty() ? board : !modelName.empty() ? modelName : part};
+    if (model.empty()) { return "unknown"; }
+
+    // Tabs separate the fields of the cache file.
+    std::replace(model.begin(), model.end(), '\t', ' ');
+    return model;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t KernelTuner::cachedShapeCount() const noexcept { return myChoices.size(); }
+
+// -----------------------------------------------------------------------------
+std::size_t KernelTuner::tune(const std::vector<DenseLayer *> &layers) {
+    mySelections.clear();
+    std::size_t benchmarkCount{};
+
+    for (auto *layer : layers) {
+        const auto shape{shapeOf(*layer)};
+        auto entry{myChoices.find(shape)};
+
+        // Benchmark shapes missing from the cache, or cached with unusable kernels.
+        auto isUsable{entry != myChoices.end()};
+        for (std::size_t phase{}; isUsable && (phase < PhaseCount); ++phase) {
+            isUsable = layer->supportsKernel(static_cast<KernelPhase>(phase),
+                                             entry->second[phase]);
+        }
+        if (!isUsable) {
+            myChoices[shape] = benchmark(*layer);
+            entry = myChoices.find(shape);
+            ++benchmarkCount;
+        }
+        for (std::size_t phase{}; phase < PhaseCount; ++phase) {
+            layer->setKernel(static_cast<KernelPhase>(phase), entry->second[phase]);
+        }
+        mySelections.push_back(Selection{shape, entry->second, !isUsable});
+    }
+
+    // A cache that can't be written only costs the benchmarks of the next run.
+    if (benchmarkCount > 0U) { save(); }
+    return benchmarkCount;
+}
+
+// -----------------------------------------------------------------------------
+void KernelTuner::print(std::ostream &ostream) const {
+    const auto flags{ostream.flags()};
+    ostream << "Kernels for " << myCpuModel << ":\n";
+    ostream << std::left << std::setw(7) << "layer" << std::setw(8) << "nodes" << std::setw(9)
+            << "weights" << std::setw(9) << "density" << std::setw(13) << "feedforward"
+            << std::setw(15) << "backpropagate" << std::setw(10) << "optimize" << "source\n";
+    for (std::size_t i{}; i < mySelections.size(); ++i) {
+        const auto &selection{mySelections[i]};
+        ostream << std::setw(7) << i << std::setw(8) << selection.shape.nodeCount << std::setw(9)
+                << selection.shape.weightCount << std::setw(9)
+                << (std::to_string(selection.shape.density * 10U) + " %") << std::setw(13)
+                << variantName(selection.choice[0U]) << std::setw(15)
+                << variantName(selection.choice[1U]) << std::setw(10)
+                << variantName(selection.choice[2U])
+                << (selection.benchmarked ? "benchmarked" : "cached") << "\n";
+    }
+    ostream.flags(flags);
+}
+
+// -----------------------------------------------------------------------------
+KernelTuner::Shape KernelTuner::shapeOf(const DenseLayer &layer) noexcept {
+    const auto weightCount{layer.nodeCount() * layer.weightCount()};
+    return Shape{layer.nodeCount(), layer.weightCount(), layer.isSparse(),
+                 layer.isSparse() ? layer.nonZeroCount() * 10U / weightCount : 10U};
+}
+
+// -----------------------------------------------------------------------------
+KernelTuner::Choice KernelTuner::benchmark(const DenseLayer &layer) {
+    const auto nodeCount{layer.nodeCount()};
+    const auto weightCount{layer.weightCount()};
+
+    // Copy the layer into scratch memory, the kernels write its parameters and activations.
+    Arena parameters{DenseLayer::parameterCount(nodeCount, weightCount)};
+    Arena activations{DenseLayer::activationCount(nodeCount)};
+    std::copy(layer.bias(), layer.bias() + nodeCount, parameters.data());
+    std::copy(layer.weights(), layer.weights() + nodeCount * weightCount,
+              parameters.data() + Arena::alignedCount(nodeCount));
+    DenseLayer scratch{layer};
+    scratch.place(parameters.data(), activations.data());
+
+    // The error follows the output in the activations. Small values keep the weights stable
+    // while optimizing.
+    std::fill(activations.data() + Arena::alignedCount(nodeCount),
+              activations.data() + activations.size(), 1.0e-3);
+    std::vector<double> input(weightCount, 0.5), inputError(weightCount);
+
+    Choice choice{};
+    for (std::size_t phase{}; phase < PhaseCount; ++phase) {
+        const auto kernelPhase{static_cast<KernelPhase>(phase)};
+        auto fastest{std::numeric_limits<double>::infinity()};
+        for (std::size_t variant{}; variant < VariantCount; ++variant) {
+            const auto kernelVariant{static_cast<KernelVariant>(variant)};
+            if (!scratch.supportsKernel(kernelPhase, kernelVariant)) { continue; }
+            scratch.setKernel(kernelPhase, kernelVariant);
+
+            double time{};
+            if (kernelPhase == KernelPhase::Feedforward) {
+                time = nsPerCall([&]() { scratch.feedforward(input.data()); });
+            } else if (kernelPhase == KernelPhase::Backpropagate) {
+                time = nsPerCall([&]() { scratch.propagateError(inputError.data()); });
+            } else {
+                time = nsPerCall([&]() { scratch.optimize(input.data(), 1.0e-9); });
+            }
+            if (time < fastest) {
+                fastest = time;
+                choice[phase] = kernelVariant;
+            }
+        }
+    }
+    return choice;
+}
+
+// -----------------------------------------------------------------------------
+void KernelTuner::load() {
+    // Each line holds the CPU model, the shape and the kernel of each phase, tab separated.
+    std::ifstream file{myPath};
+    std::string line{};
+    while (std::getline(file, line)) {
+        if (line.empty() || (line[0U] == '#')) { continue; }
+        const auto separator{line.find('\t')};
+        if (separator == std::string::npos) { continue; }
+        if (line.substr(0U, separator) != myCpuModel) {
+            myOtherLines.push_back(line);
+            continue;
+        }
+
+        // Skip malformed entries, they are benchmarked again.
+        std::istringstream fields{line.substr(separator + 1U)};
+        Shape shape{};
+        std::array<std::string, PhaseCount> names{};
+        if (!(fields >> shape.nodeCount >> shape.weightCount >> shape.isSparse >>
+              shape.density)) {
+            continue;
+        }
+        Choice choice{};
+        auto isValid{true};
+        for (std::size_t phase{}; phase < PhaseCount; ++phase) {
+            isValid = isValid && (fields >> names[phase]) &&
+                      parseVariant(names[phase], choice[phase]);
+        }
+        if (isValid) { myChoices[shape] = choice; }
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool KernelTuner::save() const {
+    // Write to a temporary file first so the cache file is never partial.
+    const auto tempPath{myPath + ".tmp"};
+    {
+        std::ofstream file{tempPath, std::ios::trunc};
+        if (!file) { return false; }
+        file << "# cpu\tnodes\tweights\tpruned\tdensity\tfeedforward\tbackpropagate\toptimize\n";
+        for (const auto &line : myOtherLines) {
+            file << line << "\n";
+        }
+        for (const auto &[shape, choice] : myChoices) {
+            file << myCpuModel << "\t" << shape.nodeCount << "\t" << shape.weightCount << "\t"
+                 << shape.isSparse << "\t" << shape.density;
+            for (const auto variant : choice) {
+                file << "\t" << variantName(variant);
+            }
+            file << "\n";
+        }
+        file.close();
+        if (!file) { return false; }
+    }
+    return std::rename(tempPath.c_str(), myPath.c_str()) == 0;
+}
+
+} // namespace ml
\ No newline at end of file
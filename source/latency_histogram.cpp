@@ -0,0 +1,104 @@
+/*******************************************************************************
+ * @brief Implementation details of the ctrl::LatencyHistogram class.
+ ******************************************************************************/
+#include <limits>
+
+#include "latency_histogram.h"
+
+namespace ctrl {
+
+// -----------------------------------------------------------------------------
+LatencyHistogram::LatencyHistogram() noexcept
+    : myCounts{}, myCount{}, mySum{}, myMin{std::numeric_limits<std::uint64_t>::max()}, myMax{} {}
+
+// -----------------------------------------------------------------------------
+void LatencyHistogram::record(const std::uint64_t value) noexcept {
+    myCounts[bucketIndex(value)].fetch_add(1U, std::memory_order_relaxed);
+    mySum.fetch_add(value, std::memory_order_relaxed);
+
+    // Update the extremes, retry only if another thread raced us.
+    auto min{myMin.load(std::memory_order_relaxed)};
+    while ((value < min) && !myMin.compare_exchange_weak(min, value, std::memory_order_relaxed)) {}
+    auto max{myMax.load(std::memory_order_relaxed)};
+    while ((value > max) && !myMax.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+
+    // Publish the count last so readers never see more values than buckets hold.
+    myCount.fetch_add(1U, std::memory_order_release);
+}
+
+// -----------------------------------------------------------------------------
+std::uint64_t LatencyHistogram::count() const noexcept {
+    return myCount.load(std::memory_order_acquire);
+}
+
+// -----------------------------------------------------------------------------
+std::uint64_t LatencyHistogram::percentile(const double percentile) const noexcept {
+    const auto total{count()};
+    if (total == 0U) { return 0U; }
+
+    // Find the bucket holding the value with the requested rank.
+    const auto clamped{percentile < 0.0 ? 0.0 : (percentile > 100.0 ? 100.0 : percentile)};
+    auto rank{static_cast<std::uint64_t>(clamped / 100.0 * total + 0.5)};
+    if (rank == 0U) { rank = 1U; }
+    std::uint64_t accumulated{};
+
+    for (std::size_t i{}; i < BucketCount; ++i) {
+        accumulated += myCounts[i].load(std::memory_order_relaxed);
+        if (accumulated >= rank) {
+            // Never report more than the largest value actually recorded.
+            const auto max{myMax.load(std::memory_order_relaxed)};
+            const auto value{bucketHighestValue(i)};
+            return value < max ? value : max;
+        }
+    }
+    return myMax.load(std::memory_order_relaxed);
+}
+
+// -----------------------------------------------------------------------------
+LatencyHistogram::Summary LatencyHistogram::summary() const noexcept {
+    const auto total{count()};
+    Summary summary{};
+    summary.count = total;
+    if (total == 0U) { return summary; }
+    summary.min = myMin.load(std::memory_order_relaxed);
+    summary.max = myMax.load(std::memory_order_relaxed);
+    summary.mean = static_cast<double>(mySum.load(std::memory_order_relaxed)) / total;
+    summary.p50 = percentile(50.0);
+    summary.p99 = percentile(99.0);
+    summary.p999 = percentile(99.9);
+    return summary;
+}
+
+// -----------------------------------------------------------------------------
+void LatencyHistogram::reset() noexcept {
+    myCount.store(0U, std::memory_order_relaxed);
+    for (auto &count : myCounts) {
+        count.store(0U, std::memory_order_relaxed);
+    }
+    mySum.store(0U, std::memory_order_relaxed);
+    myMin.store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_relaxed);
+    myMax.store(0U, std::memory_order_release);
+}
+
+// -----------------------------------------------------------------------------
+std::size_t LatencyHistogram::bucketIndex(const std::uint64_t value) noexcept {
+    // Small values are stored exactly.
+    if (value < LinearBucketCount) { return static_cast<std::size_t>(value); }
+
+    // Larger values are split into a power of two and a 4-bit mantissa.
+    const auto msb{static_cast<std::size_t>(63 - __builtin_clzll(value))};
+    const auto shift{msb - 4U};
+    const auto mantissa{static_cast<std::size_t>(value >> shift) - SubBucketCount};
+    return LinearBucketCount + (shift - 1U) * SubBucketCount + mantissa;
+}
+
+// -----------------------------------------------------------------------------
+std::uint64_t LatencyHistogram::bucketHighestValue(const std::size_t index) noexcept {
+    if (index < LinearBucketCount) { return index; }
+    const auto shift{(index - LinearBucketCount) / SubBucketCount + 1U};
+    const auto mantissa{static_cast<std::uint64_t>((index - LinearBucketCount) % SubBucketCount +
+                                                   SubBucketCount)};
+    return ((mantissa + 1U) << shift) - 1U;
+}
+
+} // namespace ctrl
\ No newline at end of file
@@ -1,39 +1,44 @@
 /********************************************************************************
  * @brief Implementation details of the Raspberry Pi LED driver.
  ********************************************************************************/
-#include <gpiod.h>
+#include <chrono>
+#include <thread>
 
-#include "gpiod_utils.h"
 #include "led.h"
 
 namespace rpi {
 
 // -----------------------------------------------------------------------------
-Led::Led(const std::uint8_t pin, const bool startValue) noexcept
-    : myLine{gpiod_line_new(pin, GPIOD_LINE_DIRECTION_OUT)} {
-    write(startValue);
+Led::Led(const std::uint8_t pin, const bool startValue, gpio::Backend &backend) noexcept
+    : myBackend{backend}, myPin{pin}, myEnabled{startValue} {
+    myBackend.requestLine(myPin, gpio::Direction::Out);
+    myBackend.write(myPin, myEnabled);
 }
 
 // -----------------------------------------------------------------------------
-Led::~Led() noexcept { gpiod_line_release(myLine); }
+Led::~Led() noexcept { myBackend.releaseLine(myPin); }
 
 // -----------------------------------------------------------------------------
-std::uint8_t Led::pin() const noexcept { return ::gpiod_line_offset(myLine); }
+std::uint8_t Led::pin() const noexcept { return myPin; }
 
 // -----------------------------------------------------------------------------
-bool Led::isEnabled() const noexcept { return gpiod_line_get_value(myLine) > 0; }
+bool Led::isEnabled() const noexcept { return myEnabled; }
 
 // -----------------------------------------------------------------------------
 void Led::write(const bool value) noexcept {
-    gpiod_line_set_value(myLine, static_cast<int>(value));
+    // Only access the hardware when the state changes.
+    if (value == myEnabled) { return; }
+    myEnabled = value;
+    myBackend.write(myPin, value);
 }
 
 // -----------------------------------------------------------------------------
-void Led::toggle() noexcept { gpiod_line_set_value(myLine, !isEnabled()); }
+void Led::toggle() noexcept { write(!isEnabled()); }
 
 // -----------------------------------------------------------------------------
 void Led::blink(const std::uint16_t blinkSpeedMs) noexcept {
-    gpiod_line_blink(myLine, blinkSpeedMs);
+    toggle();
+    std::this_thread::sleep_for(std::chrono::milliseconds(blinkSpeedMs));
 }
 
 } // namespace rpi
\ No newline at end of file
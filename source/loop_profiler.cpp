@@ -0,0 +1,134 @@
+/*******************************************************************************
+ * @brief Implementation details of the ctrl::LoopProfiler class.
+ ******************************************************************************/
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+#include "loop_profiler.h"
+
+namespace ctrl {
+namespace {
+
+// -----------------------------------------------------------------------------
+void handleDumpSignal(int) { LoopProfiler::requestDump(); }
+
+} // namespace
+
+std::atomic<bool> LoopProfiler::myDumpRequested{false};
+
+// -----------------------------------------------------------------------------
+const char *stageName(const Stage stage) {
+    switch (stage) {
+    case Stage::Sense:
+        return "sense";
+    case Stage::Predict:
+        return "predict";
+    case Stage::Actuate:
+        return "actuate";
+    case Stage::Cycle:
+        return "cycle";
+    case Stage::EdgeToActuate:
+        return "edge-to-actuate";
+    default:
+        throw std::invalid_argument("Invalid stage!\n");
+    }
+}
+
+// -----------------------------------------------------------------------------
+LoopProfiler::LoopProfiler(const bool enabled) noexcept
+    : myEnabled{enabled}, myHistograms{}, myReportPath{}, myInterval{}, myMutex{}, myCondition{},
+      myStopReporter{false}, myReporter{} {}
+
+// -----------------------------------------------------------------------------
+LoopProfiler::~LoopProfiler() noexcept {
+    if (myReporter.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock{myMutex};
+            myStopReporter = true;
+        }
+        myCondition.notify_one();
+        myReporter.join();
+        dump(myReportPath);
+    }
+}
+
+// -----------------------------------------------------------------------------
+const LatencyHistogram &LoopProfiler::histogram(const Stage stage) const {
+    if (stage >= Stage::Count) {
+        throw std::invalid_argument("Invalid stage!\n");
+    }
+    return myHistograms[static_cast<unsigned>(stage)];
+}
+
+// -----------------------------------------------------------------------------
+void LoopProfiler::print(std::ostream &ostream) const {
+    constexpr auto toUs = [](const std::uint64_t ns) { return ns / 1000.0; };
+    ostream << std::left << std::setw(16) << "stage" << std::right << std::setw(12) << "count"
+            << std::setw(12) << "p50 [us]" << std::setw(12) << "p99 [us]" << std::setw(12)
+            << "p999 [us]" << std::setw(12) << "max [us]" << "\n";
+    ostream << std::fixed << std::setprecision(3);
+
+    for (unsigned i{}; i < static_cast<unsigned>(Stage::Count); ++i) {
+        const auto summary{myHistograms[i].summary()};
+        ostream << std::left << std::setw(16) << stageName(static_cast<Stage>(i)) << std::right
+                << std::setw(12) << summary.count << std::setw(12) << toUs(summary.p50)
+                << std::setw(12) << toUs(summary.p99) << std::setw(12) << toUs(summary.p999)
+                << std::setw(12) << toUs(summary.max) << "\n";
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool LoopProfiler::dump(const std::string &path) const {
+    if (path.empty()) { return false; }
+
+    // Write to a temporary file first so readers never see a partial report.
+    const auto tempPath{path + ".tmp"};
+    {
+        std::ofstream file{tempPath};
+        if (!file) { return false; }
+        print(file);
+        if (!file) { return false; }
+    }
+    return std::rename(tempPath.c_str(), path.c_str()) == 0;
+}
+
+// -----------------------------------------------------------------------------
+void LoopProfiler::startReporter(const std::string &path,
+                                 const std::chrono::milliseconds interval) {
+    if (myReporter.joinable()) {
+        throw std::logic_error("The reporter is already running!");
+    }
+    myReportPath = path;
+    myInterval = interval;
+    myReporter = std::thread{&LoopProfiler::runReporter, this};
+}
+
+// -----------------------------------------------------------------------------
+void LoopProfiler::requestDump() noexcept { myDumpRequested.store(true); }
+
+// -----------------------------------------------------------------------------
+bool LoopProfiler::installDumpSignal(const int signal) {
+    return std::signal(signal, handleDumpSignal) != SIG_ERR;
+}
+
+// -----------------------------------------------------------------------------
+void LoopProfiler::runReporter() {
+    // Poll for dump requests often enough to feel immediate, but rarely enough to be free.
+    constexpr std::chrono::milliseconds pollInterval{100};
+    auto nextDump{std::chrono::steady_clock::now() + myInterval};
+    std::unique_lock<std::mutex> lock{myMutex};
+
+    while (!myCondition.wait_for(lock, pollInterval, [this] { return myStopReporter; })) {
+        const auto now{std::chrono::steady_clock::now()};
+        const auto periodic{(myInterval.count() > 0) && (now >= nextDump)};
+
+        if (myDumpRequested.exchange(false) || periodic) {
+            dump(myReportPath);
+            nextDump = now + myInterval;
+        }
+    }
+}
+
+} // namespace ctrl
\ No newline at end of file
@@ -0,0 +1,73 @@
+/*******************************************************************************
+ * @brief Implementation details for loss function calculations.
+ ******************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "loss.h"
+
+namespace ml {
+namespace {
+
+/*******************************************************************************
+ * @brief Lower limit of probabilities passed to the logarithm.
+ ******************************************************************************/
+constexpr double MinProbability{1e-12};
+
+// -----------------------------------------------------------------------------
+double logOf(const double probability) {
+    return std::log(std::max(probability, MinProbability));
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+bool isLossSupported(const Loss loss, const ActFunc actFunc) {
+    switch (loss) {
+    case Loss::SquaredError:
+        return (actFunc < ActFunc::Count) && (actFunc != ActFunc::Softmax);
+    case Loss::CrossEntropy:
+        return (actFunc == ActFunc::Sigmoid) || (actFunc == ActFunc::Softmax);
+    default:
+        return false;
+    }
+}
+
+// -----------------------------------------------------------------------------
+double lossValue(const Loss loss, const ActFunc actFunc, const double *outputs,
+                 const double *references, const std::size_t count) {
+    if (!isLossSupported(loss, actFunc)) {
+        throw std::invalid_argument("Invalid loss function for the output activation function!");
+    }
+    double sum{};
+
+    for (std::size_t i{}; i < count; ++i) {
+        if (loss == Loss::SquaredError) {
+            const auto error{references[i] - outputs[i]};
+            sum += error * error;
+        } else if (actFunc == ActFunc::Softmax) {
+            // Categorical cross-entropy, the outputs form one distribution.
+            sum -= references[i] * logOf(outputs[i]);
+        } else {
+            // Binary cross-entropy, each output is an independent probability.
+            sum -= references[i] * logOf(outputs[i]) +
+                   (1.0 - references[i]) * logOf(1.0 - outputs[i]);
+        }
+    }
+    return sum;
+}
+
+// -----------------------------------------------------------------------------
+const char *lossName(const Loss loss) {
+    switch (loss) {
+    case Loss::SquaredError:
+        return "Squared error";
+    case Loss::CrossEntropy:
+        return "Cross-entropy";
+    default:
+        throw std::invalid_argument("Invalid loss function!\n");
+    }
+}
+
+} // namespace ml
\ No newline at end of file
@@ -14,23 +14,65 @@
  */
 
 #include "button.h"
-#include "led.h"
+#include "output_group.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
 #include <vector>
 
+#include "checkpoint_writer.h"
+#include "distiller.h"
+#include "fixed_point_model.h"
+#include "hyperparameter_sweep.h"
+#include "kernel_profiler.h"
+#include "kernel_tuner.h"
+#include "loop_profiler.h"
+#include "model_server.h"
+#include "network_builder.h"
 #include "neural_network.h"
+#include "rt_runner.h"
+#include "sim_chip.h"
 
 /********************************************************************************
  * @brief Trains a neural network to learn the XOR function.
  * 
  *        The network is then used to set the value of an LED by performing
- *        prediction based on input values from five buttons.
+ *        prediction based on input values from five buttons. Training runs in
+ *        the background; the LED stays off until the network is published.
+ *
+ *        An optional argument sets the number of control cycles to run, after
+ *        which the loop throughput is printed (default = run forever). When
+ *        built with RPI_GPIO_SIM defined, the buttons are driven by random
+ *        input on a simulated chip and the recorded LED writes are reported.
+ *
+ *        Set LOOP_PROFILE to a file path to record per-stage loop latency. The
+ *        report is written every second and when SIGUSR1 is received.
+ *
+ *        Set RT_PERIOD_US to run the loop at a fixed rate with locked and
+ *        prefaulted memory. RT_PRIORITY selects a SCHED_FIFO priority and
+ *        RT_CPU a CPU to pin the loop to.
  ********************************************************************************/
-int main() {
-    // Create LED and button objects.
-    rpi::Led led1{17};
+int main(int argc, char **argv) {
+    // Number of control cycles to run, 0 means run forever.
+    const std::size_t cycleCount{argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 0U};
+
+#ifdef RPI_GPIO_SIM
+    // Play random button input on the simulated chip.
+    rpi::gpio::SimChip chip{};
+    for (const std::uint8_t pin : {27U, 22U, 23U, 24U, 25U}) {
+        chip.randomize(pin, 0.01);
+    }
+    rpi::gpio::setDefaultBackend(chip);
+#endif
+
+    // Create LED and button objects, the LEDs are driven as one output group.
+    rpi::OutputGroup leds{17};
     rpi::Button button1{27}, button2{22}, button3{23}, button4{24}, button5{25};
+    const std::vector<rpi::Button *> buttons{&button1, &button2, &button3, &button4, &button5};
 
     // Create a neural network to learn the XOR function.
     constexpr std::size_t epochCount{110000U};
@@ -55,43 +97,195 @@ int main() {
         {1.0}, {0.0}, {1.0}, {1.0}, {0.0}, {1.0}, {0.0}, {0.0}, {1.0}, {0.0}, {1.0},
         {1.0}, {0.0}, {0.0}, {1.0}, {1.0}, {0.0}, {1.0}, {0.0}, {0.0}, {1.0}};
 
+    // Search for a topology and learning rate instead of running the application if
+    // SWEEP_COUNT is set, training that many random candidates on all cores.
+    if (const char *sweepCount{std::getenv("SWEEP_COUNT")}) {
+        using ml::ActFunc;
+        const ml::HyperparameterSweep::SearchSpace space{
+            {1U, 2U, 3U, 5U},
+            {3U, 5U, 8U, 12U},
+            {ActFunc::Tanh, ActFunc::Relu, ActFunc::LeakyRelu, ActFunc::Sigmoid},
+            {ActFunc::Tanh, ActFunc::Sigmoid, ActFunc::Linear},
+            {0.003, 0.01, 0.03},
+            {5000U, 20000U}};
+        ml::HyperparameterSweep sweep{inputSets, referenceSets};
+        const auto seed{std::chrono::system_clock::now().time_since_epoch().count()};
+        const auto candidates{sweep.randomCandidates(
+            space, std::strtoull(sweepCount, nullptr, 10), static_cast<std::uint32_t>(seed))};
+        ml::HyperparameterSweep::print(sweep.run(candidates));
+        return 0;
+    }
+
 
-    // Create a 5-5x5-1 neural network with hyperbolic tangent activation function.
-    ml::NeuralNetwork network{5U, 5U, 5U, 1U, ml::ActFunc::Tanh};
+    // Train a 5-5x5-1 neural network with hyperbolic tangent activation function in the
+    // background, the control loop starts serving as soon as the network is published.
+    ml::ModelServer server{};
+    server.startTraining([&]() -> std::unique_ptr<ml::NeuralNetwork> {
+        ml::NetworkBuilder builder{5U};
+        for (std::size_t i{}; i < 5U; ++i) { builder.addHiddenLayer(5U, ml::ActFunc::Tanh); }
+        builder.setOutputLayer(1U, ml::ActFunc::Relu);
+        builder.cost().print();
+        auto network{builder.build()};
+        std::cout << "Network memory: " << network->parameters().byteCount()
+                  << " bytes of parameters, " << network->activationBytes()
+                  << " bytes of activations\n";
 
-    // Add the training data.
-    network.addTrainingData(inputSets, referenceSets);
+        // Add the training data.
+        network->addTrainingData(inputSets, referenceSets);
 
-    // If training succeeded, print the results.
-    if (network.train(epochCount, learningRate)) {
-        network.printResults();
-    }
-    // Else print an error message and return.
-    else {
-        std::cout << "Failed to train the network!\n";
-        return 1;
-    }
+        // Count cycles, cache and branch misses of each layer kernel if KERNEL_PROFILE is set.
+        std::unique_ptr<ml::KernelProfiler> kernelProfiler{};
+        if (std::getenv("KERNEL_PROFILE")) {
+            kernelProfiler = std::make_unique<ml::KernelProfiler>(builder.hiddenLayerCount() + 1U);
+            network->setProfiler(kernelProfiler.get());
+        }
+
+        // Checkpoint training every 10000 epochs or 5 seconds if CHECKPOINT_PATH is set,
+        // resuming from the checkpoint if one exists.
+        std::unique_ptr<ml::CheckpointWriter> checkpointWriter{};
+        if (const char *checkpointPath{std::getenv("CHECKPOINT_PATH")}) {
+            checkpointWriter = std::make_unique<ml::CheckpointWriter>(checkpointPath, 10000U,
+                                                                      std::chrono::seconds{5});
+            // A corrupt or mismatching checkpoint is reported and training starts over.
+            try {
+                if (network->restoreCheckpoint(checkpointPath)) {
+                    std::cout << "Resuming training at epoch " << network->epochCount() << "\n";
+                }
+            } catch (const std::invalid_argument &exception) {
+                std::cerr << "Ignoring checkpoint: " << exception.what() << "\n";
+            }
+            network->setCheckpointWriter(checkpointWriter.get());
+        }
+
+        // Select the fastest kernels for this board if KERNEL_TUNE_CACHE is set, benchmarking
+        // only layer shapes missing from the cache file.
+        if (const char *tuneCache{std::getenv("KERNEL_TUNE_CACHE")}) {
+            ml::KernelTuner tuner{tuneCache};
+            network->tuneKernels(tuner);
+            tuner.print();
+        }
+
+        // Split the layers over PIPELINE_STAGES threads if set.
+        const char *pipelineStages{std::getenv("PIPELINE_STAGES")};
+        const std::size_t stageCount{pipelineStages ? std::strtoull(pipelineStages, nullptr, 10)
+                                                    : 0U};
+        const auto train = [&](const std::size_t epochs) {
+            return stageCount > 0U ? network->trainPipelined(epochs, learningRate, stageCount)
+                                   : network->train(epochs, learningRate);
+        };
+
+        // If training failed, print an error message and don't publish the network.
+        const auto remainingEpochs{epochCount - std::min(epochCount, network->epochCount())};
+        if ((remainingEpochs > 0U) && !train(remainingEpochs)) {
+            std::cout << "Failed to train the network!\n";
+            return nullptr;
+        }
+        network->setCheckpointWriter(nullptr);
+        if (kernelProfiler) {
+            network->setProfiler(nullptr);
+            kernelProfiler->print();
+        }
+
+        // Else print the results.
+        network->evaluate(inputSets, referenceSets).print();
+
+        // Report the error of a fixed-point export for boards without a fast FPU.
+        const auto model{network->freeze()};
+        ml::FixedPointModel{model, inputSets}.compare(model, inputSets).print();
+
+        // Distill the network into a student with one hidden layer of DISTILL_NODES nodes if
+        // set, the student is published and the network itself is discarded.
+        if (const char *distillNodes{std::getenv("DISTILL_NODES")}) {
+            auto student{ml::NetworkBuilder{5U}
+                             .addHiddenLayer(std::strtoull(distillNodes, nullptr, 10),
+                                             ml::ActFunc::Tanh)
+                             .setOutputLayer(1U, ml::ActFunc::Tanh)
+                             .build()};
+            ml::Distiller{*network}.distill(*student, inputSets, epochCount, learningRate).print();
+            network = std::move(student);
+        }
+        std::cout << "Training is done\n";
+        return network;
+    });
 
-    std::cout << "Training is done\n";
+    // Profile the control loop if a report file is given.
+    const char *profilePath{std::getenv("LOOP_PROFILE")};
+    ctrl::LoopProfiler profiler{profilePath != nullptr};
+    if (profiler.isEnabled()) {
+        ctrl::LoopProfiler::installDumpSignal();
+        profiler.startReporter(profilePath, std::chrono::seconds{1});
+    }
 
     std::vector<double> input(5, 0.0);
 
-    while (1) {
-        
+    // Performs one sense-predict-actuate cycle.
+    const auto controlCycle = [&]() -> bool {
+        const auto senseStart{profiler.now()};
+        auto inputChanged{false};
+
         // Update input vector based on button states.
-        std::vector<Button*> buttons{&button1, &button2, &button3, &button4, &button5};
-        
-        for (std::size_t i{}; i < buttons.size(); ++i) { 
-            input[i] = buttons[i].isPressed() ? 1.0 : 0.0; 
+        for (std::size_t i{}; i < buttons.size(); ++i) {
+            const auto value{buttons[i]->isPressed() ? 1.0 : 0.0};
+            inputChanged |= value != input[i];
+            input[i] = value;
         }
+        const auto predictStart{profiler.now()};
+
+        // Predict output using the latest published network (none while training).
+        const auto *output{server.predict(input)};
+        const auto actuateStart{profiler.now()};
 
-        
-        // Predict output using the neural network.
-        const auto output{network.predict(input)};
+        // Enable each LED based on the output, only changed LEDs are written.
+        for (std::size_t i{}; i < leds.size(); ++i) {
+            leds.set(i, output && ((*output)[i] >= 0.5) ? true : false);
+        }
+        leds.commit();
+        const auto actuateEnd{profiler.now()};
+
+        // Record the latency of each stage, and of input transitions to the LED write.
+        profiler.record(ctrl::Stage::Sense, senseStart, predictStart);
+        profiler.record(ctrl::Stage::Predict, predictStart, actuateStart);
+        profiler.record(ctrl::Stage::Actuate, actuateStart, actuateEnd);
+        profiler.record(ctrl::Stage::Cycle, senseStart, actuateEnd);
+        if (inputChanged) { profiler.record(ctrl::Stage::EdgeToActuate, senseStart, actuateEnd); }
+        return true;
+    };
+
+    const auto startTime{std::chrono::steady_clock::now()};
+
+    // Run the loop at a fixed rate if a period is given, else as fast as possible.
+    if (const char *periodUs{std::getenv("RT_PERIOD_US")}) {
+        ctrl::RtRunner::Config config{};
+        config.period = std::chrono::microseconds{std::strtoull(periodUs, nullptr, 10)};
+        config.priority = std::getenv("RT_PRIORITY") ? std::atoi(std::getenv("RT_PRIORITY")) : 0;
+        config.cpu = std::getenv("RT_CPU") ? std::atoi(std::getenv("RT_CPU")) : -1;
+        config.lockMemory = true;
+        config.prefaultStackBytes = 256U * 1024U;
+        config.prefaultHeapBytes = 1024U * 1024U;
+
+        ctrl::RtRunner runner{config};
+        runner.prepare();
+        runner.run(controlCycle, cycleCount);
+        runner.print();
+    } else {
+        for (std::size_t cycle{}; (cycleCount == 0U) || (cycle < cycleCount); ++cycle) {
+            controlCycle();
+        }
+    }
 
-        // Enable LED based on the output.
-        const auto enable{output[0] >= 0.5 ? true : false};
-        led1.write(enable);
+    // Print the throughput of the control loop.
+    const std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - startTime};
+    std::cout << "Ran " << cycleCount << " control cycles in " << elapsed.count() << " s ("
+              << cycleCount / elapsed.count() << " cycles/s)\n";
+#ifdef RPI_GPIO_SIM
+    std::cout << "Recorded " << chip.writes().size() << " LED writes ("
+              << chip.droppedWriteCount() << " dropped) in " << leds.writeCount()
+              << " bulk writes\n";
+#endif
+    if (profiler.isEnabled()) { profiler.print(); }
+    if (server.version() > 0U) {
+        std::cout << "Network trained in " << server.lastTrainingTimeNs() / 1e6
+                  << " ms, swap latency " << server.lastSwapLatencyNs() / 1e3 << " us\n";
     }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,125 @@
+/*******************************************************************************
+ * @brief Implementation details of the ml::ModelServer class.
+ ******************************************************************************/
+#include <chrono>
+#include <iostream>
+
+#include "model_server.h"
+
+namespace ml {
+namespace {
+
+// -----------------------------------------------------------------------------
+std::uint64_t monotonicNs() noexcept {
+    const auto now{std::chrono::steady_clock::now().time_since_epoch()};
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+ModelServer::ModelServer() noexcept
+    : myCurrent{nullptr}, myHazard{nullptr}, myRetired{}, myPublishMutex{}, myServedVersion{},
+      myScratch{}, myVersion{}, myTrainingTimeNs{}, mySwapLatencyNs{}, myMaxSwapLatencyNs{},
+      myTraining{false}, myTrainer{} {}
+
+// -----------------------------------------------------------------------------
+ModelServer::~ModelServer() noexcept {
+    if (myTrainer.joinable()) { myTrainer.join(); }
+
+    // No serving thread can be active at this point, so delete everything.
+    delete myCurrent.load();
+    for (auto *snapshot : myRetired) {
+        delete snapshot;
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool ModelServer::startTraining(TrainJob job) {
+    if (myTraining.exchange(true)) { return false; }
+    if (myTrainer.joinable()) { myTrainer.join(); }
+
+    myTrainer = std::thread{[this, job{std::move(job)}]() {
+        // A failed job leaves the current snapshot published, serving continues with it.
+        try {
+            const auto start{monotonicNs()};
+            auto network{job()};
+            myTrainingTimeNs = monotonicNs() - start;
+            publish(std::move(network));
+        } catch (const std::exception &exception) {
+            std::cerr << "Training failed: " << exception.what() << "\n";
+        } catch (...) {
+            std::cerr << "Training failed!\n";
+        }
+        myTraining = false;
+    }};
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool ModelServer::isTraining() const noexcept { return myTraining; }
+
+// -----------------------------------------------------------------------------
+void ModelServer::publish(std::unique_ptr<NeuralNetwork> network) {
+    if (!network) { return; }
+    std::lock_guard<std::mutex> lock{myPublishMutex};
+
+    // Swap in the new snapshot, the serving thread picks it up on its next prediction.
+    const auto version{myVersion.load() + 1U};
+    auto *snapshot{new Snapshot{network->freeze(), version, monotonicNs()}};
+    auto *previous{myCurrent.exchange(snapshot)};
+    myVersion = version;
+
+    if (previous) { myRetired.push_back(previous); }
+    reclaim();
+}
+
+// -----------------------------------------------------------------------------
+const std::vector<double> *ModelServer::predict(const std::vector<double> &input) {
+    // Announce the snapshot in use, then verify it wasn't replaced in the meantime.
+    auto *snapshot{myCurrent.load()};
+    while (true) {
+        myHazard.store(snapshot);
+        auto *current{myCurrent.load()};
+        if (current == snapshot) { break; }
+        snapshot = current;
+    }
+    if (!snapshot) { return nullptr; }
+
+    // Measure the swap latency on the first prediction with a new network.
+    if (snapshot->version != myServedVersion) {
+        const auto latency{monotonicNs() - snapshot->publishTimeNs};
+        myServedVersion = snapshot->version;
+        mySwapLatencyNs = latency;
+        if (latency > myMaxSwapLatencyNs) { myMaxSwapLatencyNs = latency; }
+    }
+    return &snapshot->model.predict(input, myScratch);
+}
+
+// -----------------------------------------------------------------------------
+std::uint64_t ModelServer::version() const noexcept { return myVersion; }
+
+// -----------------------------------------------------------------------------
+std::uint64_t ModelServer::lastTrainingTimeNs() const noexcept { return myTrainingTimeNs; }
+
+// -----------------------------------------------------------------------------
+std::uint64_t ModelServer::lastSwapLatencyNs() const noexcept { return mySwapLatencyNs; }
+
+// -----------------------------------------------------------------------------
+std::uint64_t ModelServer::maxSwapLatencyNs() const noexcept { return myMaxSwapLatencyNs; }
+
+// -----------------------------------------------------------------------------
+void ModelServer::reclaim() {
+    // Keep the snapshot still announced by the serving thread, delete the others.
+    const auto *inUse{myHazard.load()};
+    for (auto it{myRetired.begin()}; it != myRetired.end();) {
+        if (*it != inUse) {
+            delete *it;
+            it = myRetired.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,131 @@
+/*******************************************************************************
+ * @brief Implementation details of the ml::NetworkBuilder class.
+ ******************************************************************************/
+#include <iomanip>
+#include <stdexcept>
+#include <string>
+
+#include "network_builder.h"
+
+namespace ml {
+namespace {
+
+// -----------------------------------------------------------------------------
+void checkLayer(const std::size_t nodeCount, const ActFunc actFunc) {
+    if (nodeCount == 0U) {
+        throw std::invalid_argument("Cannot add layer without nodes!");
+    }
+    if (actFunc >= ActFunc::Count) {
+        throw std::invalid_argument("Invalid activation function!");
+    }
+}
+
+// -----------------------------------------------------------------------------
+NetworkBuilder::LayerCost layerCost(const std::size_t nodeCount, const std::size_t weightCount,
+                                    const ActFunc actFunc) {
+    const auto parameterCount{nodeCount * (weightCount + 1U)};
+    return NetworkBuilder::LayerCost{nodeCount,
+                                     weightCount,
+                                     actFunc,
+                                     parameterCount,
+                                     parameterCount * sizeof(double),
+                                     2U * nodeCount * weightCount + nodeCount};
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+void NetworkBuilder::Cost::print(std::ostream &ostream) const {
+    ostream << "--------------------------------------------------------------------------------\n";
+    ostream << std::left << std::setw(8) << "Layer" << std::setw(8) << "Nodes" << std::setw(10)
+            << "Weights" << std::setw(12) << "Parameters" << std::setw(10) << "Bytes"
+            << std::setw(10) << "FLOPs" << "Activation\n";
+    for (std::size_t i{}; i < layers.size(); ++i) {
+        const auto &layer{layers[i]};
+        ostream << std::setw(8) << (i + 1U < layers.size() ? std::to_string(i + 1U) : "Output")
+                << std::setw(8) << layer.nodeCount << std::setw(10) << layer.weightCount
+                << std::setw(12) << layer.parameterCount << std::setw(10) << layer.parameterBytes
+                << std::setw(10) << layer.flopCount << actFuncName(layer.actFunc) << "\n";
+    }
+    ostream << std::setw(26) << "Total" << std::setw(12) << parameterCount << std::setw(10)
+            << parameterBytes << flopCount << "\n" << std::right;
+    ostream << "--------------------------------------------------------------------------------\n";
+}
+
+// -----------------------------------------------------------------------------
+NetworkBuilder::NetworkBuilder(const std::size_t inputCount)
+    : myInputCount{inputCount}, myHiddenLayers{}, myOutputLayer{}, myOutputLayerSet{false},
+      myLoss{Loss::SquaredError} {
+    if (inputCount == 0U) {
+        throw std::invalid_argument("Cannot create network builder without inputs!");
+    }
+}
+
+// -----------------------------------------------------------------------------
+NetworkBuilder &NetworkBuilder::addHiddenLayer(const std::size_t nodeCount,
+                                               const ActFunc actFunc) {
+    checkLayer(nodeCount, actFunc);
+    myHiddenLayers.push_back(NeuralNetwork::LayerSpec{nodeCount, actFunc});
+    return *this;
+}
+
+// -----------------------------------------------------------------------------
+NetworkBuilder &NetworkBuilder::setOutputLayer(const std::size_t nodeCount,
+                                               const ActFunc actFunc) {
+    checkLayer(nodeCount, actFunc);
+    myOutputLayer = NeuralNetwork::LayerSpec{nodeCount, actFunc};
+    myOutputLayerSet = true;
+    return *this;
+}
+
+// -----------------------------------------------------------------------------
+NetworkBuilder &NetworkBuilder::setLoss(const Loss loss) {
+    if (loss >= Loss::Count) {
+        throw std::invalid_argument("Invalid loss function!");
+    }
+    myLoss = loss;
+    return *this;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t NetworkBuilder::inputCount() const noexcept { return myInputCount; }
+
+// -----------------------------------------------------------------------------
+std::size_t NetworkBuilder::hiddenLayerCount() const noexcept { return myHiddenLayers.size(); }
+
+// -----------------------------------------------------------------------------
+NetworkBuilder::Cost NetworkBuilder::cost() const {
+    checkComplete();
+    Cost cost{{}, 0U, 0U, 0U};
+    cost.layers.reserve(myHiddenLayers.size() + 1U);
+
+    // Each layer has one weight per node in the previous layer.
+    auto weightCount{myInputCount};
+    for (const auto &layer : myHiddenLayers) {
+        cost.layers.push_back(layerCost(layer.nodeCount, weightCount, layer.actFunc));
+        weightCount = layer.nodeCount;
+    }
+    cost.layers.push_back(layerCost(myOutputLayer.nodeCount, weightCount, myOutputLayer.actFunc));
+
+    for (const auto &layer : cost.layers) {
+        cost.parameterCount += layer.parameterCount;
+        cost.parameterBytes += layer.parameterBytes;
+        cost.flopCount += layer.flopCount;
+    }
+    return cost;
+}
+
+// -----------------------------------------------------------------------------
+std::unique_ptr<NeuralNetwork> NetworkBuilder::build() const {
+    checkComplete();
+    return std::make_unique<NeuralNetwork>(myInputCount, myHiddenLayers, myOutputLayer, myLoss);
+}
+
+// -----------------------------------------------------------------------------
+void NetworkBuilder::checkComplete() const {
+    if (!myOutputLayerSet) {
+        throw std::invalid_argument("Cannot use network builder without output layer!");
+    }
+}
+
+} // namespace ml
\ No newline at end of file
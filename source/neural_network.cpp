@@ -1,32 +1,222 @@
 /*******************************************************************************
  * @brief Implementation details of the ml::NeuralNetwork class.
  ******************************************************************************/
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <stdexcept>
+
 #include "neural_network.h"
+#include "output_errors.h"
 #include "utils.h"
 
 namespace ml {
+namespace {
+
+/*******************************************************************************
+ * @brief Identifies checkpoint files ("MLCP") and their format version. Values
+ *        are stored in the byte order of the host.
+ ******************************************************************************/
+constexpr std::uint32_t CheckpointMagic{0x50434C4DU};
+constexpr std::uint32_t CheckpointVersion{1U};
+
+/*******************************************************************************
+ * @brief The number of sets fed through each layer at once during evaluation.
+ ******************************************************************************/
+constexpr std::size_t EvaluationBatchSize{64U};
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void write(std::vector<std::uint8_t> &buffer, const T *values, const std::size_t count) {
+    const auto *bytes{reinterpret_cast<const std::uint8_t *>(values)};
+    buffer.insert(buffer.end(), bytes, bytes + count * sizeof(T));
+}
+
+// -----------------------------------------------------------------------------
+template <typename T> void write(std::vector<std::uint8_t> &buffer, const T value) {
+    write(buffer, &value, 1U);
+}
+
+/*******************************************************************************
+ * @brief Reads values from a serialized checkpoint, throwing if it is truncated.
+ ******************************************************************************/
+class Reader {
+  public:
+    explicit Reader(const std::vector<std::uint8_t> &buffer) noexcept
+        : myBuffer{buffer}, myPosition{} {}
+
+    template <typename T> void read(T *values, const std::size_t count) {
+        if (count > (myBuffer.size() - myPosition) / sizeof(T)) {
+            throw std::invalid_argument("Checkpoint file is truncated!");
+        }
+        std::memcpy(values, myBuffer.data() + myPosition, count * sizeof(T));
+        myPosition += count * sizeof(T);
+    }
+
+    template <typename T> T read() {
+        T value{};
+        read(&value, 1U);
+        return value;
+    }
+
+    template <typename T> std::size_t readCount() {
+        // Check a stored element count before it is used to allocate anything.
+        const auto count{read<std::uint64_t>()};
+        if (count > (myBuffer.size() - myPosition) / sizeof(T)) {
+            throw std::invalid_argument("Checkpoint file is truncated!");
+        }
+        return static_cast<std::size_t>(count);
+    }
+
+    bool isAtEnd() const noexcept { return myPosition == myBuffer.size(); }
+
+  private:
+    const std::vector<std::uint8_t> &myBuffer; // The serialized checkpoint.
+    std::size_t myPosition;                    // Index of the next byte to read.
+};
+
+// -----------------------------------------------------------------------------
+std::size_t parameterCountOf(const std::size_t inputCount,
+                             const std::vector<NeuralNetwork::LayerSpec> &hiddenLayers,
+                             const NeuralNetwork::LayerSpec &outputLayer) noexcept {
+    std::size_t count{};
+    auto weightCount{inputCount};
+    for (const auto &layer : hiddenLayers) {
+        count += DenseLayer::parameterCount(layer.nodeCount, weightCount);
+        weightCount = layer.nodeCount;
+    }
+    return count + DenseLayer::parameterCount(outputLayer.nodeCount, weightCount);
+}
+
+// -----------------------------------------------------------------------------
+std::size_t activationCountOf(const std::vector<NeuralNetwork::LayerSpec> &hiddenLayers,
+                              const NeuralNetwork::LayerSpec &outputLayer) noexcept {
+    std::size_t count{};
+    for (const auto &layer : hiddenLayers) {
+        count += DenseLayer::activationCount(layer.nodeCount);
+    }
+    return count + DenseLayer::activationCount(outputLayer.nodeCount);
+}
+
+} // namespace
 
 // -----------------------------------------------------------------------------
 NeuralNetwork::NeuralNetwork(const std::size_t inputCount, const std::size_t hiddenLayerCount,
                              const std::size_t hiddenNodeCount, const std::size_t outputCount,
                              const ActFunc actFuncHidden, const ActFunc actFuncOutput)
-    : myHiddenLayers{DenseLayer(hiddenNodeCount, inputCount, actFuncHidden)},
-      myOutputLayer{outputCount, hiddenNodeCount, actFuncOutput}, myTrainingInput{},
-      myTrainingOutput{} {
-    for (std::size_t i{1U}; i < hiddenLayerCount; ++i) {
-        myHiddenLayers.push_back(DenseLayer(hiddenNodeCount, hiddenNodeCount, actFuncHidden));
+    : NeuralNetwork{inputCount,
+                    std::vector<LayerSpec>(hiddenLayerCount, LayerSpec{hiddenNodeCount,
+                                                                       actFuncHidden}),
+                    LayerSpec{outputCount, actFuncOutput}} {}
+
+// -----------------------------------------------------------------------------
+NeuralNetwork::NeuralNetwork(const std::size_t inputCount,
+                             const std::vector<LayerSpec> &hiddenLayers,
+                             const LayerSpec &outputLayer, const Loss loss)
+    : myParameters{
+          std::make_shared<Arena>(parameterCountOf(inputCount, hiddenLayers, outputLayer))},
+      myActivations{activationCountOf(hiddenLayers, outputLayer)}, myHiddenLayers{},
+      myOutputLayer{outputLayer.nodeCount,
+                    hiddenLayers.empty() ? inputCount : hiddenLayers.back().nodeCount,
+                    outputLayer.actFunc,
+                    myParameters->data() + myParameters->size() -
+                        DenseLayer::parameterCount(
+                            outputLayer.nodeCount,
+                            hiddenLayers.empty() ? inputCount : hiddenLayers.back().nodeCount),
+                    myActivations.data() + myActivations.size() -
+                        DenseLayer::activationCount(outputLayer.nodeCount)},
+      myPlan{}, myPrediction{}, myTrainingInput{std::make_shared<const DataSets>()},
+      myTrainingOutput{std::make_shared<const DataSets>()}, myReplayBuffer{}, myLoss{loss},
+      myProfiler{nullptr}, myCheckpointWriter{nullptr}, myEpochCount{} {
+    // Throw an exception if the loss function doesn't match the output layer.
+    if (!isLossSupported(loss, outputLayer.actFunc)) {
+        throw std::invalid_argument("Invalid loss function for the output activation function!");
     }
+
+    // Each hidden layer has one weight per node in the previous layer. The layers are placed
+    // one after another in the arenas, ahead of the output layer.
+    myHiddenLayers.reserve(hiddenLayers.size());
+    auto weightCount{inputCount};
+    auto *parameters{myParameters->data()};
+    auto *activations{myActivations.data()};
+    for (const auto &layer : hiddenLayers) {
+        if (layer.actFunc == ActFunc::Softmax) {
+            throw std::invalid_argument("Cannot use softmax in hidden layers!");
+        }
+        myHiddenLayers.emplace_back(layer.nodeCount, weightCount, layer.actFunc, parameters,
+                                    activations);
+        parameters += DenseLayer::parameterCount(layer.nodeCount, weightCount);
+        activations += DenseLayer::activationCount(layer.nodeCount);
+        weightCount = layer.nodeCount;
+    }
+    buildPlan();
 }
 
 // -----------------------------------------------------------------------------
-std::size_t NeuralNetwork::inputCount() const noexcept {
-    // Input count = the weight count of the hidden layers
-    int total = 0;
-    for (const auto &layer : myHiddenLayers) {
-        total += layer.weightCount();
-    }
+NeuralNetwork::NeuralNetwork(const NeuralNetwork &source)
+    : myParameters{source.myParameters}, myActivations{source.myActivations.size()},
+      myHiddenLayers{source.myHiddenLayers}, myOutputLayer{source.myOutputLayer},
+      myPlan{source.myPlan}, myPrediction{}, myTrainingInput{source.myTrainingInput},
+      myTrainingOutput{source.myTrainingOutput},
+      myReplayBuffer{source.myReplayBuffer ? std::make_unique<ReplayBuffer>(*source.myReplayBuffer)
+                                           : nullptr},
+      myLoss{source.myLoss}, myProfiler{nullptr}, myCheckpointWriter{nullptr},
+      myEpochCount{source.myEpochCount} {
+    // The copied layers and plan still point at the source.
+    placeLayers();
+}
+
+// -----------------------------------------------------------------------------
+NeuralNetwork::NeuralNetwork(NeuralNetwork &&other) noexcept
+    : myParameters{std::move(other.myParameters)},
+      myActivations{std::move(other.myActivations)},
+      myHiddenLayers{std::move(other.myHiddenLayers)},
+      myOutputLayer{std::move(other.myOutputLayer)}, myPlan{std::move(other.myPlan)},
+      myPrediction{std::move(other.myPrediction)},
+      myTrainingInput{std::move(other.myTrainingInput)},
+      myTrainingOutput{std::move(other.myTrainingOutput)},
+      myReplayBuffer{std::move(other.myReplayBuffer)}, myLoss{other.myLoss},
+      myProfiler{other.myProfiler}, myCheckpointWriter{other.myCheckpointWriter},
+      myEpochCount{other.myEpochCount} {
+    // The plan still points at the output layer of the other network.
+    resolvePlan();
+}
 
-    return total;
+// -----------------------------------------------------------------------------
+NeuralNetwork &NeuralNetwork::operator=(NeuralNetwork &&other) noexcept {
+    if (this == &other) { return *this; }
+    myParameters = std::move(other.myParameters);
+    myActivations = std::move(other.myActivations);
+    myHiddenLayers = std::move(other.myHiddenLayers);
+    myOutputLayer = std::move(other.myOutputLayer);
+    myPlan = std::move(other.myPlan);
+    myPrediction = std::move(other.myPrediction);
+    myTrainingInput = std::move(other.myTrainingInput);
+    myTrainingOutput = std::move(other.myTrainingOutput);
+    myReplayBuffer = std::move(other.myReplayBuffer);
+    myLoss = other.myLoss;
+    myProfiler = other.myProfiler;
+    myCheckpointWriter = other.myCheckpointWriter;
+    myEpochCount = other.myEpochCount;
+    resolvePlan();
+    return *this;
+}
+
+// -----------------------------------------------------------------------------
+NeuralNetwork NeuralNetwork::clone() const { return NeuralNetwork{*this}; }
+
+// -----------------------------------------------------------------------------
+bool NeuralNetwork::sharesParameters() const noexcept {
+    return myParameters && (myParameters.use_count() > 1);
+}
+
+// -----------------------------------------------------------------------------
+std::size_t NeuralNetwork::inputCount() const noexcept {
+    // Input count = the weight count of the first layer.
+    return myHiddenLayers.empty() ? myOutputLayer.weightCount()
+                                  : myHiddenLayers[0U].weightCount();
 }
 
 // -----------------------------------------------------------------------------
@@ -35,117 +225,595 @@ std::size_t NeuralNetwork::outputCount() const noexcept {
     return myOutputLayer.nodeCount();
 }
 
+// -----------------------------------------------------------------------------
+Loss NeuralNetwork::loss() const noexcept { return myLoss; }
+
 // -----------------------------------------------------------------------------
 std::size_t NeuralNetwork::trainingSetCount() const noexcept {
     // Training set count = the size of the input and output vectors.
-    return myTrainingInput.size();
+    return myTrainingInput->size();
 }
 
+// -----------------------------------------------------------------------------
+std::size_t NeuralNetwork::epochCount() const noexcept { return myEpochCount; }
+
 // -----------------------------------------------------------------------------
 bool NeuralNetwork::train(const std::size_t epochCount, const double learningRate) {
     // If the given parameters are invalid or training sets are missing, return false.
-    if ((epochCount == 0U) || (learningRate <= 0.0) || myTrainingInput.empty()) {
+    if ((epochCount == 0U) || (learningRate <= 0.0) || myTrainingInput->empty()) {
         return false;
     }
+    validateTrainingData();
+    ownParameters();
 
     // Train the network given number of epochs.
     for (std::size_t i{}; i < epochCount; ++i) {
-        // Train the network with each set one by one.
+        // Train the network with each set one by one, the sets were validated above.
         for (std::size_t j{}; j < trainingSetCount(); ++j) {
-            feedforward(myTrainingInput[j]);
+            execute(myPlan.size(), (*myTrainingInput)[j].data(), (*myTrainingOutput)[j].data(),
+                    learningRate);
+        }
+        ++myEpochCount;
 
-            backpropagate(myTrainingOutput[j]);
-            optimize(myTrainingInput[j], learningRate);
+        // Stage a checkpoint if due, the writer takes it from there.
+        if (myCheckpointWriter && myCheckpointWriter->isDue(myEpochCount)) {
+            submitCheckpoint();
         }
     }
+    // Stage a final checkpoint, unless the last epoch already did.
+    if (myCheckpointWriter && (myCheckpointWriter->lastEpoch() != myEpochCount)) {
+        submitCheckpoint();
+    }
     // Indicate that training was performed successfully.
     return true;
 }
 
+// -----------------------------------------------------------------------------
+bool NeuralNetwork::trainPipelined(const std::size_t epochCount, const double learningRate,
+                                   const std::size_t stageCount,
+                                   const std::size_t microBatchCount) {
+    // If the given parameters are invalid or training sets are missing, return false.
+    if ((epochCount == 0U) || (learningRate <= 0.0) || (stageCount == 0U) ||
+        (microBatchCount == 0U) || myTrainingInput->empty()) {
+        return false;
+    }
+    ownParameters();
+
+    // The trainer points the layers at its own activations, point them back when done.
+    {
+        PipelineTrainer trainer{layers(), myLoss, stageCount, microBatchCount};
+        for (std::size_t i{}; i < epochCount; ++i) {
+            trainer.trainEpoch(*myTrainingInput, *myTrainingOutput, learningRate);
+            ++myEpochCount;
+
+            // Stage a checkpoint if due, all stages are idle between epochs.
+            if (myCheckpointWriter && myCheckpointWriter->isDue(myEpochCount)) {
+                submitCheckpoint();
+            }
+        }
+    }
+    placeLayers();
+    if (myCheckpointWriter && (myCheckpointWriter->lastEpoch() != myEpochCount)) {
+        submitCheckpoint();
+    }
+    return true;
+}
+
 // -----------------------------------------------------------------------------
 const std::vector<double> &NeuralNetwork::predict(const std::vector<double> &input) {
-    // Update the outputs of the nodes in all layers.
-    feedforward(input);
+    // Throw an exception on mismatch between the input and the network.
+    if (input.size() != inputCount()) {
+        throw std::invalid_argument("Input does not match the shape of the network!");
+    }
+
+    // Update the outputs of the nodes in all layers, the feedforward steps come first.
+    execute(myHiddenLayers.size() + 1U, input.data(), nullptr, 0.0);
 
     // Return the output of the output layer.
-    return myOutputLayer.output();
+    myPrediction.assign(myOutputLayer.output(), myOutputLayer.output() + outputCount());
+    return myPrediction;
+}
+
+// -----------------------------------------------------------------------------
+InferenceModel NeuralNetwork::freeze() const {
+    // Copies the parameters of a layer, the dense weights are flattened row by row.
+    const auto freezeLayer = [](const DenseLayer &layer) {
+        InferenceModel::Layer frozen{layer.nodeCount(),
+                                     layer.weightCount(),
+                                     layer.actFunc(),
+                                     {layer.bias(), layer.bias() + layer.nodeCount()},
+                                     {},
+                                     {}};
+        if (layer.isSparse()) {
+            frozen.sparseWeights = layer.sparseWeights();
+        } else {
+            frozen.weights.assign(layer.weights(),
+                                  layer.weights() + layer.nodeCount() * layer.weightCount());
+        }
+        return frozen;
+    };
+
+    std::vector<InferenceModel::Layer> layers{};
+    for (const auto &layer : myHiddenLayers) {
+        layers.push_back(freezeLayer(layer));
+    }
+    layers.push_back(freezeLayer(myOutputLayer));
+    return InferenceModel{std::move(layers)};
 }
 
 // -----------------------------------------------------------------------------
 bool NeuralNetwork::addTrainingData(const std::vector<std::vector<double>> &input,
                                     const std::vector<std::vector<double>> &output) {
-    // Assign given data to our member variables.
-    myTrainingInput = input;
-    myTrainingOutput = output;
+    // Copy the given data, clones keep sharing the previous data.
+    auto trainingInput{std::make_shared<DataSets>(input)};
+    auto trainingOutput{std::make_shared<DataSets>(output)};
 
     // If there is a mismatch between the input and output, remove the superfluous value.
     if (input.size() != output.size()) {
         // Reduce the size of the larger vector to match the smaller one.
         const auto setCount{input.size() < output.size() ? input.size() : output.size()};
-        myTrainingInput.resize(setCount);
-        myTrainingOutput.resize(setCount);
+        trainingInput->resize(setCount);
+        trainingOutput->resize(setCount);
     }
+    myTrainingInput = std::move(trainingInput);
+    myTrainingOutput = std::move(trainingOutput);
     // Return true if one or more training sets are stored.
     return trainingSetCount() > 0U;
 }
 
 // -----------------------------------------------------------------------------
-void NeuralNetwork::printResults(std::ostream &printSource) {
-    // Iterate through or training sets one by one and print the predicted value.
-    for (const auto &input : myTrainingInput) {
-        printSource << "Input: ";
-        utils::vector::print(input, printSource, ", ");
-        printSource << "prediction: ";
-        utils::vector::print(predict(input), printSource);
+void NeuralNetwork::setReplayCapacity(const std::size_t capacity) {
+    myReplayBuffer = std::make_unique<ReplayBuffer>(capacity, inputCount(), outputCount());
+}
+
+// -----------------------------------------------------------------------------
+std::size_t NeuralNetwork::replaySampleCount() const noexcept {
+    return myReplayBuffer ? myReplayBuffer->size() : 0U;
+}
+
+// -----------------------------------------------------------------------------
+bool NeuralNetwork::addSample(const std::vector<double> &input,
+                              const std::vector<double> &output) {
+    // Store the sample in replay memory, copying into preallocated storage.
+    return myReplayBuffer && myReplayBuffer->push(input, output);
+}
+
+// -----------------------------------------------------------------------------
+std::size_t NeuralNetwork::learnOnline(const std::size_t stepCount, const double learningRate) {
+    // If replay memory is empty or the learning rate is invalid, do nothing.
+    if ((replaySampleCount() == 0U) || (learningRate <= 0.0)) { return 0U; }
+    ownParameters();
+
+    // Perform one SGD step per randomly drawn sample, so the cost per call is fixed.
+    for (std::size_t i{}; i < stepCount; ++i) {
+        const auto index{utils::random::getNumber<std::size_t>(0U, replaySampleCount() - 1U)};
+        execute(myPlan.size(), myReplayBuffer->input(index).data(),
+                myReplayBuffer->output(index).data(), learningRate);
     }
+    return stepCount;
 }
 
 // -----------------------------------------------------------------------------
-void NeuralNetwork::feedforward(const std::vector<double> &input) {
-    // Perform feedforward for the hidden layers with given input.
+NeuralNetwork::PruneReport NeuralNetwork::prune(const double fraction, const PruneScope scope,
+                                                const std::size_t fineTuneEpochCount,
+                                                const double learningRate) {
+    // Throw an exception if the fraction is invalid.
+    if ((fraction < 0.0) || (fraction >= 1.0)) {
+        throw std::invalid_argument("The pruning fraction must be in the range 0.0 - 1.0!");
+    }
+    ownParameters();
+    PruneReport report{};
+    report.errorBefore = trainingError(report.accuracyBefore);
 
-    std::vector<double> currentInput = input;
-    for (auto &layer : myHiddenLayers) {
-        layer.feedforward(currentInput);
-        currentInput = layer.output();
+    // Provides the magnitude below which the given fraction of weights lies.
+    const auto thresholdOf = [fraction](std::vector<double> &magnitudes) {
+        const auto index{static_cast<std::size_t>(fraction * magnitudes.size())};
+        if (index == 0U) { return 0.0; }
+        std::nth_element(magnitudes.begin(), magnitudes.begin() + index, magnitudes.end());
+        return magnitudes[index];
+    };
+
+    // Collects the weight magnitudes of a layer.
+    const auto addMagnitudes = [](const DenseLayer &layer, std::vector<double> &magnitudes) {
+        const auto *weights{layer.weights()};
+        for (std::size_t i{}; i < layer.nodeCount() * layer.weightCount(); ++i) {
+            magnitudes.push_back(utils::math::absoluteValue(weights[i]));
+        }
+    };
+
+    // Prune each layer, with a threshold shared by all layers or set per layer.
+    std::vector<double> magnitudes{};
+    auto threshold{0.0};
+    if (scope == PruneScope::Global) {
+        for (const auto *layer : layers()) {
+            addMagnitudes(*layer, magnitudes);
+        }
+        threshold = thresholdOf(magnitudes);
     }
 
-    // Perform feedforward for the output layer, use the output of the hidden layer as input.
-    myOutputLayer.feedforward(myHiddenLayers[myHiddenLayers.size() - 1].output());
+    for (auto *layer : layers()) {
+        report.weightCount += layer->nodeCount() * layer->weightCount();
+        report.denseBytes += layer->parameterBytes();
+        if (scope == PruneScope::PerLayer) {
+            magnitudes.clear();
+            addMagnitudes(*layer, magnitudes);
+            threshold = thresholdOf(magnitudes);
+        }
+        layer->prune(threshold);
+    }
+
+    // Fine-tune the remaining weights, pruned weights stay zero.
+    if (fineTuneEpochCount > 0U) { train(fineTuneEpochCount, learningRate); }
+
+    for (const auto *layer : layers()) {
+        report.nonZeroCount += layer->nonZeroCount();
+        report.sparseBytes += layer->parameterBytes();
+    }
+    report.sparsity = 1.0 - utils::math::divide(report.nonZeroCount, report.weightCount);
+    report.errorAfter = trainingError(report.accuracyAfter);
+    return report;
+}
+
+// -----------------------------------------------------------------------------
+void NeuralNetwork::PruneReport::print(std::ostream &ostream) const {
+    ostream << "Sparsity: " << sparsity * 100.0 << " % (" << nonZeroCount << " of " << weightCount
+            << " weights left)\n";
+    ostream << "Parameter memory: " << denseBytes << " -> " << sparseBytes << " bytes\n";
+    ostream << "Mean squared error: " << errorBefore << " -> " << errorAfter << "\n";
+    ostream << "Accuracy: " << accuracyBefore * 100.0 << " % -> " << accuracyAfter * 100.0
+            << " %\n";
+}
+
+// -----------------------------------------------------------------------------
+void NeuralNetwork::Evaluation::print(std::ostream &ostream) const {
+    ostream << "Evaluation over " << sampleCount << " sets:\n";
+    ostream << "Mean squared error: " << meanSquaredError << "\n";
+    ostream << "Max absolute error: " << maxAbsoluteError << " (set " << worstSample << ")\n";
+    ostream << "Accuracy: " << accuracy * 100.0 << " % (threshold " << threshold << ")\n";
+
+    // Print the confusion matrix with one row per reference decision.
+    ostream << "Confusion (reference x predicted):\n";
+    for (std::size_t i{}; i < classCount; ++i) {
+        for (std::size_t j{}; j < classCount; ++j) {
+            ostream << std::setw(8) << confusion[i * classCount + j];
+        }
+        ostream << "\n";
+    }
+}
+
+// -----------------------------------------------------------------------------
+const Arena &NeuralNetwork::parameters() const noexcept { return *myParameters; }
+
+// -----------------------------------------------------------------------------
+void NeuralNetwork::restoreParameters(const Arena &snapshot) {
+    // Throw an exception if the snapshot was taken from another network.
+    if (snapshot.size() != myParameters->size()) {
+        throw std::invalid_argument("Snapshot does not match the shape of the network!");
+    }
+    // Copy all parameters at once, then refresh the sparse weights of pruned layers.
+    ownParameters();
+    *myParameters = snapshot;
+    for (auto *layer : layers()) {
+        layer->reloadSparseWeights();
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t NeuralNetwork::activationBytes() const noexcept { return myActivations.byteCount(); }
+
+// -----------------------------------------------------------------------------
+void NeuralNetwork::setProfiler(KernelProfiler *profiler) {
+    // Throw an exception if the profiler doesn't have a slot for each layer.
+    if (profiler && (profiler->layerCount() != myHiddenLayers.size() + 1U)) {
+        throw std::invalid_argument("Kernel profiler does not match the number of layers!");
+    }
+    myProfiler = profiler;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t NeuralNetwork::tuneKernels(KernelTuner &tuner) { return tuner.tune(layers()); }
+
+// -----------------------------------------------------------------------------
+void NeuralNetwork::setCheckpointWriter(CheckpointWriter *writer) noexcept {
+    myCheckpointWriter = writer;
+}
+
+// -----------------------------------------------------------------------------
+void NeuralNetwork::saveCheckpoint(std::vector<std::uint8_t> &buffer) const {
+    buffer.clear();
+    const auto random{utils::random::state()};
+    write(buffer, CheckpointMagic);
+    write(buffer, CheckpointVersion);
+    write(buffer, static_cast<std::uint64_t>(myEpochCount));
+    write(buffer, static_cast<std::uint64_t>(random.size()));
+    write(buffer, random.data(), random.size());
+    write(buffer, static_cast<std::uint64_t>(myHiddenLayers.size() + 1U));
+
+    // Store each layer by shape, bias and either dense rows or CSR arrays.
+    const auto saveLayer = [&buffer](const DenseLayer &layer) {
+        write(buffer, static_cast<std::uint64_t>(layer.nodeCount()));
+        write(buffer, static_cast<std::uint64_t>(layer.weightCount()));
+        write(buffer, static_cast<std::uint32_t>(layer.actFunc()));
+        write(buffer, static_cast<std::uint8_t>(layer.isSparse()));
+        write(buffer, layer.bias(), layer.nodeCount());
+        if (layer.isSparse()) {
+            const auto &sparse{layer.sparseWeights()};
+            write(buffer, static_cast<std::uint64_t>(sparse.nonZeroCount()));
+            write(buffer, sparse.rowStart().data(), sparse.rowStart().size());
+            write(buffer, sparse.columns().data(), sparse.columns().size());
+            write(buffer, sparse.values().data(), sparse.values().size());
+        } else {
+            write(buffer, layer.weights(), layer.nodeCount() * layer.weightCount());
+        }
+    };
+    for (const auto &layer : myHiddenLayers) {
+        saveLayer(layer);
+    }
+    saveLayer(myOutputLayer);
+}
+
+// -----------------------------------------------------------------------------
+bool NeuralNetwork::restoreCheckpoint(const std::string &path) {
+    std::ifstream file{path, std::ios::binary};
+    if (!file) { return false; }
+    const std::vector<std::uint8_t> buffer{std::istreambuf_iterator<char>{file},
+                                           std::istreambuf_iterator<char>{}};
+    if (file.bad()) { return false; }
+    Reader reader{buffer};
+
+    // Parse the whole checkpoint before changing anything.
+    if ((reader.read<std::uint32_t>() != CheckpointMagic) ||
+        (reader.read<std::uint32_t>() != CheckpointVersion)) {
+        throw std::invalid_argument("Invalid checkpoint file!");
+    }
+    const auto epochCount{reader.read<std::uint64_t>()};
+    std::string random(reader.readCount<char>(), '\0');
+    reader.read(&random[0U], random.size());
+    if (reader.read<std::uint64_t>() != myHiddenLayers.size() + 1U) {
+        throw std::invalid_argument("Checkpoint does not match the shape of the network!");
+    }
+
+    // Parameters of a layer, the weights are either dense or sparse.
+    struct Parameters {
+        std::vector<double> bias;
+        std::vector<double> weights;
+        std::unique_ptr<CsrMatrix> sparseWeights;
+    };
+    const auto readLayer = [&reader](const DenseLayer &layer) {
+        const auto nodeCount{reader.read<std::uint64_t>()};
+        const auto weightCount{reader.read<std::uint64_t>()};
+        const auto actFunc{reader.read<std::uint32_t>()};
+        const auto sparse{reader.read<std::uint8_t>()};
+        if ((nodeCount != layer.nodeCount()) || (weightCount != layer.weightCount()) ||
+            (actFunc != static_cast<std::uint32_t>(layer.actFunc()))) {
+            throw std::invalid_argument("Checkpoint does not match the shape of the network!");
+        }
+        Parameters parameters{std::vector<double>(nodeCount), {}, nullptr};
+        reader.read(parameters.bias.data(), nodeCount);
+        if (sparse) {
+            std::vector<std::uint32_t> rowStart(nodeCount + 1U);
+            std::vector<std::uint32_t> columns(reader.readCount<std::uint32_t>());
+            std::vector<double> values(columns.size());
+            reader.read(rowStart.data(), rowStart.size());
+            reader.read(columns.data(), columns.size());
+            reader.read(values.data(), values.size());
+            parameters.sparseWeights = std::make_unique<CsrMatrix>(
+                weightCount, std::move(rowStart), std::move(columns), std::move(values));
+        } else {
+            parameters.weights.resize(nodeCount * weightCount);
+            reader.read(parameters.weights.data(), parameters.weights.size());
+        }
+        return parameters;
+    };
+    std::vector<Parameters> restored{};
+    for (const auto &layer : myHiddenLayers) {
+        restored.push_back(readLayer(layer));
+    }
+    restored.push_back(readLayer(myOutputLayer));
+    if (!reader.isAtEnd() || !utils::random::setState(random)) {
+        throw std::invalid_argument("Invalid checkpoint file!");
+    }
+
+    // Apply the checkpoint.
+    ownParameters();
+    const auto allLayers{layers()};
+    for (std::size_t i{}; i < allLayers.size(); ++i) {
+        if (restored[i].sparseWeights) {
+            allLayers[i]->setParameters(restored[i].bias, *restored[i].sparseWeights);
+        } else {
+            allLayers[i]->setParameters(restored[i].bias, restored[i].weights);
+        }
+    }
+    myEpochCount = epochCount;
+    return true;
 }
 
 // -----------------------------------------------------------------------------
-void NeuralNetwork::backpropagate(const std::vector<double> &output) {
-    // Index for the last layer.
-    const auto last{static_cast<int>(myHiddenLayers.size() - 1U)};
+NeuralNetwork::Evaluation NeuralNetwork::evaluate(const std::vector<std::vector<double>> &input,
+                                                  const std::vector<std::vector<double>> &output,
+                                                  const double threshold) const {
+    // Throw an exception on mismatch between the data and the network.
+    if (input.size() != output.size()) {
+        throw std::invalid_argument("Evaluation data does not match the shape of the network!");
+    }
+    for (std::size_t i{}; i < input.size(); ++i) {
+        if ((input[i].size() != inputCount()) || (output[i].size() != outputCount())) {
+            throw std::invalid_argument("Evaluation data does not match the shape of the network!");
+        }
+    }
+    OutputErrors errors{outputCount(), threshold};
 
-    // Perform backpropagation for the output layer with given output.
-    myOutputLayer.backpropagate(output);
+    // Feed the sets through one layer at a time in batches, so the weights of each layer are
+    // read once per batch instead of once per set.
+    auto width{inputCount()};
+    for (const auto &layer : myHiddenLayers) { width = std::max(width, layer.nodeCount()); }
+    width = std::max(width, outputCount());
+    std::vector<double> current(EvaluationBatchSize * width), next(EvaluationBatchSize * width);
 
-    // Perform backpropagation for the last hidden layer, use values from the output layer.
-    myHiddenLayers[last].backpropagate(myOutputLayer);
+    for (std::size_t first{}; first < input.size(); first += EvaluationBatchSize) {
+        const auto count{std::min(EvaluationBatchSize, input.size() - first)};
+        for (std::size_t i{}; i < count; ++i) {
+            std::copy(input[first + i].begin(), input[first + i].end(),
+                      current.begin() + i * inputCount());
+        }
+        for (const auto &layer : myHiddenLayers) {
+            layer.feedforward(current.data(), next.data(), count);
+            current.swap(next);
+        }
+        myOutputLayer.feedforward(current.data(), next.data(), count);
 
-    // Perform backpropagation for the hidden layer, use values from the output layer.
+        // Compare the predictions of the batch with their reference values.
+        for (std::size_t i{}; i < count; ++i) {
+            errors.add(output[first + i].data(), next.data() + i * outputCount());
+        }
+    }
+    return Evaluation{errors.sampleCount(), errors.meanSquaredError(), errors.maxAbsoluteError(),
+                      errors.worstSample(), threshold, errors.agreement(),
+                      errors.classCount(), errors.confusion()};
+}
 
-    // Perform backpropagation for the hidden layers, use values from next layer.
-    for (auto i = last - 1; i >= 0; --i) {
-        myHiddenLayers[i].backpropagate(myHiddenLayers[i + 1]);
+// -----------------------------------------------------------------------------
+double NeuralNetwork::trainingError(double &accuracy) {
+    double squaredError{};
+    std::size_t correctCount{}, outputCount{};
+
+    // Compare the prediction of each training set with its reference values.
+    for (std::size_t i{}; i < trainingSetCount(); ++i) {
+        const auto &prediction{predict((*myTrainingInput)[i])};
+        for (std::size_t j{}; j < prediction.size(); ++j) {
+            const auto error{(*myTrainingOutput)[i][j] - prediction[j]};
+            squaredError += error * error;
+            if (utils::math::absoluteValue(error) < 0.5) { ++correctCount; }
+            ++outputCount;
+        }
     }
+    accuracy = utils::math::divide(correctCount, outputCount);
+    return utils::math::divide(squaredError, outputCount);
+}
+
+// -----------------------------------------------------------------------------
+void NeuralNetwork::ownParameters() {
+    // Copy the shared parameters, the other networks keep the original.
+    if (!sharesParameters()) { return; }
+    myParameters = std::make_shared<Arena>(*myParameters);
+    placeLayers();
 }
 
 // -----------------------------------------------------------------------------
-void NeuralNetwork::optimize(const std::vector<double> &input, const double learningRate) {
-    // Optimize the hidden layer with given input.
-    // myHiddenLayers.optimize(input, learningRate);
+void NeuralNetwork::submitCheckpoint() {
+    saveCheckpoint(myCheckpointWriter->stagingBuffer());
+    myCheckpointWriter->submit(myEpochCount);
+}
 
-    std::vector<double> currentInput = input;
+// -----------------------------------------------------------------------------
+void NeuralNetwork::placeLayers() noexcept {
+    auto *parameters{myParameters->data()};
+    auto *activations{myActivations.data()};
     for (auto &layer : myHiddenLayers) {
-        layer.optimize(currentInput, learningRate);
-        currentInput = layer.output();
+        layer.place(parameters, activations);
+        parameters += DenseLayer::parameterCount(layer.nodeCount(), layer.weightCount());
+        activations += DenseLayer::activationCount(layer.nodeCount());
+    }
+    myOutputLayer.place(parameters, activations);
+    resolvePlan();
+}
+
+// -----------------------------------------------------------------------------
+void NeuralNetwork::buildPlan() {
+    // Throw an exception if any layer doesn't take the output of the previous layer.
+    const auto layerCount{myHiddenLayers.size() + 1U};
+    for (std::size_t i{1U}; i < myHiddenLayers.size(); ++i) {
+        if (myHiddenLayers[i].weightCount() != myHiddenLayers[i - 1U].nodeCount()) {
+            throw std::invalid_argument(
+                "The shape of the next layer does not match the current layer!");
+        }
+    }
+    if (!myHiddenLayers.empty() &&
+        (myOutputLayer.weightCount() != myHiddenLayers.back().nodeCount())) {
+        throw std::invalid_argument(
+            "The shape of the next layer does not match the current layer!");
+    }
+
+    // Feed forward from the first layer, propagate the error back from the output layer,
+    // then optimize from the first layer. Predictions only run the feedforward steps.
+    myPlan.clear();
+    myPlan.reserve(3U * layerCount);
+    for (std::size_t i{}; i < layerCount; ++i) {
+        myPlan.push_back({KernelPhase::Feedforward, i, nullptr, nullptr, nullptr});
     }
+    for (auto i{layerCount}; i-- > 0U;) {
+        myPlan.push_back({KernelPhase::Backpropagate, i, nullptr, nullptr, nullptr});
+    }
+    for (std::size_t i{}; i < layerCount; ++i) {
+        myPlan.push_back({KernelPhase::Optimize, i, nullptr, nullptr, nullptr});
+    }
+    resolvePlan();
+}
 
-    // Optimize the output layer with the output of the hidden layer as input.
-    myOutputLayer.optimize(myHiddenLayers[myHiddenLayers.size() - 1].output(), learningRate);
+// -----------------------------------------------------------------------------
+void NeuralNetwork::resolvePlan() noexcept {
+    const auto layerAt{[this](const std::size_t i) -> DenseLayer & {
+        return i < myHiddenLayers.size() ? myHiddenLayers[i] : myOutputLayer;
+    }};
+    for (auto &step : myPlan) {
+        const auto i{step.layerIndex};
+        step.layer = &layerAt(i);
+        step.nextLayer = ((step.kernel == KernelPhase::Backpropagate) &&
+                          (i < myHiddenLayers.size()))
+                             ? &layerAt(i + 1U)
+                             : nullptr;
+        step.input = i > 0U ? layerAt(i - 1U).output() : nullptr;
+    }
+}
+
+// -----------------------------------------------------------------------------
+void NeuralNetwork::execute(const std::size_t stepCount, const double *input,
+                            const double *reference, const double learningRate) noexcept {
+    for (std::size_t i{}; i < stepCount; ++i) {
+        const auto &step{myPlan[i]};
+        const auto *stepInput{step.input ? step.input : input};
+        KernelProfiler::Scope scope{myProfiler, step.layerIndex, step.kernel};
+        switch (step.kernel) {
+        case KernelPhase::Feedforward:
+            step.layer->feedforward(stepInput);
+            break;
+        case KernelPhase::Backpropagate:
+            if (step.nextLayer) {
+                step.layer->backpropagate(*step.nextLayer);
+            } else {
+                step.layer->backpropagate(reference, myLoss);
+            }
+            break;
+        case KernelPhase::Optimize:
+            step.layer->optimize(stepInput, learningRate);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void NeuralNetwork::validateTrainingData() const {
+    if (myTrainingInput->size() != myTrainingOutput->size()) {
+        throw std::invalid_argument("Training data does not match the shape of the network!");
+    }
+    for (std::size_t i{}; i < myTrainingInput->size(); ++i) {
+        if (((*myTrainingInput)[i].size() != inputCount()) ||
+            ((*myTrainingOutput)[i].size() != outputCount())) {
+            throw std::invalid_argument("Training data does not match the shape of the network!");
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::vector<DenseLayer *> NeuralNetwork::layers() {
+    std::vector<DenseLayer *> layers{};
+    for (auto &layer : myHiddenLayers) {
+        layers.push_back(&layer);
+    }
+    layers.push_back(&myOutputLayer);
+    return layers;
 }
 
 } // namespace ml
\ No newline at end of file
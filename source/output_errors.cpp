@@ -0,0 +1,97 @@
+/*******************************************************************************
+ * @brief Implementation details of the ml::OutputErrors class.
+ ******************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "output_errors.h"
+#include "utils.h"
+
+namespace ml {
+
+// -----------------------------------------------------------------------------
+OutputErrors::OutputErrors(const std::size_t outputCount, const double threshold)
+    : myOutputCount{outputCount}, myThreshold{threshold}, mySampleCount{},
+      myMaxAbsoluteError{}, myWorstSample{}, myAbsoluteSum{}, mySquaredSum{}, myAgreeCount{},
+      myConfusion{} {
+    if (outputCount == 0U) {
+        throw std::invalid_argument("Cannot compare outputs without outputs!");
+    }
+    myConfusion.resize(classCount() * classCount());
+}
+
+// -----------------------------------------------------------------------------
+void OutputErrors::add(const double *reference, const double *prediction) noexcept {
+    for (std::size_t i{}; i < myOutputCount; ++i) {
+        const auto error{std::abs(reference[i] - prediction[i])};
+        if (error > myMaxAbsoluteError) {
+            myMaxAbsoluteError = error;
+            myWorstSample = mySampleCount;
+        }
+        myAbsoluteSum += error;
+        mySquaredSum += error * error;
+    }
+    const auto expected{decisionOf(reference)};
+    const auto predicted{decisionOf(prediction)};
+    ++myConfusion[expected * classCount() + predicted];
+    if (expected == predicted) { ++myAgreeCount; }
+    ++mySampleCount;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t OutputErrors::decisionOf(const double *output) const noexcept {
+    if (myOutputCount == 1U) { return output[0U] >= myThreshold ? 1U : 0U; }
+    return static_cast<std::size_t>(std::max_element(output, output + myOutputCount) - output);
+}
+
+// -----------------------------------------------------------------------------
+std::size_t OutputErrors::sampleCount() const noexcept { return mySampleCount; }
+
+// -----------------------------------------------------------------------------
+double OutputErrors::maxAbsoluteError() const noexcept { return myMaxAbsoluteError; }
+
+// -----------------------------------------------------------------------------
+std::size_t OutputErrors::worstSample() const noexcept { return myWorstSample; }
+
+// -----------------------------------------------------------------------------
+double OutputErrors::meanAbsoluteError() const noexcept {
+    return utils::math::divide(myAbsoluteSum, mySampleCount * myOutputCount);
+}
+
+// -----------------------------------------------------------------------------
+double OutputErrors::meanSquaredError() const noexcept {
+    return utils::math::divide(mySquaredSum, mySampleCount * myOutputCount);
+}
+
+// -----------------------------------------------------------------------------
+double OutputErrors::rmsError() const noexcept { return std::sqrt(meanSquaredError()); }
+
+// -----------------------------------------------------------------------------
+double OutputErrors::agreement() const noexcept {
+    return utils::math::divide(myAgreeCount, mySampleCount);
+}
+
+// -----------------------------------------------------------------------------
+std::size_t OutputErrors::classCount() const noexcept {
+    return myOutputCount > 1U ? myOutputCount : 2U;
+}
+
+// -----------------------------------------------------------------------------
+const std::vector<std::size_t> &OutputErrors::confusion() const noexcept { return myConfusion; }
+
+// -----------------------------------------------------------------------------
+void OutputErrors::print(std::ostream &ostream) const {
+    // Print the errors in scientific notation, they are usually far below 0.1.
+    const auto flags{ostream.flags()};
+    const auto precision{ostream.precision(3)};
+    ostream << std::scientific;
+    ostream << "Max absolute error: " << maxAbsoluteError() << "\n";
+    ostream << "Mean absolute error: " << meanAbsoluteError() << "\n";
+    ostream << "RMS error: " << rmsError() << "\n";
+    ostream.flags(flags);
+    ostream.precision(precision);
+    ostream << "Decision agreement: " << agreement() * 100.0 << " %\n";
+}
+
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,70 @@
+/********************************************************************************
+ * @brief Implementation details of the output line group.
+ ********************************************************************************/
+#include <algorithm>
+#include <stdexcept>
+
+#include "output_group.h"
+
+namespace rpi {
+
+// -----------------------------------------------------------------------------
+OutputGroup::OutputGroup(const std::initializer_list<std::uint8_t> pins,
+                         gpio::Backend &backend)
+    : myBackend{backend}, myPins{}, myStaged{}, myWritten{}, mySize{pins.size()},
+      myWriteCount{} {
+    // Throw an exception if the group is empty or too large.
+    if ((mySize == 0U) || (mySize > gpio::LineCount)) {
+        throw std::invalid_argument("Invalid number of lines in output group!");
+    }
+
+    // Request the lines together and drive them low, so the cached state matches the hardware.
+    std::copy(pins.begin(), pins.end(), myPins.begin());
+    myBackend.requestOutputs(myPins.data(), mySize);
+    myBackend.writeBulk(myPins.data(), myWritten.data(), mySize);
+}
+
+// -----------------------------------------------------------------------------
+OutputGroup::~OutputGroup() noexcept {
+    for (std::size_t i{}; i < mySize; ++i) {
+        myBackend.releaseLine(myPins[i]);
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t OutputGroup::size() const noexcept { return mySize; }
+
+// -----------------------------------------------------------------------------
+std::uint8_t OutputGroup::pin(const std::size_t index) const noexcept {
+    return index < mySize ? myPins[index] : 0U;
+}
+
+// -----------------------------------------------------------------------------
+bool OutputGroup::value(const std::size_t index) const noexcept {
+    return (index < mySize) && myStaged[index];
+}
+
+// -----------------------------------------------------------------------------
+void OutputGroup::set(const std::size_t index, const bool value) noexcept {
+    if (index < mySize) { myStaged[index] = value; }
+}
+
+// -----------------------------------------------------------------------------
+bool OutputGroup::commit() noexcept {
+    // Skip the hardware entirely if no value changed since the last commit.
+    if (std::equal(myStaged.begin(), myStaged.begin() + mySize, myWritten.begin())) {
+        return false;
+    }
+
+    // Write the whole group at once, lines requested together can only be set together.
+    // Keep the cached state on failure, so the next commit retries.
+    if (!myBackend.writeBulk(myPins.data(), myStaged.data(), mySize)) { return false; }
+    myWritten = myStaged;
+    ++myWriteCount;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t OutputGroup::writeCount() const noexcept { return myWriteCount; }
+
+} // namespace rpi
\ No newline at end of file
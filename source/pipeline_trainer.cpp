@@ -0,0 +1,261 @@
+/*******************************************************************************
+ * @brief Implementation details of the ml::PipelineTrainer class.
+ ******************************************************************************/
+#include <algorithm>
+#include <stdexcept>
+
+#include "pipeline_trainer.h"
+
+namespace ml {
+
+// -----------------------------------------------------------------------------
+PipelineTrainer::PipelineTrainer(const std::vector<DenseLayer *> &layers, const Loss loss,
+                                 const std::size_t stageCount, const std::size_t microBatchCount)
+    : myLayers{layers}, myLoss{loss}, myMicroBatchCount{microBatchCount}, myStageStart{},
+      myActivationOffset{}, myGradientOffset{}, myBoundaryOffset{}, mySlotSize{},
+      myBoundarySize{}, myActivations{}, myBoundaries{}, myGradients{}, myForward{},
+      myBackward{}, myInput{nullptr}, myOutput{nullptr}, myLearningRate{}, myEpoch{},
+      myDoneCount{}, myStop{false}, myMutex{}, myCondition{}, myThreads{} {
+    // Throw an exception if any parameter is invalid.
+    if (layers.empty()) {
+        throw std::invalid_argument("Cannot create pipeline trainer without layers!");
+    }
+    if (stageCount == 0U) {
+        throw std::invalid_argument("Cannot create pipeline trainer without stages!");
+    }
+    if (microBatchCount == 0U) {
+        throw std::invalid_argument("Cannot create pipeline trainer without micro-batches!");
+    }
+
+    // The layer kernels don't check their arguments, validate the layers once up front.
+    for (std::size_t i{1U}; i < layers.size(); ++i) {
+        if (layers[i]->weightCount() != layers[i - 1U]->nodeCount()) {
+            throw std::invalid_argument(
+                "The shape of the next layer does not match the current layer!");
+        }
+    }
+    if (!isLossSupported(loss, layers.back()->actFunc())) {
+        throw std::invalid_argument("Invalid loss function for the output activation function!");
+    }
+
+    // Plan the activations of one micro-batch and the gradients, layer by layer.
+    std::size_t gradientSize{};
+    std::vector<std::size_t> weightsBefore{0U};
+    for (const auto *layer : layers) {
+        myActivationOffset.push_back(mySlotSize);
+        myGradientOffset.push_back(gradientSize);
+        mySlotSize += DenseLayer::activationCount(layer->nodeCount());
+        gradientSize += DenseLayer::parameterCount(layer->nodeCount(), layer->weightCount());
+        weightsBefore.push_back(weightsBefore.back() +
+                                layer->nodeCount() * layer->weightCount());
+    }
+
+    // Split the layers into stages of about the same number of weights, each stage starting at
+    // the first layer reaching its share, while leaving at least one layer per later stage.
+    const auto count{std::min(stageCount, layers.size())};
+    myStageStart.push_back(0U);
+    for (std::size_t stage{1U}; stage < count; ++stage) {
+        const auto share{weightsBefore.back() * stage / count};
+        auto layer{myStageStart.back() + 1U};
+        while ((layer < layers.size() - (count - stage)) && (weightsBefore[layer] < share)) {
+            ++layer;
+        }
+        myStageStart.push_back(layer);
+    }
+    myStageStart.push_back(layers.size());
+
+    // Each stage after the first hands back the error at the input of its first layer.
+    for (std::size_t stage{}; stage < count; ++stage) {
+        myBoundaryOffset.push_back(myBoundarySize);
+        if (stage > 0U) {
+            myBoundarySize += Arena::alignedCount(layers[myStageStart[stage]]->weightCount());
+        }
+    }
+    myActivations = Arena{mySlotSize * microBatchCount};
+    myBoundaries = Arena{myBoundarySize * microBatchCount};
+    myGradients = Arena{gradientSize};
+
+    // Queues hold at most one batch, so a stage never waits to hand a micro-batch on.
+    for (std::size_t stage{1U}; stage < count; ++stage) {
+        myForward.push_back(std::make_unique<Queue>(microBatchCount));
+        myBackward.push_back(std::make_unique<Queue>(microBatchCount));
+    }
+    try {
+        for (std::size_t stage{1U}; stage < count; ++stage) {
+            myThreads.emplace_back(&PipelineTrainer::run, this, stage);
+        }
+    } catch (...) {
+        stop();
+        throw;
+    }
+}
+
+// -----------------------------------------------------------------------------
+PipelineTrainer::~PipelineTrainer() noexcept { stop(); }
+
+// -----------------------------------------------------------------------------
+std::size_t PipelineTrainer::stageCount() const noexcept { return myStageStart.size() - 1U; }
+
+// -----------------------------------------------------------------------------
+std::size_t PipelineTrainer::firstLayer(const std::size_t stage) const {
+    if (stage >= stageCount()) { throw std::out_of_range("Invalid pipeline stage!"); }
+    return myStageStart[stage];
+}
+
+// -----------------------------------------------------------------------------
+void PipelineTrainer::trainEpoch(const std::vector<std::vector<double>> &input,
+                                 const std::vector<std::vector<double>> &output,
+                                 const double learningRate) {
+    // Throw an exception on invalid parameters, before any stage starts.
+    if (learningRate <= 0.0) {
+        throw std::invalid_argument("The learning rate must exceed 0!");
+    }
+    if (input.size() != output.size()) {
+        throw std::invalid_argument("Training data does not match the shape of the network!");
+    }
+    for (std::size_t i{}; i < input.size(); ++i) {
+        if ((input[i].size() != myLayers.front()->weightCount()) ||
+            (output[i].size() != myLayers.back()->nodeCount())) {
+            throw std::invalid_argument("Training data does not match the shape of the network!");
+        }
+    }
+
+    // Start the epoch on all stage threads and run the first stage on this thread.
+    {
+        std::lock_guard<std::mutex> lock{myMutex};
+        myInput = &input;
+        myOutput = &output;
+        myLearningRate = learningRate;
+        myDoneCount = 0U;
+        ++myEpoch;
+    }
+    myCondition.notify_all();
+    runEpoch(0U);
+
+    std::unique_lock<std::mutex> lock{myMutex};
+    myCondition.wait(lock, [this]() { return myDoneCount == myThreads.size(); });
+}
+
+// -----------------------------------------------------------------------------
+void PipelineTrainer::run(const std::size_t stage) {
+    std::size_t epoch{};
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock{myMutex};
+            myCondition.wait(lock, [this, epoch]() { return myStop || (myEpoch != epoch); });
+            if (myStop) { return; }
+            epoch = myEpoch;
+        }
+        runEpoch(stage);
+        {
+            std::lock_guard<std::mutex> lock{myMutex};
+            ++myDoneCount;
+        }
+        myCondition.notify_all();
+    }
+}
+
+// -----------------------------------------------------------------------------
+void PipelineTrainer::runEpoch(const std::size_t stage) noexcept {
+    const auto first{myStageStart[stage]};
+    const auto last{myStageStart[stage + 1U]};
+    const auto isLast{last == myLayers.size()};
+    const auto setCount{myInput->size()};
+
+    for (std::size_t batch{}; batch < setCount; batch += myMicroBatchCount) {
+        const auto count{std::min(myMicroBatchCount, setCount - batch)};
+
+        // Feed each micro-batch forward, the last stage propagates its error back right away.
+        for (std::size_t i{}; i < count; ++i) {
+            const auto slot{stage == 0U ? i : myForward[stage - 1U]->pop()};
+            for (auto layer{first}; layer < last; ++layer) {
+                myLayers[layer]->placeActivations(activationsOf(layer, slot));
+                myLayers[layer]->feedforward(inputOf(layer, slot, batch + slot));
+            }
+            if (isLast) {
+                backward(stage, slot, batch + slot);
+            } else {
+                myForward[stage]->push(slot);
+            }
+        }
+
+        // Propagate the errors back in the order the next stage hands them back.
+        if (!isLast) {
+            for (std::size_t i{}; i < count; ++i) {
+                const auto slot{myBackward[stage]->pop()};
+                backward(stage, slot, batch + slot);
+            }
+        }
+
+        // Apply the summed updates of the batch and clear them for the next batch.
+        for (auto layer{first}; layer < last; ++layer) {
+            auto *gradient{myGradients.data() + myGradientOffset[layer]};
+            myLayers[layer]->applyGradient(gradient);
+            std::fill(gradient,
+                      gradient + DenseLayer::parameterCount(myLayers[layer]->nodeCount(),
+                                                            myLayers[layer]->weightCount()),
+                      0.0);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void PipelineTrainer::backward(const std::size_t stage, const std::size_t slot,
+                               const std::size_t set) noexcept {
+    const auto first{myStageStart[stage]};
+    const auto last{myStageStart[stage + 1U]};
+
+    // Propagate the error back layer by layer. The last layer of the stage takes the error
+    // handed back by the next stage, the weights of the next stage are never read.
+    for (auto layer{last}; layer-- > first;) {
+        auto &current{*myLayers[layer]};
+        current.placeActivations(activationsOf(layer, slot));
+        if (layer + 1U == myLayers.size()) {
+            current.backpropagate((*myOutput)[set].data(), myLoss);
+        } else if (layer + 1U == last) {
+            current.backpropagateError(boundaryOf(stage + 1U, slot));
+        } else {
+            current.backpropagate(*myLayers[layer + 1U]);
+        }
+        current.accumulateGradient(inputOf(layer, slot, set), myLearningRate,
+                                   myGradients.data() + myGradientOffset[layer]);
+    }
+
+    // Hand the error at the input of the stage back to the previous stage.
+    if (stage > 0U) {
+        myLayers[first]->propagateError(boundaryOf(stage, slot));
+        myBackward[stage - 1U]->push(slot);
+    }
+}
+
+// -----------------------------------------------------------------------------
+const double *PipelineTrainer::inputOf(const std::size_t layer, const std::size_t slot,
+                                       const std::size_t set) const noexcept {
+    // The output of a layer is stored first in its activations.
+    if (layer == 0U) { return (*myInput)[set].data(); }
+    return myActivations.data() + slot * mySlotSize + myActivationOffset[layer - 1U];
+}
+
+// -----------------------------------------------------------------------------
+double *PipelineTrainer::activationsOf(const std::size_t layer, const std::size_t slot) noexcept {
+    return myActivations.data() + slot * mySlotSize + myActivationOffset[layer];
+}
+
+// -----------------------------------------------------------------------------
+double *PipelineTrainer::boundaryOf(const std::size_t stage, const std::size_t slot) noexcept {
+    return myBoundaries.data() + slot * myBoundarySize + myBoundaryOffset[stage];
+}
+
+// -----------------------------------------------------------------------------
+void PipelineTrainer::stop() noexcept {
+    {
+        std::lock_guard<std::mutex> lock{myMutex};
+        myStop = true;
+    }
+    myCondition.notify_all();
+    for (auto &thread : myThreads) {
+        if (thread.joinable()) { thread.join(); }
+    }
+}
+
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * @brief Implementation details of the ml::ReplayBuffer class.
+ ******************************************************************************/
+#include <algorithm>
+#include <stdexcept>
+
+#include "replay_buffer.h"
+
+namespace ml {
+
+// -----------------------------------------------------------------------------
+ReplayBuffer::ReplayBuffer(const std::size_t capacity, const std::size_t inputSize,
+                           const std::size_t outputSize)
+    : myInputs(capacity, std::vector<double>(inputSize, 0.0)),
+      myOutputs(capacity, std::vector<double>(outputSize, 0.0)), myNext{}, mySize{} {
+    // Throw an exception if any parameter is invalid.
+    if (capacity == 0U) {
+        throw std::invalid_argument("Cannot create replay buffer without capacity!");
+    }
+    if ((inputSize == 0U) || (outputSize == 0U)) {
+        throw std::invalid_argument("Cannot create replay buffer for empty samples!");
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t ReplayBuffer::capacity() const noexcept { return myInputs.size(); }
+
+// -----------------------------------------------------------------------------
+std::size_t ReplayBuffer::size() const noexcept { return mySize; }
+
+// -----------------------------------------------------------------------------
+bool ReplayBuffer::push(const std::vector<double> &input, const std::vector<double> &output) {
+    // Refuse samples that don't match the shape of the buffer.
+    if ((input.size() != myInputs[0U].size()) || (output.size() != myOutputs[0U].size())) {
+        return false;
+    }
+
+    // Copy the sample into the next slot, overwriting the oldest sample when full.
+    std::copy(input.begin(), input.end(), myInputs[myNext].begin());
+    std::copy(output.begin(), output.end(), myOutputs[myNext].begin());
+    myNext = (myNext + 1U) % capacity();
+    if (mySize < capacity()) { ++mySize; }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+const std::vector<double> &ReplayBuffer::input(const std::size_t index) const {
+    return myInputs[slot(index)];
+}
+
+// -----------------------------------------------------------------------------
+const std::vector<double> &ReplayBuffer::output(const std::size_t index) const {
+    return myOutputs[slot(index)];
+}
+
+// -----------------------------------------------------------------------------
+void ReplayBuffer::clear() noexcept {
+    myNext = 0U;
+    mySize = 0U;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t ReplayBuffer::slot(const std::size_t index) const {
+    if (index >= mySize) {
+        throw std::out_of_range("Replay buffer index out of range!");
+    }
+    // The oldest sample is located at the write position once the buffer has wrapped.
+    const auto oldest{mySize < capacity() ? 0U : myNext};
+    return (oldest + index) % capacity();
+}
+
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,186 @@
+/*******************************************************************************
+ * @brief Implementation details of the ctrl::RtRunner class.
+ ******************************************************************************/
+#include <alloca.h>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <malloc.h>
+#include <stdexcept>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "rt_runner.h"
+
+namespace ctrl {
+namespace {
+
+constexpr std::uint64_t NsPerSecond{1000000000U}; // Nanoseconds per second.
+
+// -----------------------------------------------------------------------------
+std::uint64_t toNs(const timespec &time) noexcept {
+    return static_cast<std::uint64_t>(time.tv_sec) * NsPerSecond +
+           static_cast<std::uint64_t>(time.tv_nsec);
+}
+
+// -----------------------------------------------------------------------------
+timespec toTimespec(const std::uint64_t ns) noexcept {
+    timespec time{};
+    time.tv_sec = static_cast<time_t>(ns / NsPerSecond);
+    time.tv_nsec = static_cast<long>(ns % NsPerSecond);
+    return time;
+}
+
+// -----------------------------------------------------------------------------
+std::uint64_t monotonicNs() noexcept {
+    timespec time{};
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return toNs(time);
+}
+
+// -----------------------------------------------------------------------------
+std::string errorText(const char *setting) {
+    return std::string{setting} + ": " + std::strerror(errno);
+}
+
+// -----------------------------------------------------------------------------
+void prefaultStack(const std::size_t byteCount) noexcept {
+    // Touch each page of a stack allocation so later cycles don't fault.
+    auto *stack{static_cast<volatile unsigned char *>(alloca(byteCount))};
+    const auto pageSize{static_cast<std::size_t>(sysconf(_SC_PAGESIZE))};
+    for (std::size_t i{}; i < byteCount; i += pageSize) {
+        stack[i] = 0U;
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool prefaultHeap(const std::size_t byteCount) noexcept {
+    // Keep freed memory in the heap instead of returning it to the kernel.
+    if (!mallopt(M_TRIM_THRESHOLD, -1) || !mallopt(M_MMAP_MAX, 0)) { return false; }
+
+    // Touch each page of a heap allocation, then release it for later reuse.
+    auto *heap{static_cast<unsigned char *>(malloc(byteCount))};
+    if (!heap) { return false; }
+    const auto pageSize{static_cast<std::size_t>(sysconf(_SC_PAGESIZE))};
+    for (std::size_t i{}; i < byteCount; i += pageSize) {
+        heap[i] = 0U;
+    }
+    free(heap);
+    return true;
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+RtRunner::RtRunner(const Config &config)
+    : myConfig{config}, mySetupErrors{}, myStopRequested{false}, myOverrunCount{}, myJitter{},
+      myCycleTime{} {
+    if (config.period.count() <= 0) {
+        throw std::invalid_argument("The cycle period must exceed 0!");
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool RtRunner::prepare() {
+    mySetupErrors.clear();
+
+    // Pin the calling thread to the given CPU.
+    if (myConfig.cpu >= 0) {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(myConfig.cpu, &cpuSet);
+        const auto result{pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet)};
+        if (result != 0) {
+            errno = result;
+            mySetupErrors.push_back(errorText("CPU affinity"));
+        }
+    }
+
+    // Lock memory before prefaulting so the touched pages stay resident.
+    if (myConfig.lockMemory && (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)) {
+        mySetupErrors.push_back(errorText("mlockall"));
+    }
+    if (myConfig.prefaultStackBytes > 0U) { prefaultStack(myConfig.prefaultStackBytes); }
+    if ((myConfig.prefaultHeapBytes > 0U) && !prefaultHeap(myConfig.prefaultHeapBytes)) {
+        mySetupErrors.push_back("Heap prefault: allocation failed");
+    }
+
+    // Switch to real-time scheduling last, once all slow setup is done.
+    if (myConfig.priority > 0) {
+        sched_param param{};
+        param.sched_priority = myConfig.priority;
+        const auto result{pthread_setschedparam(pthread_self(), SCHED_FIFO, &param)};
+        if (result != 0) {
+            errno = result;
+            mySetupErrors.push_back(errorText("SCHED_FIFO priority"));
+        }
+    }
+    return mySetupErrors.empty();
+}
+
+// -----------------------------------------------------------------------------
+const std::vector<std::string> &RtRunner::setupErrors() const noexcept { return mySetupErrors; }
+
+// -----------------------------------------------------------------------------
+std::size_t RtRunner::run(const std::function<bool()> &cycle, const std::size_t cycleCount) {
+    const auto period{static_cast<std::uint64_t>(myConfig.period.count())};
+    auto deadline{monotonicNs()};
+    std::size_t count{};
+    myStopRequested = false;
+
+    while (!myStopRequested.load(std::memory_order_relaxed) &&
+           ((cycleCount == 0U) || (count < cycleCount))) {
+        // Sleep until the next absolute deadline, resume if interrupted by a signal.
+        deadline += period;
+        const auto wakeTime{toTimespec(deadline)};
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeTime, nullptr) == EINTR) {}
+
+        const auto start{monotonicNs()};
+        myJitter.record(start > deadline ? start - deadline : 0U);
+        const auto proceed{cycle()};
+        const auto end{monotonicNs()};
+        myCycleTime.record(end - start);
+        ++count;
+
+        // Skip the deadlines missed by an overrun instead of running them back to back.
+        if (end > deadline + period) {
+            myOverrunCount.fetch_add(1U, std::memory_order_relaxed);
+            deadline += (end - deadline) / period * period;
+        }
+        if (!proceed) { break; }
+    }
+    return count;
+}
+
+// -----------------------------------------------------------------------------
+void RtRunner::stop() noexcept { myStopRequested = true; }
+
+// -----------------------------------------------------------------------------
+std::size_t RtRunner::overrunCount() const noexcept { return myOverrunCount; }
+
+// -----------------------------------------------------------------------------
+const LatencyHistogram &RtRunner::jitter() const noexcept { return myJitter; }
+
+// -----------------------------------------------------------------------------
+const LatencyHistogram &RtRunner::cycleTime() const noexcept { return myCycleTime; }
+
+// -----------------------------------------------------------------------------
+void RtRunner::print(std::ostream &ostream) const {
+    const auto jitter{myJitter.summary()};
+    const auto cycleTime{myCycleTime.summary()};
+    ostream << "Period: " << myConfig.period.count() / 1000.0 << " us, priority: "
+            << myConfig.priority << ", CPU: " << myConfig.cpu << "\n";
+    ostream << "Cycles: " << cycleTime.count << ", overruns: " << overrunCount() << "\n";
+    ostream << "Jitter [us]:     p50 " << jitter.p50 / 1000.0 << ", p99 " << jitter.p99 / 1000.0
+            << ", p999 " << jitter.p999 / 1000.0 << ", max " << jitter.max / 1000.0 << "\n";
+    ostream << "Cycle time [us]: p50 " << cycleTime.p50 / 1000.0 << ", p99 "
+            << cycleTime.p99 / 1000.0 << ", p999 " << cycleTime.p999 / 1000.0 << ", max "
+            << cycleTime.max / 1000.0 << "\n";
+    for (const auto &error : mySetupErrors) {
+        ostream << "Not applied: " << error << "\n";
+    }
+}
+
+} // namespace ctrl
\ No newline at end of file
@@ -0,0 +1,175 @@
+/********************************************************************************
+ * @brief Implementation details of the simulated GPIO chip.
+ ********************************************************************************/
+#include <chrono>
+
+#include "sim_chip.h"
+
+namespace rpi {
+namespace gpio {
+namespace {
+
+// -----------------------------------------------------------------------------
+std::uint64_t timestampNs() noexcept {
+    const auto now{std::chrono::steady_clock::now().time_since_epoch()};
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+SimChip::SimChip(const std::size_t writeCapacity, const std::uint32_t seed)
+    : myMutex{}, myLines{}, myWrites{}, myWriteCapacity{writeCapacity}, myDroppedWriteCount{},
+      myReadCount{}, myGenerator{seed} {
+    // Reserve the whole record up front to keep allocations out of the measured loop.
+    myWrites.reserve(writeCapacity);
+}
+
+// -----------------------------------------------------------------------------
+void SimChip::setInput(const std::uint8_t pin, const bool value) noexcept {
+    if (pin >= LineCount) { return; }
+    std::lock_guard<std::mutex> lock{myMutex};
+    auto &line{myLines[pin]};
+    line.value = value;
+    line.script.clear();
+    line.toggleProbability = 0.0;
+}
+
+// -----------------------------------------------------------------------------
+void SimChip::script(const std::uint8_t pin, const std::vector<bool> &sequence,
+                     const bool repeat) {
+    if (pin >= LineCount) { return; }
+    std::lock_guard<std::mutex> lock{myMutex};
+    auto &line{myLines[pin]};
+    line.script = sequence;
+    line.scriptIndex = 0U;
+    line.repeat = repeat;
+    line.toggleProbability = 0.0;
+}
+
+// -----------------------------------------------------------------------------
+void SimChip::randomize(const std::uint8_t pin, const double toggleProbability) noexcept {
+    if (pin >= LineCount) { return; }
+    std::lock_guard<std::mutex> lock{myMutex};
+    auto &line{myLines[pin]};
+    line.script.clear();
+    line.toggleProbability = toggleProbability;
+}
+
+// -----------------------------------------------------------------------------
+std::vector<SimChip::Write> SimChip::writes() const {
+    std::lock_guard<std::mutex> lock{myMutex};
+    return myWrites;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t SimChip::droppedWriteCount() const noexcept {
+    std::lock_guard<std::mutex> lock{myMutex};
+    return myDroppedWriteCount;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t SimChip::readCount() const noexcept {
+    std::lock_guard<std::mutex> lock{myMutex};
+    return myReadCount;
+}
+
+// -----------------------------------------------------------------------------
+void SimChip::clearRecord() noexcept {
+    std::lock_guard<std::mutex> lock{myMutex};
+    myWrites.clear();
+    myDroppedWriteCount = 0U;
+    myReadCount = 0U;
+}
+
+// -----------------------------------------------------------------------------
+bool SimChip::requestLine(const std::uint8_t pin, const Direction direction) noexcept {
+    if (pin >= LineCount) { return false; }
+    std::lock_guard<std::mutex> lock{myMutex};
+    auto &line{myLines[pin]};
+    if (line.requested) { return false; }
+    line.requested = true;
+    line.direction = direction;
+    if (direction == Direction::Out) { line.value = false; }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+void SimChip::releaseLine(const std::uint8_t pin) noexcept {
+    if (pin >= LineCount) { return; }
+    std::lock_guard<std::mutex> lock{myMutex};
+    myLines[pin].requested = false;
+}
+
+// -----------------------------------------------------------------------------
+bool SimChip::read(const std::uint8_t pin) noexcept {
+    if (pin >= LineCount) { return false; }
+    std::lock_guard<std::mutex> lock{myMutex};
+    auto &line{myLines[pin]};
+
+    // Output lines read back the last written value.
+    if (!line.requested || (line.direction == Direction::Out)) { return line.value; }
+    ++myReadCount;
+
+    // Advance the scripted sequence, hold the last value if it shouldn't repeat.
+    if (!line.script.empty()) {
+        if (line.scriptIndex >= line.script.size()) {
+            if (!line.repeat) { return line.value; }
+            line.scriptIndex = 0U;
+        }
+        line.value = line.script[line.scriptIndex++];
+    } else if (line.toggleProbability > 0.0) {
+        std::bernoulli_distribution toggle{line.toggleProbability};
+        if (toggle(myGenerator)) { line.value = !line.value; }
+    }
+    return line.value;
+}
+
+// -----------------------------------------------------------------------------
+void SimChip::write(const std::uint8_t pin, const bool value) noexcept {
+    const auto timestamp{timestampNs()};
+    if (pin >= LineCount) { return; }
+    std::lock_guard<std::mutex> lock{myMutex};
+    auto &line{myLines[pin]};
+    if (!line.requested || (line.direction != Direction::Out)) { return; }
+    line.value = value;
+
+    // Record the write if there is room left, else count it as dropped.
+    if (myWrites.size() < myWriteCapacity) {
+        myWrites.push_back({timestamp, pin, value});
+    } else {
+        ++myDroppedWriteCount;
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool SimChip::writeBulk(const std::uint8_t *pins, const bool *values,
+                        const std::size_t count) noexcept {
+    // Apply all values under one lock and with one timestamp, like a single ioctl.
+    const auto timestamp{timestampNs()};
+    std::lock_guard<std::mutex> lock{myMutex};
+    bool isWritten{true};
+
+    for (std::size_t i{}; i < count; ++i) {
+        if (pins[i] >= LineCount) {
+            isWritten = false;
+            continue;
+        }
+        auto &line{myLines[pins[i]]};
+        if (!line.requested || (line.direction != Direction::Out)) {
+            isWritten = false;
+            continue;
+        }
+        line.value = values[i];
+
+        if (myWrites.size() < myWriteCapacity) {
+            myWrites.push_back({timestamp, pins[i], values[i]});
+        } else {
+            ++myDroppedWriteCount;
+        }
+    }
+    return isWritten;
+}
+
+} // namespace gpio
+} // namespace rpi
\ No newline at end of file